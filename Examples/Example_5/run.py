@@ -10,6 +10,9 @@ oreex.print_headline("Run ORE to produce NPV cube and exposures, without collate
 oreex.run("Input/ore.xml")
 oreex.get_times("Output/log.txt")
 
+oreex.print_headline("Run ORE incrementally on the base run's cube, resimulating trade ShortSwap only")
+oreex.run("Input/ore_incremental.xml")
+
 oreex.print_headline("Plot results")
 
 oreex.setup_plot("plot_callable_swap")
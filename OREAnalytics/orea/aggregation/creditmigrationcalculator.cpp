@@ -78,11 +78,14 @@ void CreditMigrationCalculator::build() {
     cdf_.clear();
     pdf_.clear();
 
+    std::vector<Array> dists = hlp.pnlDistributions(creditMigrationTimeSteps_, creditSimulationParameters_->threads(),
+                                                    creditSimulationParameters_->pathBlockSize());
+
     for (Size i = 0; i < creditMigrationTimeSteps_.size(); ++i) {
         DLOG("Generating pnl distribution for timestep " << creditMigrationTimeSteps_[i]);
         cdf_.push_back({});
         pdf_.push_back({});
-        Array dist = hlp.pnlDistribution(creditMigrationTimeSteps_[i]);
+        const Array& dist = dists[i];
         Real mean = 0.0, stdev = 0.0;
         Real sum = 0.0;
         for (Size j = 1; j < hlp.upperBucketBound().size() - 1; ++j) {
@@ -32,6 +32,9 @@
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <exception>
+#include <thread>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
@@ -56,8 +59,6 @@ CreditMigrationHelper::CreditMigrationHelper(const boost::shared_ptr<CreditSimul
 
     rescaledTransitionMatrices_.resize(cube_->numDates());
     init();
-    if (evaluation_ == Evaluation::TerminalSimulation)
-        initEntityStateSimulation();
 } // CreditMigrationHelper()
 
 namespace {
@@ -197,25 +198,14 @@ void CreditMigrationHelper::init() {
 
 } // init
 
-void CreditMigrationHelper::initEntityStateSimulation() {
-
-    LOG("Init entity state simulation");
-
-    simulatedEntityState_ =
-        std::vector<std::vector<Size>>(parameters_->entities().size(), std::vector<Size>(cube_->samples()));
-
-    LOG("Init entity state simulation done.");
-
-} // initEntityStatesSimulation
-
-std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path) {
+std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path,
+                                                                     const std::map<string, Matrix>& transMat) const {
     std::vector<Matrix> res = std::vector<Matrix>(parameters_->entities().size(), Matrix(n_, n_, 0.0));
 
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
 
     // build terminal matrices conditional on global states
     Size numWarnings = 0;
-    auto transMat = rescaledTransitionMatrices(date);
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         const Matrix& m = transMat.at(matrixNames[i]);
         for (Size ii = 0; ii < m.rows(); ++ii) {
@@ -253,12 +243,13 @@ std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size
     return res;
 }
 
-void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, const Size path,
-                                                 const MersenneTwisterUniformRng& mt) {
+void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond, MersenneTwisterUniformRng& mt,
+                                                 std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(evaluation_ != Evaluation::Analytic,
                "CreditMigrationHelper::simulateEntityStates() unexpected call, not in simulation mode");
 
+    entityStates.resize(parameters_->entities().size());
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         Size initialState = parameters_->initialStates()[i];
             Real tmp = mt.next().value;
@@ -266,19 +257,14 @@ void CreditMigrationHelper::simulateEntityStates(const std::vector<Matrix>& cond
                 std::lower_bound(cond[i].row_begin(initialState), cond[i].row_end(initialState), tmp) -
                 cond[i].row_begin(initialState);
             entityState = std::min(entityState, cond[i].columns() - 1); // play safe
-            simulatedEntityState_[i][path] = entityState;
+            entityStates[i] = entityState;
             initialState = entityState;
     }
 
 } // simulateEntityStates
 
-Size CreditMigrationHelper::simulatedEntityState(const Size i, const Size path) const {
-    QL_REQUIRE(evaluation_ != Evaluation::Analytic,
-               "CreditMigrationHelper::simulatedEntityState() unexpected call, not in simulation mode");
-    return simulatedEntityState_[i][path];
-} // simulatedEntityState
-
-Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n) const {
+Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size path, const Size n,
+                                                 const std::vector<Size>& entityStates) const {
 
     QL_REQUIRE(!parameters_->doubleDefault(),
                "CreditMigrationHelper::generateMigrationPnl() does not support double default");
@@ -289,31 +275,29 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
     for (Size i = 0; i < entities.size(); ++i) {
         // compute credit state of entitiy
         // issuer migration risk
-        Size simEntityState = simulatedEntityState(i, path);
-        for (auto const& tradeId : issuerTradeIds_[i]) {
+        Size simEntityState = entityStates[i];
+        for (auto const& trade : issuerTrades_[i]) {
             try {
-                Size tid = cube_->idsAndIndexes().at(tradeId);
-                Real baseValue = cube_->get(tid, date, path, 0);
-                Real stateValue = cube_->get(tid, date, path, cubeIndexStateNpvs_ + simEntityState);
+                Real baseValue = cube_->get(trade.cubeIndex, date, path, 0);
+                Real stateValue = cube_->get(trade.cubeIndex, date, path, cubeIndexStateNpvs_ + simEntityState);
                 if (loanExposureMode_ == LoanExposureMode::Notional) {
-                    if (tradeNotionals_.find(tradeId) != tradeNotionals_.end()) {
+                    if (trade.isBond) {
                         // this is a bond
-                        string tradeCcy = tradeCurrencies_.at(tradeId);
-                        string ccypair = tradeCcy + baseCurrency_;
+                        string ccypair = trade.currency + baseCurrency_;
                         Real fx = 1.0;
-                        if (tradeCcy != baseCurrency_) {
+                        if (trade.currency != baseCurrency_) {
                             QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, ccypair),
                                        "FX spot data not found in aggregation data for currency pair " << ccypair);
                             fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, ccypair);
                         }
                         // FIXME: We actually need the correct current notional as of the future horizon date,
                         // but we have the current notional as of today
-                        baseValue = tradeNotionals_.at(tradeId) * fx;
+                        baseValue = trade.notional * fx;
                         // FIXME: get the bond's recovery rate
                         Real rr = 0.0;
                         stateValue = simEntityState == n - 1 ? rr * baseValue : baseValue;
                     }
-                    if (tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                    if (trade.isCds) {
                         // this is a cds
                         baseValue = 0.0;
                         if (simEntityState < n - 1)
@@ -327,15 +311,13 @@ Real CreditMigrationHelper::generateMigrationPnl(const Size date, const Size pat
                 }
                 pnl += stateValue - baseValue;
             } catch (const std::exception& e) {
-                ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what() << "), state "
+                ALOG("can not get state npv for trade " << trade.id << " (reason:" << e.what() << "), state "
                                                         << simEntityState << ", assume zero credit migration pnl");
             }
         }
         // default risk for derivative exposure
         // TODO, assuming a zero recovery here...
-        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
-            Size nid = nettedCube_->idsAndIndexes().at(nettingSetId);
-            QL_REQUIRE(nettedCube_, "empty netted cube");
+        for (auto const nid : cptyNettingSetIndices_[i]) {
             if (simEntityState == n - 1)
                 pnl -= std::max(nettedCube_->get(nid, date, path), 0.0);
         }
@@ -366,31 +348,29 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
         }
         // issuer migration risk
         Size cdsCptyIdx = Null<Size>();
-        for (auto const& tradeId : issuerTradeIds_[i]) {
+        for (auto const& trade : issuerTrades_[i]) {
             for (Size j = 0; j < n_; ++j) {
                 try {
-                    Size tid = cube_->idsAndIndexes().at(tradeId);
-                    Real baseValue = cube_->get(tid, date, path, 0);
-                    Real stateValue = cube_->get(tid, date, path, cubeIndexStateNpvs_ + j);
+                    Real baseValue = cube_->get(trade.cubeIndex, date, path, 0);
+                    Real stateValue = cube_->get(trade.cubeIndex, date, path, cubeIndexStateNpvs_ + j);
                     if (loanExposureMode_ == LoanExposureMode::Notional) {
-                        if (tradeNotionals_.find(tradeId) != tradeNotionals_.end()) {
+                        if (trade.isBond) {
                             // this is a bond
-                            string tradeCcy = tradeCurrencies_.at(tradeId);
-                            string ccypair = tradeCcy + baseCurrency_;
+                            string ccypair = trade.currency + baseCurrency_;
                             Real fx = 1.0;
-                            if (tradeCcy != baseCurrency_) {
+                            if (trade.currency != baseCurrency_) {
                                 QL_REQUIRE(aggData_->has(AggregationScenarioDataType::FXSpot, ccypair),
                                            "FX spot data not found in aggregation data for currency pair " << ccypair);
                                 fx = aggData_->get(date, path, AggregationScenarioDataType::FXSpot, ccypair);
                             }
                             // FIXME: We actually need the correct current notional as of the future horizon date,
                             // but we have the current notional as of today
-                            baseValue = tradeNotionals_.at(tradeId) * fx;
+                            baseValue = trade.notional * fx;
                             // FIXME: get the bond's recovery rate
                             Real rr = 0.0;
                             stateValue = j == n_ - 1 ? rr * baseValue : baseValue;
                         }
-                        if (tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                        if (trade.isCds) {
                             // this is a cds
                             baseValue = 0.0;
                             if (j < n_ - 1)
@@ -407,179 +387,255 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
                     if (j == n_ - 1)
                         pnl[i][n_] += stateValue - baseValue;
                     // for a CDS we have to subdivide the default migration event into two events (see above)
-                    if (parameters_->doubleDefault() && j == n_ - 1 &&
-                        tradeCdsCptyIdx_.find(tradeId) != tradeCdsCptyIdx_.end()) {
+                    if (parameters_->doubleDefault() && j == n_ - 1 && trade.cdsCptyIdx != Null<Size>()) {
                         // FIXME currently we can not handle two CDS cptys for same underlying issuer
-                        QL_REQUIRE(cdsCptyIdx == Null<Size>() || cdsCptyIdx == tradeCdsCptyIdx_.at(tradeId),
+                        QL_REQUIRE(cdsCptyIdx == Null<Size>() || cdsCptyIdx == trade.cdsCptyIdx,
                                    "CreditMigrationHelper: Two different CDS cptys found for same issuer "
                                        << entities[i]);
                         // only adjust probability once
                         if (cdsCptyIdx == Null<Size>()) {
-                            Real cptyDefaultPd =
-                                transMat.at(matrixNames[tradeCdsCptyIdx_.at(tradeId)])[initialState][n_ - 1];
+                            Real cptyDefaultPd = transMat.at(matrixNames[trade.cdsCptyIdx])[initialState][n_ - 1];
                             Real pd = prob_tauA_lt_tauB_lt_T(cptyDefaultPd, condProbs[i][n_ - 1], t);
                             QL_REQUIRE(pd <= condProbs[i][n_ - 1],
                                        "CreditMigrationHelper: unexpected probability for double default event "
                                            << pd << " > " << condProbs[i][n_ - 1]);
                             condProbs[i][n_ - 1] -= pd;
                             condProbs[i][n_] = pd;
-                            cdsCptyIdx = tradeCdsCptyIdx_.at(tradeId);
+                            cdsCptyIdx = trade.cdsCptyIdx;
                             // pnl for new state is zero
                             pnl[i][n_] -= stateValue - baseValue;
                         }
                     }
                 } catch (const std::exception& e) {
-                    ALOG("can not get state npv for trade " << tradeId << " (reason:" << e.what() << "), state " << j
-                                                            << ", assume zero credit migration pnl");
+                    ALOG("can not get state npv for trade " << trade.id << " (reason:" << e.what() << "), state "
+                                                            << j << ", assume zero credit migration pnl");
                 }
             }
         }
         // default risk for derivative exposure
         // TODO, assuming a zero recovery here...
-        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
-            auto nid = nettedCube_->idsAndIndexes().at(nettingSetId);
-            QL_REQUIRE(nettedCube_, "empty netted cube");
+        for (auto const nid : cptyNettingSetIndices_[i]) {
             pnl[i][n_ - 1] -= std::max(nettedCube_->get(nid, date, path), 0.0);
         }
     }
 } // generateConditionalMigrationPnl
 
-Array CreditMigrationHelper::pnlDistribution(const Size date) {
-
-    // FIXME if we ask this method for more than one time step, it might be more efficient to
-    // pass a vector of those time steps and compute the distirbutions in one sweep here
-    // in particular step 2b-1 (in forward simulation mode)
+void CreditMigrationHelper::pnlDistributionsBlock(const std::vector<Size>& dates,
+                                                  const std::vector<std::map<string, Matrix>>& transMat,
+                                                  const Size pathStart, const Size pathEnd, const Size numPaths,
+                                                  const Size seed, std::vector<Array>& res,
+                                                  std::vector<Real>& avgCash) const {
 
-    LOG("Compute PnL distribution for date " << date);
-    QL_REQUIRE(date < cube_->numDates(), "date index " << date << " out of range 0..." << cube_->numDates() - 1);
     const std::vector<string>& entities = parameters_->entities();
 
-    // 1 get transition matrices for entities and rescale them to horizon
+    res = std::vector<Array>(dates.size(), Array(bucketing_.buckets(), 0.0));
+    avgCash = std::vector<Real>(dates.size(), 0.0);
 
-    std::map<string, Matrix> transMat; // rescaled transition matrix per (matrix) name
+    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
 
-    // 1 get transition matrices for time step and compute variance of global factors for each entiity
+    // one rng per date, so that the result for a date does not depend on the other dates
+    std::vector<MersenneTwisterUniformRng> mt(dates.size(), MersenneTwisterUniformRng(seed));
+    std::vector<Size> entityStates;
+
+    // get cumulative survival probability on the path
+    auto survivalWeight = [this](const Size t, const Size d, const Size path) {
+        // FIXME 1
+        // Methodology question: Do we need/want to multiply with the stochastic discount factor
+        // here if we do an explicit credit default simulation at horizon?
+        // FIXME 2
+        // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
+        // with default prob
+        if (parameters_->zeroMarketPnl() && tradeCubeHasCreditCurve_[t])
+            return aggData_->get(d, path, AggregationScenarioDataType::SurvivalWeight, tradeCubeCreditCurves_[t]);
+        return 1.0;
+    };
 
-    if (parameters_->creditRisk()) {
-        transMat = rescaledTransitionMatrices(date);
-    }
+    for (Size path = pathStart; path < pathEnd; ++path) {
 
-    // 2 compute conditional pnl distributions and average over paths
+        // initial cash balance and intermediate cashflows up to cube date index j - 1, this is accumulated
+        // over the (sorted) dates, so that each cube date is visited once per path
+        Real flows = 0.0;
+        Size j = 0;
 
-    const std::set<std::string>& tradeIds = cube_->ids();
-    Array res(bucketing_.buckets(), 0.0);
+        for (Size k = 0; k < dates.size(); ++k) {
 
-    Size numPaths = cube_->samples();
-    Real avgCash = 0.0;
+            Size date = dates[k];
 
-    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
+            // 2a market pnl (t0 to horizon date, over whole cube)
 
-    MersenneTwisterUniformRng mt(parameters_->seed());
-
-    for (Size path = 0; path < numPaths; ++path) {
-
-        // 2a market pnl (t0 to horizon date, over whole cube)
-
-        Real cash = 0.0;
-
-        if (parameters_->marketRisk()) {
-            for (Size j = 0; j <= date + 1; ++j) {
-                for (auto const& tradeId : tradeIds) {
-                    Size i = cube_->idsAndIndexes().at(tradeId);
-                    // get cumulative survival probability on the path
-                    Real sp = 1.0;
-                    //Real rr = 0.0;
-                    // FIXME 1
-                    // Methodology question: Do we need/want to multiply with the stochastic discount factor
-                    // here if we do an explicit credit default simulation at horizon?
-                    // FIXME 2
-                    // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
-                    // with default prob
-                    if (parameters_->zeroMarketPnl() && j > 0 &&
-                        tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
-                        string creditCurve = tradeCreditCurves_.at(tradeId);
-                        sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
-                        //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
-                    }
-                    if (j == 0) {
-                        // at t0 we flip the sign of the npvs to get the initial cash balance
-                        cash -= cube_->getT0(i, 0);
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += cube_->getT0(i, cubeIndexCashflows_);
-                    } else if (j <= date) {
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
-                    } else {
-                        // at the horizon date we realise the npv
-                        cash += sp * cube_->get(i, j - 1, path, 0);
+            Real cash = 0.0;
+
+            if (parameters_->marketRisk()) {
+                for (; j <= date; ++j) {
+                    for (Size t = 0; t < tradeCubeIndices_.size(); ++t) {
+                        Size i = tradeCubeIndices_[t];
+                        if (j == 0) {
+                            // at t0 we flip the sign of the npvs to get the initial cash balance
+                            flows -= cube_->getT0(i, 0);
+                            // collect intermediate cashflows
+                            if (cubeIndexCashflows_ != Null<Size>())
+                                flows += cube_->getT0(i, cubeIndexCashflows_);
+                        } else if (cubeIndexCashflows_ != Null<Size>()) {
+                            // collect intermediate cashflows
+                            flows += survivalWeight(t, j - 1, path) * cube_->get(i, j - 1, path, cubeIndexCashflows_);
+                        }
                     }
                 }
-            } // for data
-        }     // if market risk
-
-        if (!parameters_->creditRisk()) {
-            // if we just add scalar market pnl realisations, we don't really need
-            // the bucketing algorithm to do that, we just update the result
-            // distribution directly
-            res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
-            continue;
-        }
+                cash = flows;
+                for (Size t = 0; t < tradeCubeIndices_.size(); ++t) {
+                    // at the horizon date we realise the npv
+                    cash += survivalWeight(t, date, path) * cube_->get(tradeCubeIndices_[t], date, path, 0);
+                }
+            } // if market risk
+
+            if (!parameters_->creditRisk()) {
+                // if we just add scalar market pnl realisations, we don't really need
+                // the bucketing algorithm to do that, we just update the result
+                // distribution directly
+                res[k][hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
+                continue;
+            }
 
-        // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
-
-        std::vector<Array> condProbs, pnl;
-
-        if (evaluation_ != Evaluation::Analytic) {
-            // 2b-1 generate pnl on the path using simulated idiosyncratic factors
-            condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
-            // we could build the distribution more efficiently here, but later in 2c we add the market pnl
-            // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
-            // these with additional data?
-            pnl.resize(1, Array(parameters_->paths(), 0.0));
-            auto cond = initEntityStateSimulation(date, path);
-            for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
-                simulateEntityStates(cond, path, mt);
-                pnl[0][path2] = generateMigrationPnl(date, path, n_);
+            // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
+
+            std::vector<Array> condProbs, pnl;
+
+            if (evaluation_ != Evaluation::Analytic) {
+                // 2b-1 generate pnl on the path using simulated idiosyncratic factors
+                condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
+                // we could build the distribution more efficiently here, but later in 2c we add the market pnl
+                // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
+                // these with additional data?
+                pnl.resize(1, Array(parameters_->paths(), 0.0));
+                auto cond = initEntityStateSimulation(date, path, transMat[k]);
+                for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
+                    simulateEntityStates(cond, mt[k], entityStates);
+                    pnl[0][path2] = generateMigrationPnl(date, path, n_, entityStates);
+                }
+            } else {
+                // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
+                // independence of migration on the path / systemic factors
+
+                // n+1 states, since for CDS we have to subdivide the issuer default into
+                // i) default of issuer and non-default of CDS cpty
+                // ii) default of issuer, default of CDS cpty (but after the issuer default)
+                // iii) default of issuer, default of CDS cpty (before the issuer default)
+                // for non-CDS trades for all sub-states the pnl will be set to the same value
+                // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
+                // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
+                // additional state
+
+                condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
+                pnl.resize(entities.size(), Array(n_ + 1, 0.0));
+                generateConditionalMigrationPnl(date, path, transMat[k], condProbs, pnl);
             }
-        } else {
-            // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
-            // independence of migration on the path / systemic factors
-
-            // n+1 states, since for CDS we have to subdivide the issuer default into
-            // i) default of issuer and non-default of CDS cpty
-            // ii) default of issuer, default of CDS cpty (but after the issuer default)
-            // iii) default of issuer, default of CDS cpty (before the issuer default)
-            // for non-CDS trades for all sub-states the pnl will be set to the same value
-            // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
-            // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
-            // additional state
-
-            condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
-            pnl.resize(entities.size(), Array(n_ + 1, 0.0));
-            generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
-        }
 
-        // 2c aggregate market pnl and credit migration pnl
+            // 2c aggregate market pnl and credit migration pnl
+
+            if (parameters_->marketRisk()) {
+                condProbs.push_back(Array(1, 1.0));
+                pnl.push_back(Array(1, cash));
+            }
+
+            hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+
+            // 2d add pnl contribution of path to result distribution
+            res[k] += hwBucketing.probability() / static_cast<Real>(numPaths);
+            // average market risk pnl
+            avgCash[k] += cash / static_cast<Real>(numPaths);
+
+        } // for dates
+    }     // for path
+} // pnlDistributionsBlock
+
+Array CreditMigrationHelper::pnlDistribution(const Size date) { return pnlDistributions({date}).front(); }
+
+std::vector<Array> CreditMigrationHelper::pnlDistributions(const std::vector<Size>& dates, const Size nThreads,
+                                                           const Size pathBlockSize) {
 
-        if (parameters_->marketRisk()) {
-            condProbs.push_back(Array(1, 1.0));
-            pnl.push_back(Array(1, cash));
+    LOG("Compute PnL distributions for " << dates.size() << " dates");
+    for (auto const d : dates) {
+        QL_REQUIRE(d < cube_->numDates(), "date index " << d << " out of range 0..." << cube_->numDates() - 1);
+    }
+
+    std::vector<Size> sortedDates(dates);
+    std::sort(sortedDates.begin(), sortedDates.end());
+    sortedDates.erase(std::unique(sortedDates.begin(), sortedDates.end()), sortedDates.end());
+
+    // 1 get transition matrices for entities and rescale them to horizon, this is done upfront, since the cache
+    //   for the rescaled matrices is not thread safe
+
+    std::vector<std::map<string, Matrix>> transMat(sortedDates.size()); // rescaled transition matrix per (matrix) name
+
+    if (parameters_->creditRisk()) {
+        for (Size k = 0; k < sortedDates.size(); ++k)
+            transMat[k] = rescaledTransitionMatrices(sortedDates[k]);
+    }
+
+    // 2 compute conditional pnl distributions and average over paths, in blocks of paths, without a given block
+    //   size all paths form one block, so that the block layout (and the result) never depends on the threads
+
+    Size numPaths = cube_->samples();
+    Size blockSize = std::max<Size>(pathBlockSize > 0 ? pathBlockSize : numPaths, 1);
+    Size numBlocks = (numPaths + blockSize - 1) / blockSize;
+    Size threads = std::min(std::max<Size>(nThreads, 1), numBlocks);
+    if (nThreads > 1 && pathBlockSize == 0) {
+        LOG("No path block size given, the paths are processed in a single block on one thread");
+    }
+
+    std::vector<std::vector<Array>> blockRes(numBlocks);
+    std::vector<std::vector<Real>> blockAvgCash(numBlocks);
+    std::vector<std::exception_ptr> errors(threads);
+
+    auto runBlocks = [this, &sortedDates, &transMat, &blockRes, &blockAvgCash, &errors, threads, numBlocks, blockSize,
+                      numPaths](const Size t) {
+        try {
+            for (Size b = t; b < numBlocks; b += threads) {
+                pnlDistributionsBlock(sortedDates, transMat, b * blockSize, std::min((b + 1) * blockSize, numPaths),
+                                      numPaths, parameters_->seed() + b, blockRes[b], blockAvgCash[b]);
+            }
+        } catch (...) {
+            errors[t] = std::current_exception();
         }
+    };
 
-        hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+    if (threads <= 1) {
+        for (Size t = 0; t < threads; ++t)
+            runBlocks(t);
+    } else {
+        DLOG("Process " << numBlocks << " blocks of " << blockSize << " paths on " << threads << " threads");
+        std::vector<std::thread> jobs;
+        for (Size t = 0; t < threads; ++t)
+            jobs.emplace_back(runBlocks, t);
+        for (auto& j : jobs)
+            j.join();
+    }
 
-        // 2d add pnl contribution of path to result distribution
-        res += hwBucketing.probability() / static_cast<Real>(numPaths);
-        // average market risk pnl
-        avgCash += cash / static_cast<Real>(numPaths);
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
 
-    } // for path
+    // 3 merge the block results in block order
 
-    DLOG("Expected Market Risk PnL at date " << date << ": " << avgCash);
-    return res;
-} // pnlDistribution
+    std::vector<Array> res(sortedDates.size(), Array(bucketing_.buckets(), 0.0));
+    std::vector<Real> avgCash(sortedDates.size(), 0.0);
+    for (Size b = 0; b < numBlocks; ++b) {
+        for (Size k = 0; k < sortedDates.size(); ++k) {
+            res[k] += blockRes[b][k];
+            avgCash[k] += blockAvgCash[b][k];
+        }
+    }
+
+    std::vector<Array> result;
+    for (auto const d : dates) {
+        Size k = std::lower_bound(sortedDates.begin(), sortedDates.end(), d) - sortedDates.begin();
+        DLOG("Expected Market Risk PnL at date " << d << ": " << avgCash[k]);
+        result.push_back(res[k]);
+    }
+
+    return result;
+} // pnlDistributions
 
 void CreditMigrationHelper::build(const std::map<std::string, boost::shared_ptr<Trade>>& trades) {
     LOG("CreditMigrationHelper: Build trade ID map");
@@ -624,6 +680,49 @@ void CreditMigrationHelper::build(const std::map<std::string, boost::shared_ptr<
     }
     LOG("CreditMigrationHelper: Built issuer and cpty trade ID sets for " << parameters_->entities().size()
                                                                           << " entities.");
+
+    // precompute the cube indices and trade data, so that we do not need to look them up per path
+
+    issuerTrades_.clear();
+    issuerTrades_.resize(parameters_->entities().size());
+    cptyNettingSetIndices_.clear();
+    cptyNettingSetIndices_.resize(parameters_->entities().size());
+    for (Size i = 0; i < parameters_->entities().size(); ++i) {
+        for (auto const& tradeId : issuerTradeIds_[i]) {
+            auto c = cube_->idsAndIndexes().find(tradeId);
+            if (c == cube_->idsAndIndexes().end()) {
+                ALOG("can not get state npvs for trade " << tradeId
+                                                         << " (not found in cube), assume zero credit migration pnl");
+                continue;
+            }
+            IssuerTrade trade;
+            trade.id = tradeId;
+            trade.cubeIndex = c->second;
+            auto n = tradeNotionals_.find(tradeId);
+            trade.isBond = n != tradeNotionals_.end();
+            trade.notional = trade.isBond ? n->second : Null<Real>();
+            trade.currency = trade.isBond ? tradeCurrencies_.at(tradeId) : std::string();
+            auto cds = tradeCdsCptyIdx_.find(tradeId);
+            trade.isCds = cds != tradeCdsCptyIdx_.end();
+            trade.cdsCptyIdx = trade.isCds ? cds->second : Null<Size>();
+            issuerTrades_[i].push_back(trade);
+        }
+        for (auto const& nettingSetId : cptyNettingSetIds_[i]) {
+            QL_REQUIRE(nettedCube_, "empty netted cube");
+            cptyNettingSetIndices_[i].push_back(nettedCube_->idsAndIndexes().at(nettingSetId));
+        }
+    }
+
+    tradeCubeIndices_.clear();
+    tradeCubeCreditCurves_.clear();
+    tradeCubeHasCreditCurve_.clear();
+    for (auto const& tradeId : cube_->ids()) {
+        tradeCubeIndices_.push_back(cube_->idsAndIndexes().at(tradeId));
+        auto c = tradeCreditCurves_.find(tradeId);
+        tradeCubeHasCreditCurve_.push_back(c != tradeCreditCurves_.end());
+        tradeCubeCreditCurves_.push_back(c != tradeCreditCurves_.end() ? c->second : std::string());
+    }
+
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         DLOG("Entity " << parameters_->entities()[i] << ": " << issuerTradeIds_[i].size()
                        << " trades with issuer risk, " << cptyNettingSetIds_[i].size()
@@ -65,8 +65,15 @@ public:
     void build(const std::map<std::string, boost::shared_ptr<Trade>>& trades);
 
     const std::vector<Real>& upperBucketBound() const { return bucketing_.upperBucketBound(); }
-    //
+    //! pnl distribution for a single date, equivalent to pnlDistributions({date})
     Array pnlDistribution(const Size date);
+    /*! pnl distributions for several dates, computed in one sweep over the cube paths. The paths are split into
+        blocks of size pathBlockSize (if 0, all paths form a single block) which are processed on nThreads threads,
+        the block results are merged in block order. In simulation mode block b uses a Mersenne Twister RNG seeded
+        with seed + b for each date, so the result for a date does not depend on the other dates nor on the number
+        of threads, and for a single block it coincides with the sequential computation. */
+    std::vector<Array> pnlDistributions(const std::vector<Size>& dates, const Size nThreads = 1,
+                                        const Size pathBlockSize = 0);
 
 private:
     /*! Get the transition matrix from today to date by entity,
@@ -81,25 +88,28 @@ private:
         using the simulated global state paths stored in the aggregation scenario data object */
     void init();
 
-    //! Allocate 3d storage for the simulated idiosyncratic factors by entity, date and sample
-    void initEntityStateSimulation();
-
     /*! Initialise the entity state simulationn for a given date for
         Evaluation = TerminalSimulation:
         Return transition matrix for each entity for the given date,
         conditional on the global terminal state on the given path */
-    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path);
-
-    /*! Generate one entity state sample path for all entities given the global state path
-        and given the conditional transition matrices for all entities at the terminal date. */
-    void simulateEntityStates(const std::vector<Matrix>& cond, const Size path, const MersenneTwisterUniformRng& mt);
+    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path,
+                                                  const std::map<string, Matrix>& transMat) const;
 
-    //! Look up the simulated entity credit state for the given entity, date and path
-    Size simulatedEntityState(const Size i, const Size path) const;
+    /*! Generate one entity state sample for all entities given the conditional transition matrices
+        for all entities at the terminal date, the result is written to entityStates */
+    void simulateEntityStates(const std::vector<Matrix>& cond, MersenneTwisterUniformRng& mt,
+                              std::vector<Size>& entityStates) const;
 
     /*! Return a single PnL impact due to credit migration or default of Bond/CDS issuers and default of
       netting set counterparties on the given global path */
-    Real generateMigrationPnl(const Size date, const Size path, const Size n) const;
+    Real generateMigrationPnl(const Size date, const Size path, const Size n,
+                              const std::vector<Size>& entityStates) const;
+
+    /*! Compute the contributions of the paths [pathStart, pathEnd) to the pnl distributions and the average market
+        pnl for the given dates (sorted, unique), using one RNG per date seeded with seed */
+    void pnlDistributionsBlock(const std::vector<Size>& dates, const std::vector<std::map<string, Matrix>>& transMat,
+                               const Size pathStart, const Size pathEnd, const Size numPaths, const Size seed,
+                               std::vector<Array>& res, std::vector<Real>& avgCash) const;
 
     /*! Return a vector of PnL impacts and associated conditional probabilities for the specified global path,
       due to credit migration or default of Bond/CDS issuers and default of netting set counterparties */
@@ -128,15 +138,28 @@ private:
     std::map<std::string, std::string> tradeCurrencies_;
     std::map<std::string, Size> tradeCdsCptyIdx_;
 
+    // trade data by entity precomputed in build(), in the order of issuerTradeIds_
+    struct IssuerTrade {
+        std::string id;
+        Size cubeIndex;
+        bool isBond, isCds;
+        Real notional;
+        std::string currency;
+        Size cdsCptyIdx;
+    };
+    std::vector<std::vector<IssuerTrade>> issuerTrades_;
+    // netted cube indices by entity, in the order of cptyNettingSetIds_
+    std::vector<std::vector<Size>> cptyNettingSetIndices_;
+    // cube indices and credit curves of cube_->ids(), precomputed in build()
+    std::vector<Size> tradeCubeIndices_;
+    std::vector<std::string> tradeCubeCreditCurves_;
+    std::vector<bool> tradeCubeHasCreditCurve_;
+
     // Transition matrix rows
     Size n_;
     std::vector<std::map<string, Matrix>> rescaledTransitionMatrices_;
     // Variance of the systemic part (Y_i) of entity state X_i
     std::vector<Real> globalVar_;
-    // Storage for the simulated idiosyncratic factors Z by entity, sample number
-    std::vector<std::vector<Size>> simulatedEntityState_;
-
-    std::vector<std::vector<Matrix>> entityStateSimulationMatrices_;
     // Systemic part (Y_i) of entity state X_i by date index, entity index, sample number
     std::vector<std::vector<std::vector<Real>>> globalStates_;
 };
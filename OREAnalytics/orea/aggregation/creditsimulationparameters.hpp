@@ -58,6 +58,8 @@ public:
     bool doubleDefault() const { return doubleDefault_; }
     Size seed() const { return seed_; }
     Size paths() const { return paths_; }
+    Size threads() const { return threads_; }
+    Size pathBlockSize() const { return pathBlockSize_; }
     const std::string& creditMode() const { return creditMode_; }
     const std::string& loanExposureMode() const { return loanExposureMode_; }
     const std::vector<string>& nettingSetIds() const { return nettingSetIds_; }
@@ -77,6 +79,8 @@ public:
     bool& doubleDefault() { return doubleDefault_; }
     Size& seed() { return seed_; }
     Size& paths() { return paths_; }
+    Size& threads() { return threads_; }
+    Size& pathBlockSize() { return pathBlockSize_; }
     std::string& creditMode() { return creditMode_; }
     std::string& loanExposureMode() { return loanExposureMode_; }
     std::vector<string>& nettingSetIds() { return nettingSetIds_; }
@@ -106,6 +110,7 @@ private:
     string evaluation_;
     bool doubleDefault_;
     Size seed_, paths_;
+    Size threads_ = 1, pathBlockSize_ = 0;
     string creditMode_;
     string loanExposureMode_;
     std::vector<string> nettingSetIds_;
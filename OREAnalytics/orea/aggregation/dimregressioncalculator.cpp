@@ -24,18 +24,22 @@
 #include <ql/version.hpp>
 
 #include <ql/math/distributions/normaldistribution.hpp>
-#include <ql/math/generallinearleastsquares.hpp>
 #include <ql/math/kernelfunctions.hpp>
 #include <ql/methods/montecarlo/lsmbasissystem.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
 #include <qle/math/nadarayawatson.hpp>
-#include <qle/math/stabilisedglls.hpp>
+#include <qle/math/randomvariablelsmbasissystem.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/error_of_mean.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/variance.hpp>
+
+#include <exception>
+#include <thread>
+#include <tuple>
 
 using namespace std;
 using namespace QuantLib;
@@ -109,18 +113,12 @@ void RegressionDynamicInitialMarginCalculator::build() {
     LsmBasisSystem::PolynomialType polynomType = LsmBasisSystem::Monomial;
     Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
     LOG("DIM regression dimension = " << regressionDimension);
-#if QL_HEX_VERSION > 0x01150000
-    std::vector<ext::function<Real(Array)>> v(
-        LsmBasisSystem::multiPathBasisSystem(regressionDimension, polynomOrder, polynomType));
-#else // QL 1.14 and below
-    std::vector<boost::function1<Real, Array>> v(
-        LsmBasisSystem::multiPathBasisSystem(regressionDimension, polynomOrder, polynomType));
-#endif
+    auto basisFn = RandomVariableLsmBasisSystem::multiPathBasisSystem(regressionDimension, polynomOrder, polynomType);
     Real confidenceLevel = QuantLib::InverseCumulativeNormal()(quantile_);
     LOG("DIM confidence level " << confidenceLevel);
 
-    Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
-    Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
+    // netting sets (and their index and scaling) for which we run the regression
+    vector<std::tuple<string, Size, Real>> regressionNettingSets;
 
     Size nettingSetCount = 0;
     for (auto n : nettingSetIds_) {
@@ -158,6 +156,7 @@ void RegressionDynamicInitialMarginCalculator::build() {
                 }
                 WLOG("Overriding DIM for netting set " << n << " succeeded");
                 // continue to the next netting set
+                nettingSetCount++;
                 continue;
             }
         }
@@ -176,128 +175,206 @@ void RegressionDynamicInitialMarginCalculator::build() {
             nettingSetScaling_.find(n) == nettingSetScaling_.end() ? 1.0 : nettingSetScaling_[n];
         LOG("Netting set DIM scaling factor: " << nettingSetDimScaling);
 
-        for (Size j = 0; j < stopDatesLoop; ++j) {
-            accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
-            accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real npvDefault = nettingSetNPV_[n][j][k];
-                Real flow = nettingSetFLOW_[n][j][k];
-                Real npvCloseOut = nettingSetCloseOutNPV_[n][j][k];
-                accDiff((npvCloseOut * numCloseOut) + (flow * numDefault) - (npvDefault * numDefault));
-                accOneOverNumeraire(1.0 / numDefault);
-            }
+        regressionNettingSets.push_back(std::make_tuple(n, nettingSetCount, nettingSetDimScaling));
 
-            Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
-            Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
-
-            Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
-            Real E_OneOverNumeraire =
-                mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
-
-            nettingSetZeroOrderDIM_[n][j] = stdevDiff * horizonScaling * confidenceLevel;
-            nettingSetZeroOrderDIM_[n][j] *= E_OneOverNumeraire;
-
-            vector<Real> rx0(samples, 0.0);
-            vector<Array> rx(samples, Array());
-            vector<Real> ry1(samples, 0.0);
-            vector<Real> ry2(samples, 0.0);
-            for (Size k = 0; k < samples; ++k) {
-                Real numDefault =
-                    cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real numCloseOut =
-                    cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
-                Real x = nettingSetNPV_[n][j][k] * numDefault;
-                Real f = nettingSetFLOW_[n][j][k] * numDefault;
-                Real y = nettingSetCloseOutNPV_[n][j][k] * numCloseOut;
-                Real z = (y + f - x);
-                rx[k] = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                rx0[k] = rx[k][0];
-                ry1[k] = z;     // for local regression
-                ry2[k] = z * z; // for least squares regression
-                nettingSetDeltaNPV_[n][j][k] = z;
-                regressorArray_[n][j][k] = rx[k];
-            }
-            vector<Real> delNpvVec_copy = nettingSetDeltaNPV_[n][j];
-            sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
-            Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
-            Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
-            simpleDim_h *= horizonScaling;                                  // the usual scaling factors
-            simpleDim_p *= horizonScaling;                                  // the usual scaling factors
-            nettingSetSimpleDIMh_[n][j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
-            nettingSetSimpleDIMp_[n][j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
-
-            QL_REQUIRE(rx.size() > v.size(), "not enough points for regression with polynom order " << polynomOrder);
-            if (close_enough(stdevDiff, 0.0)) {
-                LOG("DIM: Zero std dev estimation at step " << j);
-                // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
-                for (Size k = 0; k < samples; ++k) {
-                    nettingSetDIM_[n][j][k] = 0.0;
-                    nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
-            } else {
-                // Least squares polynomial regression with specified polynom order
-                QuantExt::StabilisedGLLS ls(rx, ry2, v, QuantExt::StabilisedGLLS::MeanStdDev);
-                LOG("DIM data normalisation at time step "
-                    << j << ": " << scientific << setprecision(6) << " x-shift = " << ls.xShift() << " x-multiplier = "
-                    << ls.xMultiplier() << " y-shift = " << ls.yShift() << " y-multiplier = " << ls.yMultiplier());
-                LOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6)
-                                                                << ls.transformedCoefficients());
-
-                // Local regression versus first regression variable (i.e. we do not perform a
-                // multidimensional local regression):
-                // We evaluate this at a limited number of samples only for validation purposes.
-                // Note that computational effort scales quadratically with number of samples.
-                // NadarayaWatson needs a large number of samples for good results.
-                QuantExt::NadarayaWatson lr(rx0.begin(), rx0.end(), ry1.begin(),
-                                            GaussianKernel(0.0, localRegressionBandWidth_));
-                Size localRegressionSamples = samples;
-                if (localRegressionEvaluations_ > 0)
-                    localRegressionSamples = Size(floor(1.0 * samples / localRegressionEvaluations_ + .5));
-
-                // Evaluate regression function to compute DIM for each scenario
-                for (Size k = 0; k < samples; ++k) {
-                    // Real num1 = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real numDefault = cubeInterpretation_->getDefaultAggregationScenarioData(
-                        AggregationScenarioDataType::Numeraire, j, k);
-                    Array regressor = regressors_.empty() ? Array(1, nettingSetNPV_[n][j][k]) : regressorArray(n, j, k);
-                    Real e = ls.eval(regressor, v);
-                    if (e < 0.0)
-                        LOG("Negative variance regression for date " << j << ", sample " << k
-                                                                     << ", regressor = " << regressor);
-
-                    // Note:
-                    // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
-                    //    and to avoid a second regression for the conditional mean
-                    // 2) In particular the linear regression function can yield negative variance values in
-                    //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
-                    //    variance approaching zero. We correct this here by taking the positive part.
-                    Real std = sqrt(std::max(e, 0.0));
-                    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
-                    // Real dim = std * scalingFactor / num1;
-                    Real dim = std * scalingFactor / numDefault;
-                    dimCube_->set(dim, nettingSetCount, j, k);
-                    nettingSetDIM_[n][j][k] = dim;
-                    nettingSetExpectedDIM_[n][j] += dim / samples;
-
-                    // Evaluate the Kernel regression for a subset of the samples only (performance)
-                    if (localRegressionEvaluations_ > 0 && (k % localRegressionSamples == 0))
-                        // nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / num1;
-                        nettingSetLocalDIM_[n][j][k] = lr.standardDeviation(regressor[0]) * scalingFactor / numDefault;
-                    else
-                        nettingSetLocalDIM_[n][j][k] = 0.0;
-                }
+        nettingSetCount++;
+    }
+
+    // run the regressions for all netting sets and dates, in parallel if more than one thread is requested
+
+    Size nTasks = regressionNettingSets.size() * stopDatesLoop;
+    Size nThreads = std::max<Size>(1, std::min<Size>(inputs_ ? inputs_->nThreads() : 1, nTasks));
+    LOG("Run " << nTasks << " DIM regressions on " << nThreads << " thread(s)");
+
+    std::vector<std::exception_ptr> errors(nThreads);
+    auto runTasks = [this, &regressionNettingSets, &basisFn, &errors, stopDatesLoop, nTasks, nThreads,
+                     confidenceLevel](const Size t) {
+        try {
+            for (Size task = t; task < nTasks; task += nThreads) {
+                const auto& ns = regressionNettingSets[task / stopDatesLoop];
+                buildDate(std::get<0>(ns), std::get<1>(ns), task % stopDatesLoop, std::get<2>(ns), basisFn,
+                          confidenceLevel);
             }
+        } catch (...) {
+            errors[t] = std::current_exception();
         }
+    };
+
+    if (nThreads == 1) {
+        runTasks(0);
+    } else {
+        std::vector<std::thread> jobs;
+        for (Size t = 0; t < nThreads; ++t)
+            jobs.emplace_back(runTasks, t);
+        for (auto& j : jobs)
+            j.join();
+    }
 
-        nettingSetCount++;
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
     }
+
     LOG("DIM by polynomial regression done");
 }
 
+void RegressionDynamicInitialMarginCalculator::buildDate(
+    const string& n, Size nettingSetIndex, Size j, Real nettingSetDimScaling,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    Real confidenceLevel) {
+
+    // only use at() on the result maps here, so that we can process several netting sets and dates in parallel
+
+    Size samples = cube_->samples();
+    Size regressionDimension = regressors_.empty() ? 1 : regressors_.size();
+
+    Size simple_dim_index_h = Size(floor(quantile_ * (samples - 1) + 0.5));
+    Size simple_dim_index_p = Size(floor((1.0 - quantile_) * (samples - 1) + 0.5));
+
+    QL_REQUIRE(samples > basisFn.size(), "not enough points for regression with polynom order " << regressionOrder_);
+
+    const vector<Real>& npv = nettingSetNPV_.at(n)[j];
+    const vector<Real>& flow = nettingSetFLOW_.at(n)[j];
+    const vector<Real>& closeOutNpv = nettingSetCloseOutNPV_.at(n)[j];
+    vector<Real>& deltaNpv = nettingSetDeltaNPV_.at(n)[j];
+    vector<Real>& dimValues = nettingSetDIM_.at(n)[j];
+    vector<Real>& localDimValues = nettingSetLocalDIM_.at(n)[j];
+    vector<Array>& regressorValues = regressorArray_.at(n)[j];
+    Real& expectedDim = nettingSetExpectedDIM_.at(n)[j];
+
+    accumulator_set<double, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> accDiff;
+    accumulator_set<double, stats<boost::accumulators::tag::mean>> accOneOverNumeraire;
+    vector<Real> numDefault(samples);
+    for (Size k = 0; k < samples; ++k) {
+        numDefault[k] =
+            cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        Real numCloseOut =
+            cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        accDiff((closeOutNpv[k] * numCloseOut) + (flow[k] * numDefault[k]) - (npv[k] * numDefault[k]));
+        accOneOverNumeraire(1.0 / numDefault[k]);
+    }
+
+    Size mporCalendarDays = cubeInterpretation_->getMporCalendarDays(cube_, j);
+    Real horizonScaling = sqrt(1.0 * horizonCalendarDays_ / mporCalendarDays);
+
+    Real stdevDiff = sqrt(boost::accumulators::variance(accDiff));
+    Real E_OneOverNumeraire =
+        mean(accOneOverNumeraire); // "re-discount" (the stdev is calculated on non-discounted deltaNPVs)
+
+    nettingSetZeroOrderDIM_.at(n)[j] = stdevDiff * horizonScaling * confidenceLevel;
+    nettingSetZeroOrderDIM_.at(n)[j] *= E_OneOverNumeraire;
+
+    // regressors and regressands, the regressors are stored column-wise for the vectorised regression
+
+    vector<RandomVariable> rx(regressionDimension, RandomVariable(samples));
+    vector<Real> rx0(samples, 0.0);
+    vector<Real> ry1(samples, 0.0);
+    RandomVariable ry2(samples);
+    for (Size k = 0; k < samples; ++k) {
+        Real numCloseOut =
+            cubeInterpretation_->getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, j, k);
+        Real x = npv[k] * numDefault[k];
+        Real f = flow[k] * numDefault[k];
+        Real y = closeOutNpv[k] * numCloseOut;
+        Real z = (y + f - x);
+        regressorValues[k] = regressors_.empty() ? Array(1, npv[k]) : regressorArray(n, j, k);
+        for (Size i = 0; i < regressionDimension; ++i)
+            rx[i].set(k, regressorValues[k][i]);
+        rx0[k] = regressorValues[k][0];
+        ry1[k] = z;          // for local regression
+        ry2.set(k, z * z);   // for least squares regression
+        deltaNpv[k] = z;
+    }
+    vector<Real> delNpvVec_copy = deltaNpv;
+    sort(delNpvVec_copy.begin(), delNpvVec_copy.end());
+    Real simpleDim_h = delNpvVec_copy[simple_dim_index_h];
+    Real simpleDim_p = delNpvVec_copy[simple_dim_index_p];
+    simpleDim_h *= horizonScaling;                                       // the usual scaling factors
+    simpleDim_p *= horizonScaling;                                       // the usual scaling factors
+    nettingSetSimpleDIMh_.at(n)[j] = simpleDim_h * E_OneOverNumeraire; // discounted DIM
+    nettingSetSimpleDIMp_.at(n)[j] = simpleDim_p * E_OneOverNumeraire; // discounted DIM
+
+    if (close_enough(stdevDiff, 0.0)) {
+        LOG("DIM: Zero std dev estimation at step " << j);
+        // Skip IM calculation if all samples have zero NPV (e.g. after latest maturity)
+        for (Size k = 0; k < samples; ++k) {
+            dimValues[k] = 0.0;
+            localDimValues[k] = 0.0;
+        }
+        return;
+    }
+
+    // Least squares polynomial regression with specified polynom order, the data is normalised to zero mean and
+    // unit standard deviation before the regression as in StabilisedGLLS::MeanStdDev
+    Array xShift(regressionDimension, 0.0), xMultiplier(regressionDimension, 1.0);
+    for (Size i = 0; i < regressionDimension; ++i) {
+        accumulator_set<Real, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> acc;
+        for (Size k = 0; k < samples; ++k)
+            acc(rx[i][k]);
+        xShift[i] = -mean(acc);
+        Real tmp = boost::accumulators::variance(acc);
+        if (!close_enough(tmp, 0.0))
+            xMultiplier[i] = 1.0 / std::sqrt(tmp);
+        rx[i] = (rx[i] + RandomVariable(samples, xShift[i])) * RandomVariable(samples, xMultiplier[i]);
+    }
+    accumulator_set<Real, stats<boost::accumulators::tag::mean, boost::accumulators::tag::variance>> acc2;
+    for (Size k = 0; k < samples; ++k)
+        acc2(ry2[k]);
+    Real yShift = -mean(acc2), yMultiplier = 1.0;
+    Real tmp2 = boost::accumulators::variance(acc2);
+    if (!close_enough(tmp2, 0.0))
+        yMultiplier = 1.0 / std::sqrt(tmp2);
+    ry2 = (ry2 + RandomVariable(samples, yShift)) * RandomVariable(samples, yMultiplier);
+
+    vector<const RandomVariable*> regressor(regressionDimension);
+    for (Size i = 0; i < regressionDimension; ++i)
+        regressor[i] = &rx[i];
+    Array coefficients = regressionCoefficients(ry2, regressor, basisFn, Filter(), RandomVariableRegressionMethod::QR);
+    RandomVariable e = conditionalExpectation(regressor, basisFn, coefficients) / RandomVariable(samples, yMultiplier) -
+                       RandomVariable(samples, yShift);
+
+    LOG("DIM data normalisation at time step " << j << ": " << scientific << setprecision(6) << " x-shift = " << xShift
+                                               << " x-multiplier = " << xMultiplier << " y-shift = " << yShift
+                                               << " y-multiplier = " << yMultiplier);
+    LOG("DIM regression coefficients at time step " << j << ": " << fixed << setprecision(6) << coefficients);
+
+    // Local regression versus first regression variable (i.e. we do not perform a
+    // multidimensional local regression):
+    // We use a binned kernel estimator, so that we can evaluate it for all samples, the
+    // Gaussian kernel is truncated at 8 band widths.
+    boost::shared_ptr<QuantExt::BinnedNadarayaWatson> lr;
+    if (localRegressionEvaluations_ > 0) {
+        lr = boost::make_shared<QuantExt::BinnedNadarayaWatson>(rx0.begin(), rx0.end(), ry1.begin(),
+                                                               GaussianKernel(0.0, localRegressionBandWidth_),
+                                                               8.0 * localRegressionBandWidth_);
+    }
+
+    // Evaluate regression function to compute DIM for each scenario
+    Real scalingFactor = horizonScaling * confidenceLevel * nettingSetDimScaling;
+    for (Size k = 0; k < samples; ++k) {
+        if (e[k] < 0.0)
+            LOG("Negative variance regression for date " << j << ", sample " << k
+                                                         << ", regressor = " << regressorValues[k]);
+
+        // Note:
+        // 1) We assume vanishing mean of "z", because the drift over a MPOR is usually small,
+        //    and to avoid a second regression for the conditional mean
+        // 2) In particular the linear regression function can yield negative variance values in
+        //    extreme scenarios where an exact analytical or delta VaR calculation would yield a
+        //    variance approaching zero. We correct this here by taking the positive part.
+        Real std = sqrt(std::max(e[k], 0.0));
+        Real dim = std * scalingFactor / numDefault[k];
+        dimCube_->set(dim, nettingSetIndex, j, k);
+        dimValues[k] = dim;
+        expectedDim += dim / samples;
+
+        if (lr)
+            localDimValues[k] = lr->standardDeviation(rx0[k]) * scalingFactor / numDefault[k];
+        else
+            localDimValues[k] = 0.0;
+    }
+}
+
 Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet, Size dateIndex,
                                                                            Size sampleIndex) {
     Array a(regressors_.size());
@@ -305,7 +382,7 @@ Array RegressionDynamicInitialMarginCalculator::regressorArray(string nettingSet
         string variable = regressors_[i];
         if (boost::to_upper_copy(variable) ==
             "NPV") // this allows possibility to include NPV as a regressor alongside more fundamental risk factors
-            a[i] = nettingSetNPV_[nettingSet][dateIndex][sampleIndex];
+            a[i] = nettingSetNPV_.at(nettingSet)[dateIndex][sampleIndex];
         else if (scenarioData_->has(AggregationScenarioDataType::IndexFixing, variable))
             a[i] = cubeInterpretation_->getDefaultAggregationScenarioData(AggregationScenarioDataType::IndexFixing,
                                                                       dateIndex, sampleIndex, variable);
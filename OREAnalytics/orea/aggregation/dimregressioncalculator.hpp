@@ -25,6 +25,8 @@
 
 #include <orea/aggregation/dimcalculator.hpp>
 
+#include <qle/math/randomvariable.hpp>
+
 namespace ore {
 namespace analytics {
 using namespace QuantLib;
@@ -35,7 +37,7 @@ using namespace std;
 //! Dynamic Initial Margin Calculator using polynomial regression
 /*!
   Dynamic IM is estimated using polynomial and local regression methods applied to the NPV moves over simulation time
-  steps across all paths.
+  steps across all paths. The regressions for the netting sets and dates are run on inputs->nThreads() threads.
 */
 class RegressionDynamicInitialMarginCalculator : public DynamicInitialMarginCalculator {
 public:
@@ -58,7 +60,7 @@ public:
         Size regressionOrder,
         //! Regressors to be used
         vector<string> regressors,
-        //! Number of local regression evaluation windows across all paths, up to number of samples
+        //! If positive, the local regression is evaluated for all samples, using a binned kernel estimator
         Size localRegressionEvaluations = 0,
         //! Local regression band width in standard deviations of the regression variable
         Real localRegressionBandWidth = 0,
@@ -81,6 +83,12 @@ private:
     //! Compile the array of DIM regressors for the specified netting set, date and sample index
     Array regressorArray(string nettingSet, Size dateIndex, Size sampleIndex);
 
+    //! Run the regressions for the specified netting set and date index, safe to call in parallel for distinct pairs
+    void buildDate(const string& nettingSet, Size nettingSetIndex, Size dateIndex, Real nettingSetDimScaling,
+                   const std::vector<std::function<QuantExt::RandomVariable(
+                       const std::vector<const QuantExt::RandomVariable*>&)>>& basisFn,
+                   Real confidenceLevel);
+
     Size regressionOrder_;
     vector<string> regressors_;
     Size localRegressionEvaluations_;
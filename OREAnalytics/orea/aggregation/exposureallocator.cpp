@@ -21,6 +21,10 @@
 
 #include <ored/portfolio/trade.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -40,27 +44,97 @@ ExposureAllocator::ExposureAllocator(
       allocatedTradeEpeIndex_(allocatedTradeEpeIndex), allocatedTradeEneIndex_(allocatedTradeEneIndex),
       nettingSetEpeIndex_(nettingSetEpeIndex), nettingSetEneIndex_(nettingSetEneIndex) {}
 
-void ExposureAllocator::build() {
+void ExposureAllocator::build(const Size nThreads) {
     LOG("Compute allocated trade exposures");
 
+    // group the trades by netting set, resolve the cube indices and allocation weights once
+
+    struct TradeAllocation {
+        Size tradeIndex;
+        Real weightEpe, weightEne;
+    };
+
+    std::map<string, Size> nettingSetPos;
+    std::vector<Size> nettingSetIndex;
     for (const auto& [nettingSetId, idx] : nettedExposureCube_->idsAndIndexes()) {
+        nettingSetPos[nettingSetId] = nettingSetIndex.size();
+        nettingSetIndex.push_back(idx);
+    }
+
+    std::vector<std::vector<TradeAllocation>> nettingSetTrades(nettingSetIndex.size());
+    for (const auto& [tid, trade] : portfolio_->trades()) {
+        string nid = trade->envelope().nettingSetId();
+        auto n = nettingSetPos.find(nid);
+        if (n == nettingSetPos.end())
+            continue;
+        nettingSetTrades[n->second].push_back(
+            {tradeExposureCube_->getTradeIndex(tid), allocationWeightEpe(tid, nid), allocationWeightEne(tid, nid)});
+    }
+
+    Size numDates = tradeExposureCube_->numDates();
+    Size samples = tradeExposureCube_->samples();
+    std::vector<Size> nettedDateIndex(numDates);
+    const std::vector<Date>& nettedDates = nettedExposureCube_->dates();
+    for (Size j = 0; j < numDates; ++j) {
+        auto d = std::find(nettedDates.begin(), nettedDates.end(), tradeExposureCube_->dates()[j]);
+        QL_REQUIRE(d != nettedDates.end(), "ExposureAllocator::build(): date "
+                                               << tradeExposureCube_->dates()[j] << " not in netted exposure cube");
+        nettedDateIndex[j] = std::distance(nettedDates.begin(), d);
+    }
+
+    // allocate the netting set exposures, the netting sets are distributed over the threads
 
-        for (const auto & [tid, trade] : portfolio_->trades()) {
-            string nid = trade->envelope().nettingSetId();
-            if (nid != nettingSetId)
-                continue;
-            
-
-            for (Date date : tradeExposureCube_->dates()) {
-                for (Size k = 0; k < tradeExposureCube_->samples(); ++k) {
-                    tradeExposureCube_->set(calculateAllocatedEpe(tid, nid, date, k),
-                                            tid, date, k, allocatedTradeEpeIndex_);
-                    tradeExposureCube_->set(calculateAllocatedEne(tid, nid, date, k),
-                                            tid, date, k, allocatedTradeEneIndex_);
+    Size nTasks = nettingSetIndex.size();
+    Size effThreads = std::max<Size>(1, std::min<Size>(nThreads, nTasks));
+    LOG("Allocate exposures of " << nTasks << " netting sets on " << effThreads << " thread(s)");
+
+    std::vector<std::exception_ptr> errors(effThreads);
+    auto runTasks = [this, &nettingSetIndex, &nettingSetTrades, &nettedDateIndex, &errors, numDates, samples, nTasks,
+                     effThreads](const Size t) {
+        try {
+            std::vector<Real> epe(numDates * samples), ene(numDates * samples);
+            for (Size n = t; n < nTasks; n += effThreads) {
+                if (nettingSetTrades[n].empty())
+                    continue;
+                for (Size j = 0; j < numDates; ++j) {
+                    for (Size k = 0; k < samples; ++k) {
+                        epe[j * samples + k] =
+                            nettedExposureCube_->get(nettingSetIndex[n], nettedDateIndex[j], k, nettingSetEpeIndex_);
+                        ene[j * samples + k] =
+                            nettedExposureCube_->get(nettingSetIndex[n], nettedDateIndex[j], k, nettingSetEneIndex_);
+                    }
+                }
+                for (auto const& trade : nettingSetTrades[n]) {
+                    for (Size j = 0; j < numDates; ++j) {
+                        for (Size k = 0; k < samples; ++k) {
+                            tradeExposureCube_->set(epe[j * samples + k] * trade.weightEpe, trade.tradeIndex, j, k,
+                                                    allocatedTradeEpeIndex_);
+                            tradeExposureCube_->set(ene[j * samples + k] * trade.weightEne, trade.tradeIndex, j, k,
+                                                    allocatedTradeEneIndex_);
+                        }
+                    }
                 }
             }
+        } catch (...) {
+            errors[t] = std::current_exception();
         }
+    };
+
+    if (effThreads == 1) {
+        runTasks(0);
+    } else {
+        std::vector<std::thread> jobs;
+        for (Size t = 0; t < effThreads; ++t)
+            jobs.emplace_back(runTasks, t);
+        for (auto& j : jobs)
+            j.join();
     }
+
+    for (auto const& e : errors) {
+        if (e)
+            std::rethrow_exception(e);
+    }
+
     LOG("Completed calculating allocated trade exposures");
 }
 
@@ -94,20 +168,16 @@ RelativeFairValueNetExposureAllocator::RelativeFairValueNetExposureAllocator(
     }
 }
 
-Real RelativeFairValueNetExposureAllocator::calculateAllocatedEpe(const string& tid, const string& nid,
-                                                                    const Date& date, const Size sample) {
+Real RelativeFairValueNetExposureAllocator::allocationWeightEpe(const string& tid, const string& nid) {
     // FIXME: What to do when either the pos. or neg. netting set value is zero?
     QL_REQUIRE(nettingSetPositiveValueToday_[nid] > 0.0, "non-zero positive NPV expected");
-    Real netEPE = nettedExposureCube_->get(nid, date, sample, nettingSetEpeIndex_);
-    return netEPE * std::max(tradeValueToday_[tid], 0.0) / nettingSetPositiveValueToday_[nid];
+    return std::max(tradeValueToday_[tid], 0.0) / nettingSetPositiveValueToday_[nid];
 }
 
-Real RelativeFairValueNetExposureAllocator::calculateAllocatedEne(const string& tid, const string& nid,
-                                                                    const Date& date, const Size sample) {
+Real RelativeFairValueNetExposureAllocator::allocationWeightEne(const string& tid, const string& nid) {
     // FIXME: What to do when either the pos. or neg. netting set value is zero?
     QL_REQUIRE(nettingSetNegativeValueToday_[nid] > 0.0, "non-zero negative NPV expected");
-    Real netENE = nettedExposureCube_->get(nid, date, sample, nettingSetEneIndex_);
-    return netENE * -std::max(-tradeValueToday_[tid], 0.0) / nettingSetPositiveValueToday_[nid];
+    return -std::max(-tradeValueToday_[tid], 0.0) / nettingSetPositiveValueToday_[nid];
 }
 
 RelativeFairValueGrossExposureAllocator::RelativeFairValueGrossExposureAllocator(
@@ -135,20 +205,16 @@ RelativeFairValueGrossExposureAllocator::RelativeFairValueGrossExposureAllocator
     }
 }
 
-Real RelativeFairValueGrossExposureAllocator::calculateAllocatedEpe(const string& tid, const string& nid,
-                                                                    const Date& date, const Size sample) {
+Real RelativeFairValueGrossExposureAllocator::allocationWeightEpe(const string& tid, const string& nid) {
     // FIXME: What to do when the netting set value is zero?
     QL_REQUIRE(nettingSetValueToday_[nid] != 0.0, "non-zero netting set value expected");
-    Real netEPE = nettedExposureCube_->get(nid, date, sample, nettingSetEpeIndex_);
-    return netEPE * tradeValueToday_[tid] / nettingSetValueToday_[nid];
+    return tradeValueToday_[tid] / nettingSetValueToday_[nid];
 }
 
-Real RelativeFairValueGrossExposureAllocator::calculateAllocatedEne(const string& tid, const string& nid,
-                                                                    const Date& date, const Size sample) {
+Real RelativeFairValueGrossExposureAllocator::allocationWeightEne(const string& tid, const string& nid) {
     // FIXME: What to do when the netting set value is zero?
     QL_REQUIRE(nettingSetValueToday_[nid] != 0.0, "non-zero netting set value expected");
-    Real netENE = nettedExposureCube_->get(nid, date, sample, nettingSetEneIndex_);
-    return netENE * tradeValueToday_[tid] / nettingSetValueToday_[nid];
+    return tradeValueToday_[tid] / nettingSetValueToday_[nid];
 }
 
 RelativeXvaExposureAllocator::RelativeXvaExposureAllocator(
@@ -170,15 +236,11 @@ RelativeXvaExposureAllocator::RelativeXvaExposureAllocator(
       tradeCva_(tradeCva), tradeDva_(tradeDva),
       nettingSetSumCva_(nettingSetSumCva), nettingSetSumDva_(nettingSetSumDva) {}
 
-Real RelativeXvaExposureAllocator::calculateAllocatedEpe(const string& tid, const string& nid,
-                                                         const Date& date, const Size sample) {
-    Real netEPE = nettedExposureCube_->get(nid, date, sample, nettingSetEpeIndex_);
-    return netEPE * tradeCva_[tid] / nettingSetSumCva_[nid];
+Real RelativeXvaExposureAllocator::allocationWeightEpe(const string& tid, const string& nid) {
+    return tradeCva_[tid] / nettingSetSumCva_[nid];
 }
-Real RelativeXvaExposureAllocator::calculateAllocatedEne(const string& tid, const string& nid,
-                                                         const Date& date, const Size sample) {
-    Real netENE = nettedExposureCube_->get(nid, date, sample, nettingSetEneIndex_);
-    return netENE * tradeDva_[tid] / nettingSetSumDva_[nid];
+Real RelativeXvaExposureAllocator::allocationWeightEne(const string& tid, const string& nid) {
+    return tradeDva_[tid] / nettingSetSumDva_[nid];
 }
 
 NoneExposureAllocator::NoneExposureAllocator(
@@ -187,14 +249,8 @@ NoneExposureAllocator::NoneExposureAllocator(
     const boost::shared_ptr<NPVCube>& nettedExposureCube)
     : ExposureAllocator(portfolio, tradeExposureCube, nettedExposureCube) {}
 
-Real NoneExposureAllocator::calculateAllocatedEpe(const string& tid, const string& nid,
-                                                  const Date& date, const Size sample) {
-    return 0;
-}
-Real NoneExposureAllocator::calculateAllocatedEne(const string& tid, const string& nid,
-                                                  const Date& date, const Size sample) {
-    return 0;
-}
+Real NoneExposureAllocator::allocationWeightEpe(const string& tid, const string& nid) { return 0; }
+Real NoneExposureAllocator::allocationWeightEne(const string& tid, const string& nid) { return 0; }
 
 ExposureAllocator::AllocationMethod parseAllocationMethod(const string& s) {
     static map<string, ExposureAllocator::AllocationMethod> m = {
@@ -60,13 +60,16 @@ public:
 
     virtual ~ExposureAllocator() {}
     const boost::shared_ptr<NPVCube>& exposureCube() { return tradeExposureCube_; }
-    //! Compute exposures along all paths and fill result structures
-    virtual void build();
+    /*! Compute exposures along all paths and fill result structures. The trades are grouped by netting set and the
+        cube indices and allocation weights are resolved once, the netting sets are processed on nThreads threads. */
+    virtual void build(const Size nThreads = 1);
 
 
 protected:
-    virtual Real calculateAllocatedEpe(const string& tid, const string& nid, const Date& date, const Size sample) = 0;
-    virtual Real calculateAllocatedEne(const string& tid, const string& nid, const Date& date, const Size sample) = 0;
+    /*! The allocated trade EPE (ENE) is the netting set EPE (ENE) times the weight returned here. The weights are
+        computed once per trade in build(), before the netting set exposures are allocated. */
+    virtual Real allocationWeightEpe(const string& tid, const string& nid) = 0;
+    virtual Real allocationWeightEne(const string& tid, const string& nid) = 0;
     boost::shared_ptr<Portfolio> portfolio_;
     boost::shared_ptr<NPVCube> tradeExposureCube_;
     boost::shared_ptr<NPVCube> nettedExposureCube_;
@@ -91,8 +94,8 @@ public:
         const Size nettingSetEpeIndex = 1, const Size nettingSetEneIndex = 2);
 
 protected:
-    virtual Real calculateAllocatedEpe(const string& tid, const string& nid, const Date& date, const Size sample) override;
-    virtual Real calculateAllocatedEne(const string& tid, const string& nid, const Date& date, const Size sample) override;
+    virtual Real allocationWeightEpe(const string& tid, const string& nid) override;
+    virtual Real allocationWeightEne(const string& tid, const string& nid) override;
     map<string, Real> tradeValueToday_;
     map<string, Real> nettingSetPositiveValueToday_;
     map<string, Real> nettingSetNegativeValueToday_;
@@ -110,8 +113,8 @@ public:
         const Size nettingSetEpeIndex = 1, const Size nettingSetEneIndex = 2);
 
 protected:
-    virtual Real calculateAllocatedEpe(const string& tid, const string& nid, const Date& date, const Size sample) override;
-    virtual Real calculateAllocatedEne(const string& tid, const string& nid, const Date& date, const Size sample) override;
+    virtual Real allocationWeightEpe(const string& tid, const string& nid) override;
+    virtual Real allocationWeightEne(const string& tid, const string& nid) override;
     map<string, Real> tradeValueToday_;
     map<string, Real> nettingSetValueToday_;
 };
@@ -132,8 +135,8 @@ public:
         const Size nettingSetEpeIndex = 0, const Size nettingSetEneIndex = 1);
 
 protected:
-    virtual Real calculateAllocatedEpe(const string& tid, const string& nid, const Date& date, const Size sample) override;
-    virtual Real calculateAllocatedEne(const string& tid, const string& nid, const Date& date, const Size sample) override;
+    virtual Real allocationWeightEpe(const string& tid, const string& nid) override;
+    virtual Real allocationWeightEne(const string& tid, const string& nid) override;
     map<string, Real> tradeCva_;
     map<string, Real> tradeDva_;
     map<string, Real> nettingSetSumCva_;
@@ -149,8 +152,8 @@ public:
         const boost::shared_ptr<NPVCube>& nettedExposureCube);
 
 protected:
-    virtual Real calculateAllocatedEpe(const string& tid, const string& nid, const Date& date, const Size sample) override;
-    virtual Real calculateAllocatedEne(const string& tid, const string& nid, const Date& date, const Size sample) override;
+    virtual Real allocationWeightEpe(const string& tid, const string& nid) override;
+    virtual Real allocationWeightEne(const string& tid, const string& nid) override;
 };
 
 //! Convert text representation to ExposureAllocator::AllocationMethod
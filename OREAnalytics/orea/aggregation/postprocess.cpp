@@ -68,7 +68,7 @@ PostProcess::PostProcess(
     const boost::shared_ptr<CreditSimulationParameters>& creditSimulationParameters,
     const std::vector<Real>& creditMigrationDistributionGrid, const std::vector<Size>& creditMigrationTimeSteps,
     const Matrix& creditStateCorrelationMatrix,
-    bool withMporStickyDate, ScenarioGeneratorData::MporCashFlowMode mporCashFlowMode)
+    bool withMporStickyDate, ScenarioGeneratorData::MporCashFlowMode mporCashFlowMode, Size nThreads)
     : portfolio_(portfolio), nettingSetManager_(nettingSetManager), market_(market), configuration_(configuration),
       cube_(cube), cptyCube_(cptyCube), scenarioData_(scenarioData), analytics_(analytics), baseCurrency_(baseCurrency),
       quantile_(quantile), calcType_(parseCollateralCalculationType(calculationType)), dvaName_(dvaName),
@@ -81,7 +81,7 @@ PostProcess::PostProcess(
       creditSimulationParameters_(creditSimulationParameters),
       creditMigrationDistributionGrid_(creditMigrationDistributionGrid),
       creditMigrationTimeSteps_(creditMigrationTimeSteps), creditStateCorrelationMatrix_(creditStateCorrelationMatrix),
-      withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode) {
+      withMporStickyDate_(withMporStickyDate), mporCashFlowMode_(mporCashFlowMode), nThreads_(nThreads) {
 
     QL_REQUIRE(cubeInterpretation_ != nullptr, "PostProcess: cubeInterpretation is not given.");
     bool isRegularCubeStorage = !cubeInterpretation_->withCloseOutLag();
@@ -262,7 +262,7 @@ PostProcess::PostProcess(
     else
         QL_FAIL("allocationMethod " << allocationMethod << " not available");
     if(exposureAllocator)
-        exposureAllocator->build();
+        exposureAllocator->build(nThreads_);
 
     /********************************************************
      * Update Allocated XVAs
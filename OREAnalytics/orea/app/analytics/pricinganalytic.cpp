@@ -234,7 +234,16 @@ void PricingAnalyticImpl::runAnalytic(
 
             if (inputs_->parSensi()) {
                 LOG("Sensi analysis - par conversion");
-                parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket());
+                // reuse the par instrument sensitivities from a previous run, if they are not too stale and were
+                // computed for the same par and raw keys
+                if (inputs_->parSensiCacheFile().empty() ||
+                    !parAnalysis->readParInstrumentSensitivities(inputs_->parSensiCacheFile(),
+                                                                 inputs_->parSensiCacheMaxStaleness(),
+                                                                 sensiAnalysis->simMarket())) {
+                    parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket());
+                    if (!inputs_->parSensiCacheFile().empty())
+                        parAnalysis->writeParInstrumentSensitivities(inputs_->parSensiCacheFile());
+                }
                 boost::shared_ptr<ParSensitivityConverter> parConverter =
                     boost::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
                 auto parCube = boost::make_shared<ZeroToParCube>(sensiAnalysis->sensiCube(), parConverter, typesDisabled, true);
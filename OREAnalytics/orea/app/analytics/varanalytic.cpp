@@ -60,7 +60,7 @@ void VarAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
     }
 
     ParametricVarCalculator::ParametricVarParams varParams(inputs_->varMethod(), inputs_->mcVarSamples(),
-                                                           inputs_->mcVarSeed());
+                                                           inputs_->mcVarSeed(), inputs_->nThreads());
 
     LOG("Build VaR calculator");
     auto calc = boost::make_shared<ParametricVarReport>(tradePortfolio, inputs_->portfolioFilter(), 
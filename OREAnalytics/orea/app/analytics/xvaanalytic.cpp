@@ -33,6 +33,12 @@
 
 #include <ored/model/crossassetmodelbuilder.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
+#include <ored/utilities/osutils.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <exception>
+#include <thread>
 
 using namespace ore::data;
 using namespace boost::filesystem;
@@ -189,14 +195,17 @@ void XvaAnalyticImpl::initCube(boost::shared_ptr<NPVCube>& cube, const std::set<
 }
 
 
-void XvaAnalyticImpl::initClassicRun(const boost::shared_ptr<Portfolio>& portfolio) {
+void XvaAnalyticImpl::initClassicRun(const boost::shared_ptr<Portfolio>& portfolio, bool concurrent) {
         
     LOG("XVA: initClassicRun");
 
-    initCubeDepth();
+    // in a concurrent run the cube depth and the scenario data are initialised by concurrentRun() before the amc
+    // thread is started, we must not touch them here
+    if (!concurrent)
+        initCubeDepth();
 
     // May have been set already
-    if (scenarioData_.empty()) {
+    if (!concurrent && scenarioData_.empty()) {
         LOG("XVA: Create asd " << grid_->valuationDates().size() << " x " << samples_);
         scenarioData_.linkTo(
             boost::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_));
@@ -205,7 +214,7 @@ void XvaAnalyticImpl::initClassicRun(const boost::shared_ptr<Portfolio>& portfol
     }
 
     // We can skip the cube initialization if the mt val engine is used, since it builds its own cubes
-    if (inputs_->nThreads() == 1) {
+    if (classicThreads() == 1) {
         if (portfolio->size() > 0)
             initCube(cube_, portfolio->ids(), cubeDepth_);
         // not required by any calculators in ore at the moment
@@ -225,7 +234,8 @@ void XvaAnalyticImpl::initClassicRun(const boost::shared_ptr<Portfolio>& portfol
 }
 
 
-boost::shared_ptr<Portfolio> XvaAnalyticImpl::classicRun(const boost::shared_ptr<Portfolio>& portfolio) {
+boost::shared_ptr<Portfolio> XvaAnalyticImpl::classicRun(const boost::shared_ptr<Portfolio>& portfolio,
+                                                         bool concurrent) {
     LOG("XVA: classicRun");
 
 
@@ -252,7 +262,7 @@ boost::shared_ptr<Portfolio> XvaAnalyticImpl::classicRun(const boost::shared_ptr
     ProgressMessage(msg, 1, 1).log();
 
     // Allocate cubes for the sub-portfolio we are processing here
-    initClassicRun(classicPortfolio_);
+    initClassicRun(classicPortfolio_, concurrent);
 
     // This is where the valuation work is done
     buildClassicCube(classicPortfolio_);
@@ -311,7 +321,7 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
     auto progressBar = boost::make_shared<SimpleProgressBar>(o.str(), ConsoleLog::instance().width(), ConsoleLog::instance().progressBarWidth());
     auto progressLog = boost::make_shared<ProgressLog>("XVA: Building cube", 100, oreSeverity::notice);
 
-    if(inputs_->nThreads() == 1) {
+    if(classicThreads() == 1) {
 
         // single-threaded engine run
 
@@ -353,7 +363,7 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
         }
 
         MultiThreadedValuationEngine engine(
-            inputs_->nThreads(), inputs_->asof(), grid_, samples_,  analytic()->loader(), scenarioGenerator_,
+            classicThreads(), inputs_->asof(), grid_, samples_,  analytic()->loader(), scenarioGenerator_,
             inputs_->simulationPricingEngine(), inputs_->curveConfigs().get(), analytic()->configurations().todaysMarketParams,
             inputs_->marketConfig("simulation"), analytic()->configurations().simMarketParams, false, false,
             boost::make_shared<ScenarioFilter>(), inputs_->refDataManager(),
@@ -399,22 +409,20 @@ XvaAnalyticImpl::amcEngineFactory(const boost::shared_ptr<QuantExt::CrossAssetMo
     return factory;
 }
 
-void XvaAnalyticImpl::buildAmcPortfolio() {
+std::vector<Date> XvaAnalyticImpl::amcSimulationDates() {
+    const auto& sgd = analytic()->configurations().scenarioGeneratorData;
+    return sgd->withCloseOutLag() && !sgd->withMporStickyDate() ? sgd->getGrid()->dates()
+                                                                : sgd->getGrid()->valuationDates();
+}
+
+void XvaAnalyticImpl::buildAmcPortfolio(const boost::shared_ptr<Portfolio>& portfolio) {
     LOG("XVA: buildAmcPortfolio");
     const string msg = "XVA: Build AMC portfolio";
     CONSOLEW(msg);
     ProgressMessage(msg, 0, 1).log();
 
-    LOG("buildAmcPortfolio: Check sim dates");
-    std::vector<Date> simDates =
-        analytic()->configurations().scenarioGeneratorData->withCloseOutLag() && !analytic()->configurations().scenarioGeneratorData->withMporStickyDate() ?
-        analytic()->configurations().scenarioGeneratorData->getGrid()->dates() : analytic()->configurations().scenarioGeneratorData->getGrid()->valuationDates();
-    
     LOG("buildAmcPortfolio: Register additional engine builders");
-    auto factory = amcEngineFactory(model_, simDates);
-
-    LOG("buildAmcPortfolio: Load Portfolio");
-    boost::shared_ptr<Portfolio> portfolio = inputs_->portfolio();
+    auto factory = amcEngineFactory(model_, amcSimulationDates());
 
     LOG("Build Portfolio with AMC Engine factory and select amc-enabled trades")
     amcPortfolio_ = boost::make_shared<Portfolio>();
@@ -438,25 +446,28 @@ void XvaAnalyticImpl::buildAmcPortfolio() {
     LOG("XVA: buildAmcPortfolio completed");
 }
 
-void XvaAnalyticImpl::amcRun(bool doClassicRun) {
+void XvaAnalyticImpl::amcRun(bool doClassicRun, bool concurrent) {
 
     LOG("XVA: amcRun");
 
-    if (scenarioData_.empty()) {
-        LOG("XVA: Create asd " << grid_->valuationDates().size() << " x " << samples_);
-        scenarioData_.linkTo(
-            boost::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_));
-        simMarket_->aggregationScenarioData() = *scenarioData_;
+    // in a concurrent run the scenario data and the cube depth are initialised by concurrentRun() before this
+    // thread is started, we must not touch them here
+    if (!concurrent) {
+        if (scenarioData_.empty()) {
+            LOG("XVA: Create asd " << grid_->valuationDates().size() << " x " << samples_);
+            scenarioData_.linkTo(
+                boost::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_));
+            simMarket_->aggregationScenarioData() = *scenarioData_;
+        }
+        initCubeDepth();
     }
 
-    initCubeDepth();
-
     std::string message = "XVA: Build AMC Cube " + std::to_string(amcPortfolio_->size()) + " x " +
                           std::to_string(grid_->valuationDates().size()) + " x " + std::to_string(samples_) + "... ";
     auto progressBar = boost::make_shared<SimpleProgressBar>(message, ConsoleLog::instance().width(), ConsoleLog::instance().progressBarWidth());
     auto progressLog = boost::make_shared<ProgressLog>("XVA: Building AMC Cube...", 100, oreSeverity::notice);
 
-    if (inputs_->nThreads() == 1) {
+    if (amcThreads() == 1 && !concurrent) {
         initCube(amcCube_, amcPortfolio_->ids(), cubeDepth_);
         AMCValuationEngine amcEngine(model_, inputs_->scenarioGeneratorData(), analytic()->market(),
                                      inputs_->exposureSimMarketParams()->additionalScenarioDataIndices(),
@@ -464,6 +475,8 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
                                      inputs_->exposureSimMarketParams()->additionalScenarioDataNumberOfCreditStates());
         amcEngine.registerProgressIndicator(progressBar);
         amcEngine.registerProgressIndicator(progressLog);
+        amcEngine.setMaxPathMemory(inputs_->amcMaxPathMemory());
+        amcEngine.setUseRegressionCache(inputs_->amcRegressionCache());
         if (!scenarioData_.empty())
             amcEngine.aggregationScenarioData() = *scenarioData_;
         amcEngine.buildCube(amcPortfolio_, amcCube_);
@@ -477,7 +490,7 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
                 return boost::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples,
                                                                                         cubeDepth_, 0.0f);
         };
-        AMCValuationEngine amcEngine(inputs_->nThreads(), inputs_->asof(), samples_, analytic()->loader(),
+        AMCValuationEngine amcEngine(amcThreads(), inputs_->asof(), samples_, analytic()->loader(),
                                      inputs_->scenarioGeneratorData(),
                                      inputs_->exposureSimMarketParams()->additionalScenarioDataIndices(),
                                      inputs_->exposureSimMarketParams()->additionalScenarioDataCcys(),
@@ -491,7 +504,10 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
 
         amcEngine.registerProgressIndicator(progressBar);
         amcEngine.registerProgressIndicator(progressLog);
-        if (!scenarioData_.empty())
+        amcEngine.setMaxPathMemory(inputs_->amcMaxPathMemory());
+        amcEngine.setUseRegressionCache(inputs_->amcRegressionCache());
+        // in a concurrent run with a single-threaded classic run, the scenario data is populated by the sim market
+        if (!scenarioData_.empty() && !(concurrent && classicThreads() == 1))
             amcEngine.aggregationScenarioData() = *scenarioData_;
         amcEngine.buildCube(amcPortfolio_);
         amcCube_ = boost::make_shared<JointNPVCube>(amcEngine.outputCubes());
@@ -502,6 +518,198 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
     LOG("XVA: amcRun completed");
 }
 
+Size XvaAnalyticImpl::classicThreads() const {
+    return inputs_->classicThreads() == 0 ? inputs_->nThreads() : inputs_->classicThreads();
+}
+
+Size XvaAnalyticImpl::amcThreads() const {
+    return inputs_->amcThreads() == 0 ? inputs_->nThreads() : inputs_->amcThreads();
+}
+
+void XvaAnalyticImpl::concurrentRun(const boost::shared_ptr<Portfolio>& residualPortfolio) {
+
+    LOG("XVA: concurrentRun, classic threads " << classicThreads() << ", amc threads " << amcThreads());
+
+    /* The classic run is done in the main thread, since it uses the simulation market and the session singletons
+       set up there. The amc run is done in a separate thread using the multi-threaded amc engine, which builds its
+       own markets and models from the loader. Both runs share the scenario data and the cube depth, which we
+       therefore initialise here, once, before the amc thread is started. Both runs are told to skip their own
+       initialisation. */
+
+    initCubeDepth();
+    if (scenarioData_.empty()) {
+        LOG("XVA: Create asd " << grid_->valuationDates().size() << " x " << samples_);
+        scenarioData_.linkTo(
+            boost::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_));
+        simMarket_->aggregationScenarioData() = *scenarioData_;
+    }
+
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+    Real amcTime = 0.0, classicTime = 0.0;
+    std::exception_ptr amcError, classicError;
+
+    std::thread amcJob([this, obsMode, &amcTime, &amcError]() {
+        // set the session singletons of the new thread
+        Settings::instance().evaluationDate() = inputs_->asof();
+        ObservationMode::instance().setMode(obsMode);
+        try {
+            boost::timer::cpu_timer timer;
+            amcRun(true, true);
+            amcTime = timer.elapsed().wall / 1E9;
+        } catch (...) {
+            amcError = std::current_exception();
+        }
+    });
+
+    try {
+        boost::timer::cpu_timer timer;
+        classicPortfolio_ = classicRun(residualPortfolio, true);
+        classicTime = timer.elapsed().wall / 1E9;
+    } catch (...) {
+        classicError = std::current_exception();
+    }
+
+    amcJob.join();
+
+    if (classicError)
+        std::rethrow_exception(classicError);
+    if (amcError)
+        std::rethrow_exception(amcError);
+
+    LOG("XVA: concurrentRun completed, classic run " << classicTime << " sec (" << classicThreads()
+                                                     << " threads), amc run " << amcTime << " sec (" << amcThreads()
+                                                     << " threads), process peak memory (both runs and all prior "
+                                                     << "work) " << os::getPeakMemoryUsage());
+}
+
+boost::shared_ptr<Portfolio> XvaAnalyticImpl::initIncrementalRun() {
+
+    LOG("XVA: initIncrementalRun");
+
+    const boost::shared_ptr<NPVCube>& baseCube = inputs_->cube();
+    QL_REQUIRE(baseCube, "XVA: incremental run requires the base run's NPV cube as input");
+    QL_REQUIRE(inputs_->mktCube(), "XVA: incremental run requires the base run's scenario data as input");
+    QL_REQUIRE(!inputs_->storeSurvivalProbabilities(),
+               "XVA: incremental run does not support the storage of survival probabilities");
+
+    // the base run must have used the same simulation set up, otherwise the cubes can not be spliced
+
+    initCubeDepth();
+    QL_REQUIRE(baseCube->samples() == samples_, "XVA: incremental run, base cube samples ("
+                                                    << baseCube->samples() << ") do not match simulation samples ("
+                                                    << samples_ << ")");
+    QL_REQUIRE(baseCube->numDates() == grid_->valuationDates().size(),
+               "XVA: incremental run, base cube dates (" << baseCube->numDates()
+                                                          << ") do not match simulation valuation dates ("
+                                                          << grid_->valuationDates().size() << ")");
+    QL_REQUIRE(baseCube->depth() == cubeDepth_, "XVA: incremental run, base cube depth ("
+                                                    << baseCube->depth() << ") does not match required depth ("
+                                                    << cubeDepth_ << ")");
+
+    // classify the trades: trades in the base cube that are not amended are kept, trades in the base cube that are
+    // not in the portfolio are removed, all other trades of the portfolio (new or amended) are simulated
+
+    keptTradeIds_.clear();
+    removedTradeIds_.clear();
+
+    const std::set<std::string>& amendedTradeIds = inputs_->incrementalXvaTradeIds();
+    boost::shared_ptr<Portfolio> portfolio = inputs_->portfolio();
+
+    for (auto const& [tradeId, ignored] : baseCube->idsAndIndexes()) {
+        if (!portfolio->has(tradeId))
+            removedTradeIds_.insert(tradeId);
+        else if (amendedTradeIds.find(tradeId) == amendedTradeIds.end())
+            keptTradeIds_.insert(tradeId);
+    }
+
+    for (auto const& tradeId : amendedTradeIds) {
+        if (!portfolio->has(tradeId))
+            WLOG("XVA: incremental run, amended trade " << tradeId << " not in portfolio, ignore it");
+    }
+
+    auto simulationPortfolio = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    for (auto const& [tradeId, trade] : portfolio->trades()) {
+        if (keptTradeIds_.find(tradeId) == keptTradeIds_.end())
+            simulationPortfolio->add(trade);
+    }
+
+    LOG("XVA: incremental run, base cube trades " << baseCube->numIds() << ", kept " << keptTradeIds_.size()
+                                                  << ", removed " << removedTradeIds_.size() << ", simulated "
+                                                  << simulationPortfolio->size());
+
+    LOG("XVA: initIncrementalRun completed");
+
+    return simulationPortfolio;
+}
+
+void XvaAnalyticImpl::spliceIncrementalCube(boost::shared_ptr<Portfolio>& portfolio) {
+
+    LOG("XVA: spliceIncrementalCube");
+
+    // the post processing uses the base run's scenario data, which is consistent with the base cube
+
+    scenarioData_.linkTo(inputs_->mktCube());
+
+    // the full cube consists of the kept trades' slices of the base cube and the cube of the simulated trades
+
+    std::vector<boost::shared_ptr<NPVCube>> cubes;
+    if (!keptTradeIds_.empty())
+        cubes.push_back(boost::make_shared<JointNPVCube>(std::vector<boost::shared_ptr<NPVCube>>{inputs_->cube()},
+                                                         keptTradeIds_));
+    if (cube_)
+        cubes.push_back(cube_);
+    QL_REQUIRE(!cubes.empty(), "XVA: incremental run, no trades left in kept and simulated trades");
+    fullCube_ = cubes.size() == 1 ? cubes.front() : boost::make_shared<JointNPVCube>(cubes);
+
+    /* The post processing runs over all netting sets, so that the reports cover the whole portfolio as in a full
+       run. The kept trades are therefore built for the post processing, too (it needs e.g. their maturities), only
+       their simulation is saved. Each trade is built with the engine factory that produced its slice of the base
+       cube, i.e. amc trades with the amc engine factory. Building does not trigger the amc calibration. */
+
+    auto keptClassicPortfolio = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    auto keptAmcPortfolio = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
+    for (auto const& tradeId : keptTradeIds_) {
+        auto trade = inputs_->portfolio()->get(tradeId);
+        if (inputs_->amc() && inputs_->amcTradeTypes().find(trade->tradeType()) != inputs_->amcTradeTypes().end())
+            keptAmcPortfolio->add(trade);
+        else
+            keptClassicPortfolio->add(trade);
+    }
+    Settings::instance().evaluationDate() = inputs_->asof();
+    if (!keptClassicPortfolio->trades().empty()) {
+        keptClassicPortfolio->reset();
+        keptClassicPortfolio->build(engineFactory(), "analytic/" + label());
+    }
+    if (!keptAmcPortfolio->trades().empty()) {
+        keptAmcPortfolio->reset();
+        keptAmcPortfolio->build(amcEngineFactory(model_, amcSimulationDates()), "analytic/" + label());
+    }
+
+    // the kept trades were built in the base run, dropping one now would silently understate the xva
+
+    for (auto const& tradeId : keptTradeIds_) {
+        QL_REQUIRE(keptClassicPortfolio->has(tradeId) || keptAmcPortfolio->has(tradeId),
+                   "XVA: incremental run, trade " << tradeId << " from the base cube failed to build, can not "
+                                                  << "include its base cube slice in the post processing");
+    }
+
+    Date maturityDate = inputs_->asof();
+    if (inputs_->portfolioFilterDate() != Null<Date>())
+        maturityDate = inputs_->portfolioFilterDate();
+    for (auto const& kept : {keptClassicPortfolio, keptAmcPortfolio}) {
+        kept->removeMatured(maturityDate);
+        for (const auto& [tradeId, trade] : kept->trades())
+            portfolio->add(trade);
+    }
+
+    // restrict the cube to the post processing portfolio, i.e. drop kept trades that matured
+
+    cube_ = boost::make_shared<JointNPVCube>(std::vector<boost::shared_ptr<NPVCube>>{fullCube_}, portfolio->ids());
+
+    LOG("XVA: spliceIncrementalCube completed, full cube trades " << fullCube_->numIds()
+                                                                  << ", post processing trades " << cube_->numIds());
+}
+
 void XvaAnalyticImpl::runPostProcessor() {
     boost::shared_ptr<NettingSetManager> netting = inputs_->nettingSetManager();
     map<string, bool> analytics;
@@ -579,7 +787,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         cvaSensiShiftSize, kvaCapitalDiscountRate, kvaAlpha, kvaRegAdjustment, kvaCapitalHurdle, kvaOurPdFloor,
         kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube_, flipViewBorrowingCurvePostfix,
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
-        inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(), withMporStickyDate, mporCashFlowMode);
+        inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(), withMporStickyDate, mporCashFlowMode,
+        inputs_->nThreads());
     LOG("post done");
 }
 
@@ -625,6 +834,11 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
         LOG("XVA: Attach Scenario Generator to ScenarioSimMarket");
         simMarket_->scenarioGenerator() = scenarioGenerator_;
 
+        // In an incremental run we only simulate new and amended trades, the other trades are taken from the base cube
+        boost::shared_ptr<Portfolio> portfolio = inputs_->portfolio();
+        if (inputs_->incrementalXva())
+            portfolio = initIncrementalRun();
+
         // We may have to build two cubes below for complementary sub-portfolios, a classical cube and an AMC cube
         bool doClassicRun = true;
         bool doAmcRun = false;
@@ -634,10 +848,10 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
 
         if (inputs_->amc()) {
             // Build a separate sub-portfolio for the AMC cube generation and perform its training
-            buildAmcPortfolio();
+            buildAmcPortfolio(portfolio);
 
             // Build the residual portfolio for the classic cube generation, i.e. strip out the AMC part
-            for (auto const& [tradeId, trade] : inputs_->portfolio()->trades()) {
+            for (auto const& [tradeId, trade] : portfolio->trades()) {
                 if (inputs_->amcTradeTypes().find(trade->tradeType()) == inputs_->amcTradeTypes().end())
                     residualPortfolio->add(trade);
             }
@@ -648,8 +862,11 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
             doAmcRun = !amcPortfolio_->trades().empty();
             doClassicRun = !residualPortfolio->trades().empty();
         } else {
-            for (const auto& [tradeId, trade] : inputs_->portfolio()->trades())
+            for (const auto& [tradeId, trade] : portfolio->trades())
                 residualPortfolio->add(trade);
+            // the simulated portfolio may be empty in an incremental run (e.g. if trades were only removed)
+            if (inputs_->incrementalXva())
+                doClassicRun = !residualPortfolio->trades().empty();
         }
 
         /********************************************************************************
@@ -657,15 +874,25 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
          * The bulk of the AMC work is done before in the AMC portfolio building/training
          ********************************************************************************/
 
-        if (doAmcRun)
-            amcRun(doClassicRun);
-        else
-            amcPortfolio_ = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
-        
-        if (doClassicRun)
-            classicPortfolio_ = classicRun(residualPortfolio);
-        else
-            classicPortfolio_ = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
+        boost::timer::cpu_timer cubeTimer;
+
+        if (doAmcRun && doClassicRun && inputs_->amcConcurrentRun()) {
+            concurrentRun(residualPortfolio);
+        } else {
+            if (doAmcRun)
+                amcRun(doClassicRun);
+            else
+                amcPortfolio_ = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
+
+            if (doClassicRun)
+                classicPortfolio_ = classicRun(residualPortfolio);
+            else
+                classicPortfolio_ = boost::make_shared<Portfolio>(inputs_->buildFailedTrades());
+        }
+
+        LOG("XVA: cube generation took " << cubeTimer.elapsed().wall / 1E9 << " sec, peak memory "
+                                         << os::getPeakMemoryUsage());
+        MEM_LOG;
 
         /***************************************************
          * We may have two cubes now that need to be merged
@@ -677,8 +904,10 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
         } else if (!doClassicRun && doAmcRun) {
             LOG("We have generated an AMC cube only");
             cube_ = amcCube_;
-        } else {
+        } else if (doClassicRun) {
             WLOG("We have generated a classic cube only");
+        } else {
+            WLOG("We have generated no cube");
         }
         
         LOG("NPV cube generation completed");
@@ -695,10 +924,18 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
         for (const auto& [tradeId, trade] : amcPortfolio_->trades())
             newPortfolio->add(trade);
         LOG("Total portfolio size " << newPortfolio->size());
-        if (newPortfolio->size() < inputs_->portfolio()->size()) {
-            ALOG("input portfolio size is " << inputs_->portfolio()->size() << 
+        if (newPortfolio->size() < portfolio->size()) {
+            ALOG("input portfolio size is " << portfolio->size() << 
                 ", but we have built only " << newPortfolio->size() << " trades");
         }
+
+        /******************************************************************
+         * In an incremental run we splice the base cube and the new cube
+         ******************************************************************/
+
+        if (inputs_->incrementalXva())
+            spliceIncrementalCube(newPortfolio);
+
         analytic()->setPortfolio(newPortfolio);
     } else { // runSimulation_
 
@@ -727,7 +964,7 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
 
     // Return the cubes to serialalize
     if (inputs_->writeCube()) {
-        analytic()->npvCubes()["XVA"]["cube"] = cube_;
+        analytic()->npvCubes()["XVA"]["cube"] = fullCube_ ? fullCube_ : cube_;
         analytic()->mktCubes()["XVA"]["scenariodata"] = *scenarioData_;
         if (nettingSetCube_) {
             analytic()->npvCubes()["XVA"]["nettingsetcube"] = nettingSetCube_;
@@ -47,14 +47,35 @@ protected:
     void initCubeDepth();
     void initCube(boost::shared_ptr<NPVCube>& cube, const std::set<std::string>& ids, Size cubeDepth);    
 
-    void initClassicRun(const boost::shared_ptr<Portfolio>& portfolio);
+    /* if concurrent is true, the cube depth and scenario data are expected to be initialised already and are not
+       touched, see concurrentRun() */
+    void initClassicRun(const boost::shared_ptr<Portfolio>& portfolio, bool concurrent = false);
     void buildClassicCube(const boost::shared_ptr<Portfolio>& portfolio);
-    boost::shared_ptr<Portfolio> classicRun(const boost::shared_ptr<Portfolio>& portfolio);
+    boost::shared_ptr<Portfolio> classicRun(const boost::shared_ptr<Portfolio>& portfolio, bool concurrent = false);
 
     boost::shared_ptr<EngineFactory> amcEngineFactory(const boost::shared_ptr<QuantExt::CrossAssetModel>& cam,
                                                       const std::vector<Date>& grid);
-    void buildAmcPortfolio();
-    void amcRun(bool doClassicRun);
+    // the simulation dates the amc engines are built for
+    std::vector<Date> amcSimulationDates();
+    void buildAmcPortfolio(const boost::shared_ptr<Portfolio>& portfolio);
+    /* if concurrent is true, the run is done in a thread separate from the classic run, in this case the amc cube is
+       always generated with the multi-threaded engine and the cube depth and scenario data are expected to be
+       initialised already, see concurrentRun() */
+    void amcRun(bool doClassicRun, bool concurrent = false);
+    // run the classic and amc cube generation concurrently
+    void concurrentRun(const boost::shared_ptr<Portfolio>& residualPortfolio);
+
+    // thread budgets for the classic and amc cube generation
+    Size classicThreads() const;
+    Size amcThreads() const;
+
+    /* incremental run: returns the sub-portfolio of new and amended trades to be simulated, the other trades are
+       taken from the base run's cube */
+    boost::shared_ptr<Portfolio> initIncrementalRun();
+    /* incremental run: splice the base run's cube and the cube of the simulated trades, add the kept trades to the
+       portfolio used for the post processing, which covers all netting sets; the kept trades are built with the
+       engine factory that produced their slice of the base cube, but not priced */
+    void spliceIncrementalCube(boost::shared_ptr<Portfolio>& portfolio);
 
     void runPostProcessor();
 
@@ -66,6 +87,10 @@ protected:
     boost::shared_ptr<ScenarioGenerator> scenarioGenerator_;
     boost::shared_ptr<Portfolio> amcPortfolio_, classicPortfolio_;
     boost::shared_ptr<NPVCube> cube_, nettingSetCube_, cptyCube_, amcCube_;
+    // incremental run: the full spliced cube, cube_ is restricted to the trades of the post processing portfolio
+    boost::shared_ptr<NPVCube> fullCube_;
+    // incremental run: base run trades that are kept resp. removed
+    std::set<std::string> keptTradeIds_, removedTradeIds_;
     QuantLib::RelinkableHandle<AggregationScenarioData> scenarioData_;
     boost::shared_ptr<CubeInterpretation> cubeInterpreter_;
     boost::shared_ptr<DynamicInitialMarginCalculator> dimCalculator_;
@@ -289,6 +289,12 @@ void InputParameters::setMarketCubeFromFile(const std::string& file) {
     mktCube_ = loadAggregationScenarioData(file);
 }
 
+void InputParameters::setIncrementalXvaTradeIds(const std::string& s) {
+    // parse to set<string>
+    auto v = parseListOfValues(s);
+    incrementalXvaTradeIds_ = std::set<std::string>(v.begin(), v.end());
+}
+
 void InputParameters::setVarQuantiles(const std::string& s) {
     // parse to vector<Real>
     varQuantiles_ = parseListOfValues<Real>(s, &parseReal);
@@ -118,6 +118,8 @@ public:
     void setParSensi(bool b) { parSensi_ = b; }
     void setAlignPillars(bool b) { alignPillars_ = b; }
     void setOutputJacobi(bool b) { outputJacobi_ = b; }
+    void setParSensiCacheFile(const std::string& s) { parSensiCacheFile_ = s; }
+    void setParSensiCacheMaxStaleness(Size n) { parSensiCacheMaxStaleness_ = n; }
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
     void setSensiSimMarketParams(const std::string& xml);
@@ -160,6 +162,11 @@ public:
     void setSalvageCorrelationMatrix(bool b) { salvageCorrelationMatrix_ = b; }
     void setAmc(bool b) { amc_ = b; }
     void setAmcTradeTypes(const std::string& s); // parse to set<string>
+    void setAmcMaxPathMemory(Size megaBytes) { amcMaxPathMemory_ = megaBytes; }
+    void setAmcRegressionCache(bool b) { amcRegressionCache_ = b; }
+    void setAmcConcurrentRun(bool b) { amcConcurrentRun_ = b; }
+    void setAmcThreads(Size n) { amcThreads_ = n; }
+    void setClassicThreads(Size n) { classicThreads_ = n; }
     void setExposureBaseCurrency(const std::string& s) { exposureBaseCurrency_ = s; } 
     void setExposureObservationModel(const std::string& s) { exposureObservationModel_ = s; }
     void setNettingSetId(const std::string& s) { nettingSetId_ = s; }
@@ -195,12 +202,14 @@ public:
     // Setters for xva
     void setXvaBaseCurrency(const std::string& s) { xvaBaseCurrency_ = s; }
     void setLoadCube(bool b) { loadCube_ = b; }
-    // TODO: API for setting NPV and market cubes
+    void setCube(const boost::shared_ptr<NPVCube>& cube) { cube_ = cube; }
+    void setMarketCube(const boost::shared_ptr<AggregationScenarioData>& mktCube) { mktCube_ = mktCube; }
     void setCubeFromFile(const std::string& file);
     void setNettingSetCubeFromFile(const std::string& file);
     void setCptyCubeFromFile(const std::string& file);
     void setMarketCubeFromFile(const std::string& file);
-    // boost::shared_ptr<AggregationScenarioData> mktCube();
+    void setIncrementalXva(bool b) { incrementalXva_ = b; }
+    void setIncrementalXvaTradeIds(const std::string& s); // parse to set<string>
     void setFlipViewXVA(bool b) { flipViewXVA_ = b; }
     void setFullInitialCollateralisation(bool b) { fullInitialCollateralisation_ = b; }
     void setExposureProfiles(bool b) { exposureProfiles_ = b; }
@@ -392,6 +401,8 @@ public:
     bool parSensi() const { return parSensi_; };
     bool alignPillars() const { return alignPillars_; };
     bool outputJacobi() const { return outputJacobi_; };
+    const std::string& parSensiCacheFile() const { return parSensiCacheFile_; }
+    Size parSensiCacheMaxStaleness() const { return parSensiCacheMaxStaleness_; }
     bool useSensiSpreadedTermStructures() { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
     const boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& sensiSimMarketParams() { return sensiSimMarketParams_; }
@@ -426,6 +437,12 @@ public:
     bool salvageCorrelationMatrix() { return salvageCorrelationMatrix_; }
     bool amc() { return amc_; }
     const std::set<std::string>& amcTradeTypes() { return amcTradeTypes_; }
+    Size amcMaxPathMemory() const { return amcMaxPathMemory_; }
+    bool amcRegressionCache() const { return amcRegressionCache_; }
+    bool amcConcurrentRun() const { return amcConcurrentRun_; }
+    // thread budgets of the amc and classic cube generation, 0 means nThreads
+    Size amcThreads() const { return amcThreads_; }
+    Size classicThreads() const { return classicThreads_; }
     const std::string& exposureBaseCurrency() { return exposureBaseCurrency_; }
     const std::string& exposureObservationModel() { return exposureObservationModel_; }
     const std::string& nettingSetId() { return nettingSetId_; }
@@ -453,6 +470,8 @@ public:
     const boost::shared_ptr<NPVCube>& nettingSetCube() { return nettingSetCube_; }
     const boost::shared_ptr<NPVCube>& cptyCube() { return cptyCube_; }
     const boost::shared_ptr<AggregationScenarioData>& mktCube() { return mktCube_; }
+    bool incrementalXva() { return incrementalXva_; }
+    const std::set<std::string>& incrementalXvaTradeIds() { return incrementalXvaTradeIds_; }
     bool flipViewXVA() { return flipViewXVA_; }
     bool fullInitialCollateralisation() { return fullInitialCollateralisation_; }
     bool exposureProfiles() { return exposureProfiles_; }
@@ -647,6 +666,8 @@ protected:
     bool parSensi_ = false;
     bool outputJacobi_ = false;
     bool alignPillars_ = false;
+    std::string parSensiCacheFile_;
+    Size parSensiCacheMaxStaleness_ = 0;
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
     boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters> sensiSimMarketParams_;
@@ -682,6 +703,10 @@ protected:
     bool salvageCorrelationMatrix_ = false;
     bool amc_ = false;
     std::set<std::string> amcTradeTypes_;
+    Size amcMaxPathMemory_ = 0;
+    bool amcRegressionCache_ = false;
+    bool amcConcurrentRun_ = false;
+    Size amcThreads_ = 0, classicThreads_ = 0;
     std::string exposureBaseCurrency_ = "";
     std::string exposureObservationModel_ = "Disable";
     std::string nettingSetId_ = "";
@@ -713,6 +738,9 @@ protected:
      **************/
     std::string xvaBaseCurrency_ = "";
     bool loadCube_ = false;
+    // incremental run on top of the base run's cube and scenario data, with the ids of amended trades
+    bool incrementalXva_ = false;
+    std::set<std::string> incrementalXvaTradeIds_;
     bool flipViewXVA_ = false;
     bool exerciseNextBreak_ = false;
     bool cvaAnalytic_ = true;
@@ -702,6 +702,14 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         if (tmp != "")
             inputs->setOutputJacobi(parseBool(tmp));
 
+        tmp = params_->get("sensitivity", "parSensitivityCacheFile", false);
+        if (tmp != "")
+            inputs->setParSensiCacheFile(outputPath + "/" + tmp);
+
+        tmp = params_->get("sensitivity", "parSensitivityCacheMaxStaleness", false);
+        if (tmp != "")
+            inputs->setParSensiCacheMaxStaleness(parseInteger(tmp));
+
         tmp = params_->get("sensitivity", "alignPillars", false);
         if (tmp != "")
             inputs->setAlignPillars(parseBool(tmp));
@@ -901,6 +909,26 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
     if (tmp != "")
         inputs->setAmcTradeTypes(tmp);
 
+    tmp = params_->get("simulation", "amcMaxPathMemory", false);
+    if (tmp != "")
+        inputs->setAmcMaxPathMemory(parseInteger(tmp));
+
+    tmp = params_->get("simulation", "amcRegressionCache", false);
+    if (tmp != "")
+        inputs->setAmcRegressionCache(parseBool(tmp));
+
+    tmp = params_->get("simulation", "amcConcurrentRun", false);
+    if (tmp != "")
+        inputs->setAmcConcurrentRun(parseBool(tmp));
+
+    tmp = params_->get("simulation", "amcThreads", false);
+    if (tmp != "")
+        inputs->setAmcThreads(parseInteger(tmp));
+
+    tmp = params_->get("simulation", "classicThreads", false);
+    if (tmp != "")
+        inputs->setClassicThreads(parseInteger(tmp));
+
     inputs->setSimulationPricingEngine(inputs->pricingEngine());
     inputs->setExposureObservationModel(inputs->observationModel());
     inputs->setExposureBaseCurrency(inputs->baseCurrency());
@@ -987,8 +1015,17 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
     else
         inputs->setXvaBaseCurrency(inputs->exposureBaseCurrency());
 
+    tmp = params_->get("xva", "incremental", false);
+    if (tmp != "")
+        inputs->setIncrementalXva(parseBool(tmp));
+
+    tmp = params_->get("xva", "incrementalTradeIds", false);
+    if (tmp != "")
+        inputs->setIncrementalXvaTradeIds(tmp);
+
+    // the incremental run reprices the changed trades and loads the base run's cube for all other trades
     if (inputs->analytics().find("XVA") != inputs->analytics().end() &&
-        inputs->analytics().find("EXPOSURE") == inputs->analytics().end()) {
+        (inputs->analytics().find("EXPOSURE") == inputs->analytics().end() || inputs->incrementalXva())) {
         inputs->setLoadCube(true);
         tmp = params_->get("xva", "cubeFile", false);
         if (tmp != "") {
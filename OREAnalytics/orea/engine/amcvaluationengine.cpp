@@ -30,6 +30,7 @@
 
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/instruments/payment.hpp>
+#include <qle/math/randomvariableregressioncache.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
@@ -142,7 +143,8 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
                    const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
                    const std::vector<string>& aggDataIndices, const std::vector<string>& aggDataCurrencies,
                    const Size aggDataNumberCreditStates, boost::shared_ptr<ore::analytics::AggregationScenarioData> asd,
-                   boost::shared_ptr<NPVCube> outputCube, boost::shared_ptr<ProgressIndicator> progressIndicator) {
+                   boost::shared_ptr<NPVCube> outputCube, boost::shared_ptr<ProgressIndicator> progressIndicator,
+                   const Size maxPathMemory, const bool useRegressionCache) {
 
     progressIndicator->updateProgress(0, portfolio->size() + 1);
 
@@ -222,6 +224,20 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     McEngineStats::instance().calc_timer.start();
     McEngineStats::instance().calc_timer.stop();
 
+    /* if requested, enable the regression cache for the calibration of the amc engines, so that trades sharing
+       calibration paths reuse the factorised regression design matrices; the cache is disabled and cleared when we
+       leave this scope */
+    struct RegressionCacheGuard {
+        explicit RegressionCacheGuard(const bool enable) : enabled(enable) {
+            if (enabled)
+                RandomVariableRegressionCache::instance().enable();
+        }
+        ~RegressionCacheGuard() {
+            if (enabled)
+                RandomVariableRegressionCache::instance().disable();
+        }
+        const bool enabled;
+    } regressionCacheGuard(useRegressionCache);
 
     auto extractAmcCalculator = [&amcCalculators, &tradeId, &tradeLabel, &tradeType, &effectiveMultiplier,
                                  &currencyIndex, &tradeFees, &model,
@@ -305,16 +321,6 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     calibrationTime += timer.elapsed().wall * 1e-9;
     LOG("Extracted " << amcCalculators.size() << " AMCCalculators for " << portfolio->size() << " source trades");
 
-    // set up buffers for fx rates and ir states that we need below for the runs against interface 1 and 2
-    // we set these buffers up on the full grid (i.e. valuation + close-out dates, also including the T0 date)
-
-    std::vector<std::vector<std::vector<Real>>> fxBuffer(
-        model->components(CrossAssetModel::AssetType::FX),
-        std::vector<std::vector<Real>>(sgd->getGrid()->dates().size() + 1, std::vector<Real>(outputCube->samples())));
-    std::vector<std::vector<std::vector<Real>>> irStateBuffer(
-        model->components(CrossAssetModel::AssetType::IR),
-        std::vector<std::vector<Real>>(sgd->getGrid()->dates().size() + 1, std::vector<Real>(outputCube->samples())));
-
     // set up cache for paths
 
     auto process = model->stateProcess();
@@ -324,209 +330,263 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     Size nStates = process->size();
     QL_REQUIRE(sgd->getGrid()->timeGrid().size() > 0, "AMCValuationEngine: empty time grid given");
     std::vector<Real> pathTimes(std::next(sgd->getGrid()->timeGrid().begin(), 1), sgd->getGrid()->timeGrid().end());
-    std::vector<std::vector<RandomVariable>> paths(
-        pathTimes.size(), std::vector<RandomVariable>(nStates, RandomVariable(outputCube->samples())));
 
-    // fill fx buffer, ir state buffer and write ASD
+    /* determine the number of samples for which we store paths at the same time, if a memory limit is given the
+       paths are generated and processed in blocks of samples that fit into this limit. Per sample we store
+       - the path states on the path times
+       - the fx rates and ir states on the full grid (i.e. valuation + close-out dates, also including the T0 date)
+       - the results of one amc calculator, i.e. at most two simulation results and the fee contributions on the
+         path times and T0 */
+
+    Size samples = outputCube->samples();
+    Size nFx = model->components(CrossAssetModel::AssetType::FX);
+    Size nIr = model->components(CrossAssetModel::AssetType::IR);
+    Size bytesPerSample =
+        std::max<Size>((pathTimes.size() * nStates + (nFx + nIr) * sgd->getGrid()->timeGrid().size() +
+                        3 * sgd->getGrid()->timeGrid().size()) *
+                           sizeof(Real),
+                       1);
+    Size blockSize = samples;
+    if (maxPathMemory > 0)
+        blockSize = std::max<Size>(std::min<Size>(maxPathMemory * 1024 * 1024 / bytesPerSample, samples), 1);
+    Size nBlocks = (samples + blockSize - 1) / blockSize;
+    LOG("Path storage: " << blockSize << " samples per block, " << nBlocks << " block(s), peak allocation "
+                         << static_cast<Real>(blockSize * bytesPerSample) / 1024.0 / 1024.0
+                         << " MB for paths, fx / ir state buffers and results (memory limit "
+                         << (maxPathMemory > 0 ? std::to_string(maxPathMemory) + " MB)" : "none)"));
+
+    // set up the path generator, this is used for all blocks
 
     auto pathGenerator = makeMultiPathGenerator(sgd->sequenceType(), process, sgd->getGrid()->timeGrid(), sgd->seed(),
                                                 sgd->ordering(), sgd->directionIntegers());
 
-    LOG("Write ASD, fill internal fx and irState buffers...");
+    // set up vectors indicating valuation times, close-out times and all times
 
-    for (Size i = 0; i < outputCube->samples(); ++i) {
-        timer.start();
-        const auto& path = pathGenerator->next().value;
-        timer.stop();
-        pathGenTime += timer.elapsed().wall * 1e-9;
+    std::vector<bool> allTimes(pathTimes.size(), true);
+    std::vector<bool> valuationTimes(pathTimes.size()), closeOutTimes(pathTimes.size());
+    for (Size i = 0; i < pathTimes.size(); ++i) {
+        valuationTimes[i] = sgd->getGrid()->isValuationDate()[i];
+        closeOutTimes[i] = sgd->getGrid()->isCloseOutDate()[i];
+    }
 
-        // populate fx and ir state buffers, populate cached paths for interface 2
+    // loop over the sample blocks, generate the paths for each block and run the amc calculators on them
 
-        timer.start();
-        for (Size k = 0; k < fxBuffer.size(); ++k) {
-            for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
-                fxBuffer[k][j][i] = std::exp(path[model->pIdx(CrossAssetModel::AssetType::FX, k)][j]);
-            }
-        }
-        for (Size k = 0; k < irStateBuffer.size(); ++k) {
-            for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
-                irStateBuffer[k][j][i] = path[model->pIdx(CrossAssetModel::AssetType::IR, k)][j];
-            }
-        }
+    LOG("Write ASD, fill internal fx and irState buffers and run simulation...");
 
-        for (Size k = 0; k < nStates; ++k) {
-            for (Size j = 0; j < pathTimes.size(); ++j) {
-                paths[j][k].set(i, path[k][j + 1]);
-            }
-        }
-        timer.stop();
-        bufferTime += timer.elapsed().wall * 1e-9;
+    // buffers for the paths, fx rates and ir states of one block of samples, indexed by the sample within the block
 
-        // write aggregation scenario data, TODO this seems relatively slow, can we speed it up using LgmVectorised
+    std::vector<std::vector<RandomVariable>> paths;
+    std::vector<std::vector<std::vector<Real>>> fxBuffer, irStateBuffer;
+    Size pathsSamples = 0;
 
-        if (asd != nullptr) {
-            timer.start();
-            Size dateIndex = 0;
-            for (Size k = 1; k < sgd->getGrid()->timeGrid().size(); ++k) {
-                // only write asd on valuation dates
-                if (!sgd->getGrid()->isValuationDate()[k - 1])
-                    continue;
-                // set numeraire
-                asd->set(dateIndex, i, model->numeraire(0, path[0].time(k), path[0][k]),
-                         AggregationScenarioDataType::Numeraire);
-                // set fx spots
-                for (Size j = 0; j < asdCurrencyIndex.size(); ++j) {
-                    asd->set(dateIndex, i, fx(fxBuffer, asdCurrencyIndex[j], k, i), AggregationScenarioDataType::FXSpot,
-                             asdCurrencyCode[j]);
-                }
-                // set index fixings
-                Date d = sgd->getGrid()->dates()[k - 1];
-                for (Size j = 0; j < asdIndex.size(); ++j) {
-                    asdIndexCurve[j]->move(d, state(irStateBuffer, asdIndexIndex[j], k, i));
-                    auto index = asdIndex[j];
-                    if (auto fb = boost::dynamic_pointer_cast<FallbackIborIndex>(asdIndex[j])) {
-                        // proxy fallback ibor index by its rfr index's fixing
-                        index = fb->rfrIndex();
-                    }
-                    asd->set(dateIndex, i, index->fixing(index->fixingCalendar().adjust(d)),
-                             AggregationScenarioDataType::IndexFixing, asdIndexName[j]);
-                }
-                // set credit states
-                for (Size j = 0; j < aggDataNumberCreditStates; ++j) {
-                    asd->set(dateIndex, i, path[model->pIdx(CrossAssetModel::AssetType::CrState, j)][k],
-                             AggregationScenarioDataType::CreditState, std::to_string(j));
-                }
-                ++dateIndex;
-            }
-            timer.stop();
-            asdTime += timer.elapsed().wall * 1e-9;
+    for (Size blockStart = 0; blockStart < samples; blockStart += blockSize) {
+
+        Size nb = std::min(blockSize, samples - blockStart);
+        if (pathsSamples != nb) {
+            paths = std::vector<std::vector<RandomVariable>>(pathTimes.size(),
+                                                             std::vector<RandomVariable>(nStates, RandomVariable(nb)));
+            fxBuffer = std::vector<std::vector<std::vector<Real>>>(
+                nFx, std::vector<std::vector<Real>>(sgd->getGrid()->timeGrid().size(), std::vector<Real>(nb)));
+            irStateBuffer = std::vector<std::vector<std::vector<Real>>>(
+                nIr, std::vector<std::vector<Real>>(sgd->getGrid()->timeGrid().size(), std::vector<Real>(nb)));
+            pathsSamples = nb;
         }
-    }
 
-    // Run AmcCalculators
+        // t0 results are averaged over the blocks
 
-    LOG("Run simulation...");
+        Real blockWeight = static_cast<Real>(nb) / static_cast<Real>(samples);
 
-    // set up vectors indicating valuation times, close-out times and all times
+        // fill fx buffer, ir state buffer and write ASD
 
-    std::vector<bool> allTimes(pathTimes.size(), true);
-    std::vector<bool> valuationTimes(pathTimes.size()), closeOutTimes(pathTimes.size());
-    for (Size i = 0; i < pathTimes.size(); ++i) {
-        valuationTimes[i] = sgd->getGrid()->isValuationDate()[i];
-        closeOutTimes[i] = sgd->getGrid()->isCloseOutDate()[i];
-    }
+        for (Size i = 0; i < nb; ++i) {
+            Size g = blockStart + i; // global sample index
+            timer.start();
+            const auto& path = pathGenerator->next().value;
+            timer.stop();
+            pathGenTime += timer.elapsed().wall * 1e-9;
 
-    // loop over amc calculators, get result and populate cube
+            // populate fx and ir state buffers, populate cached paths for interface 2
 
-    timer.start();
-    for (Size j = 0; j < amcCalculators.size(); ++j) {
-        auto resFee = feeContributions(j, sgd, model->irModel(0)->termStructure()->referenceDate(),
-                                       outputCube->samples(), tradeFees, model, fxBuffer, irStateBuffer);
-
-        if (!sgd->withCloseOutLag()) {
-            // no close-out lag, fill depth 0 with npv on path
-            auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, allTimes, false, tradeLabel[j],
-                                              tradeType[j]);
-            Real v = outputCube->getT0(tradeId[j], 0);
-            outputCube->setT0(v + res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
-                                      numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
-                                      effectiveMultiplier[j] +
-                                  resFee[0][0],
-                              tradeId[j], 0);
-            for (Size k = 1; k < res.size(); ++k) {
-                Real t = sgd->getGrid()->timeGrid()[k];
-                for (Size i = 0; i < outputCube->samples(); ++i) {
-                    Real v = outputCube->get(tradeId[j], k - 1, i, 0);
-                    outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
-                                            numRatio(model, irStateBuffer, currencyIndex[j], k, t, i) *
-                                            effectiveMultiplier[j] +
-                                        resFee[k][i],
-                                    tradeId[j], k - 1, i, 0);
+            timer.start();
+            for (Size k = 0; k < fxBuffer.size(); ++k) {
+                for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
+                    fxBuffer[k][j][i] = std::exp(path[model->pIdx(CrossAssetModel::AssetType::FX, k)][j]);
                 }
             }
-        } else {
-            // with close-out lag, fill depth 0 with valuation date npvs, depth 1 with (inflated) close-out npvs
-            if (sgd->withMporStickyDate()) {
-                // sticky date mpor mode. simulate the valuation times...
-                auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, valuationTimes, false,
-                                                  tradeLabel[j], tradeType[j]);
-                // ... and then the close-out times, but times moved to the valuation times
-                auto resLag = simulatePathInterface2(amcCalculators[j], pathTimes, paths, closeOutTimes, true,
-                                                     tradeLabel[j], tradeType[j]);
-                Real v = outputCube->getT0(tradeId[j], 0);
-                outputCube->setT0(v + res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
-                                          numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
-                                          effectiveMultiplier[j] +
-                                      resFee[0][0],
-                                  tradeId[j], 0);
-                int dateIndex = -1;
-                for (Size k = 0; k < sgd->getGrid()->dates().size(); ++k) {
-                    Real t = sgd->getGrid()->timeGrid()[k + 1];
-                    Real tm = sgd->getGrid()->timeGrid()[k];
-                    if (sgd->getGrid()->isCloseOutDate()[k]) {
-                        QL_REQUIRE(dateIndex >= 0, "first date in grid must be a valuation date");
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 1);
-                            outputCube->set(v + resLag[dateIndex + 1][i] * fx(fxBuffer, currencyIndex[j], k + 1, i) *
-                                                    num(model, irStateBuffer, currencyIndex[j], k + 1, tm, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[dateIndex + 1][i],
-                                            tradeId[j], dateIndex, i, 1);
-                        }
+            for (Size k = 0; k < irStateBuffer.size(); ++k) {
+                for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
+                    irStateBuffer[k][j][i] = path[model->pIdx(CrossAssetModel::AssetType::IR, k)][j];
+                }
+            }
+
+            for (Size k = 0; k < nStates; ++k) {
+                for (Size j = 0; j < pathTimes.size(); ++j) {
+                    paths[j][k].set(i, path[k][j + 1]);
+                }
+            }
+            timer.stop();
+            bufferTime += timer.elapsed().wall * 1e-9;
+
+            // write aggregation scenario data, TODO this seems relatively slow, can we speed it up using LgmVectorised
+
+            if (asd != nullptr) {
+                timer.start();
+                Size dateIndex = 0;
+                for (Size k = 1; k < sgd->getGrid()->timeGrid().size(); ++k) {
+                    // only write asd on valuation dates
+                    if (!sgd->getGrid()->isValuationDate()[k - 1])
+                        continue;
+                    // set numeraire
+                    asd->set(dateIndex, g, model->numeraire(0, path[0].time(k), path[0][k]),
+                             AggregationScenarioDataType::Numeraire);
+                    // set fx spots
+                    for (Size j = 0; j < asdCurrencyIndex.size(); ++j) {
+                        asd->set(dateIndex, g, fx(fxBuffer, asdCurrencyIndex[j], k, i),
+                                 AggregationScenarioDataType::FXSpot, asdCurrencyCode[j]);
                     }
-                    if (sgd->getGrid()->isValuationDate()[k]) {
-                        ++dateIndex;
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 1);
-                            outputCube->set(v + res[dateIndex + 1][i] * fx(fxBuffer, currencyIndex[j], k + 1, i) *
-                                                    numRatio(model, irStateBuffer, currencyIndex[j], k + 1, t, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[dateIndex + 1][i],
-                                            tradeId[j], dateIndex, i, 0);
+                    // set index fixings
+                    Date d = sgd->getGrid()->dates()[k - 1];
+                    for (Size j = 0; j < asdIndex.size(); ++j) {
+                        asdIndexCurve[j]->move(d, state(irStateBuffer, asdIndexIndex[j], k, i));
+                        auto index = asdIndex[j];
+                        if (auto fb = boost::dynamic_pointer_cast<FallbackIborIndex>(asdIndex[j])) {
+                            // proxy fallback ibor index by its rfr index's fixing
+                            index = fb->rfrIndex();
                         }
+                        asd->set(dateIndex, g, index->fixing(index->fixingCalendar().adjust(d)),
+                                 AggregationScenarioDataType::IndexFixing, asdIndexName[j]);
                     }
+                    // set credit states
+                    for (Size j = 0; j < aggDataNumberCreditStates; ++j) {
+                        asd->set(dateIndex, g, path[model->pIdx(CrossAssetModel::AssetType::CrState, j)][k],
+                                 AggregationScenarioDataType::CreditState, std::to_string(j));
+                    }
+                    ++dateIndex;
                 }
-            } else {
-                // actual date mpor mode: simulate all times in one go
+                timer.stop();
+                asdTime += timer.elapsed().wall * 1e-9;
+            }
+        }
+
+        // run the amc calculators on the block, get result and populate cube
+
+        timer.start();
+        for (Size j = 0; j < amcCalculators.size(); ++j) {
+            auto resFee = feeContributions(j, sgd, model->irModel(0)->termStructure()->referenceDate(), nb, tradeFees,
+                                           model, fxBuffer, irStateBuffer);
+
+            if (!sgd->withCloseOutLag()) {
+                // no close-out lag, fill depth 0 with npv on path
                 auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, allTimes, false, tradeLabel[j],
                                                   tradeType[j]);
                 Real v = outputCube->getT0(tradeId[j], 0);
-                outputCube->setT0(v + res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
-                                      numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
-                                      effectiveMultiplier[j],
+                outputCube->setT0(v + blockWeight * res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
+                                          numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
+                                          effectiveMultiplier[j] +
+                                      blockWeight * resFee[0][0],
                                   tradeId[j], 0);
-                int dateIndex = -1;
                 for (Size k = 1; k < res.size(); ++k) {
                     Real t = sgd->getGrid()->timeGrid()[k];
-                    if (sgd->getGrid()->isCloseOutDate()[k - 1]) {
-                        QL_REQUIRE(dateIndex >= 0, "first date in grid must be a valuation date");
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 1);
-                            outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
-                                                    num(model, irStateBuffer, currencyIndex[j], k, t, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[k][i],
-                                            tradeId[j], dateIndex, i, 1);
+                    for (Size i = 0; i < nb; ++i) {
+                        Size g = blockStart + i;
+                        Real v = outputCube->get(tradeId[j], k - 1, g, 0);
+                        outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
+                                                numRatio(model, irStateBuffer, currencyIndex[j], k, t, i) *
+                                                effectiveMultiplier[j] +
+                                            resFee[k][i],
+                                        tradeId[j], k - 1, g, 0);
+                    }
+                }
+            } else {
+                // with close-out lag, fill depth 0 with valuation date npvs, depth 1 with (inflated) close-out npvs
+                if (sgd->withMporStickyDate()) {
+                    // sticky date mpor mode. simulate the valuation times...
+                    auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, valuationTimes, false,
+                                                      tradeLabel[j], tradeType[j]);
+                    // ... and then the close-out times, but times moved to the valuation times
+                    auto resLag = simulatePathInterface2(amcCalculators[j], pathTimes, paths, closeOutTimes, true,
+                                                         tradeLabel[j], tradeType[j]);
+                    Real v = outputCube->getT0(tradeId[j], 0);
+                    outputCube->setT0(v + blockWeight * res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
+                                              numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
+                                              effectiveMultiplier[j] +
+                                          blockWeight * resFee[0][0],
+                                      tradeId[j], 0);
+                    int dateIndex = -1;
+                    for (Size k = 0; k < sgd->getGrid()->dates().size(); ++k) {
+                        Real t = sgd->getGrid()->timeGrid()[k + 1];
+                        Real tm = sgd->getGrid()->timeGrid()[k];
+                        if (sgd->getGrid()->isCloseOutDate()[k]) {
+                            QL_REQUIRE(dateIndex >= 0, "first date in grid must be a valuation date");
+                            for (Size i = 0; i < nb; ++i) {
+                                Size g = blockStart + i;
+                                Real v = outputCube->get(tradeId[j], dateIndex, g, 1);
+                                outputCube->set(v + resLag[dateIndex + 1][i] *
+                                                        fx(fxBuffer, currencyIndex[j], k + 1, i) *
+                                                        num(model, irStateBuffer, currencyIndex[j], k + 1, tm, i) *
+                                                        effectiveMultiplier[j] +
+                                                    resFee[dateIndex + 1][i],
+                                                tradeId[j], dateIndex, g, 1);
+                            }
+                        }
+                        if (sgd->getGrid()->isValuationDate()[k]) {
+                            ++dateIndex;
+                            for (Size i = 0; i < nb; ++i) {
+                                Size g = blockStart + i;
+                                Real v = outputCube->get(tradeId[j], dateIndex, g, 1);
+                                outputCube->set(v + res[dateIndex + 1][i] * fx(fxBuffer, currencyIndex[j], k + 1, i) *
+                                                        numRatio(model, irStateBuffer, currencyIndex[j], k + 1, t, i) *
+                                                        effectiveMultiplier[j] +
+                                                    resFee[dateIndex + 1][i],
+                                                tradeId[j], dateIndex, g, 0);
+                            }
                         }
                     }
-                    if (sgd->getGrid()->isValuationDate()[k - 1]) {
-                        ++dateIndex;
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 0);
-                            outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
-                                                    numRatio(model, irStateBuffer, currencyIndex[j], k, t, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[k][i],
-                                            tradeId[j], dateIndex, i, 0);
+                } else {
+                    // actual date mpor mode: simulate all times in one go
+                    auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, allTimes, false,
+                                                      tradeLabel[j], tradeType[j]);
+                    Real v = outputCube->getT0(tradeId[j], 0);
+                    outputCube->setT0(v + blockWeight * res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
+                                              numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
+                                              effectiveMultiplier[j],
+                                      tradeId[j], 0);
+                    int dateIndex = -1;
+                    for (Size k = 1; k < res.size(); ++k) {
+                        Real t = sgd->getGrid()->timeGrid()[k];
+                        if (sgd->getGrid()->isCloseOutDate()[k - 1]) {
+                            QL_REQUIRE(dateIndex >= 0, "first date in grid must be a valuation date");
+                            for (Size i = 0; i < nb; ++i) {
+                                Size g = blockStart + i;
+                                Real v = outputCube->get(tradeId[j], dateIndex, g, 1);
+                                outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
+                                                        num(model, irStateBuffer, currencyIndex[j], k, t, i) *
+                                                        effectiveMultiplier[j] +
+                                                    resFee[k][i],
+                                                tradeId[j], dateIndex, g, 1);
+                            }
+                        }
+                        if (sgd->getGrid()->isValuationDate()[k - 1]) {
+                            ++dateIndex;
+                            for (Size i = 0; i < nb; ++i) {
+                                Size g = blockStart + i;
+                                Real v = outputCube->get(tradeId[j], dateIndex, g, 0);
+                                outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
+                                                        numRatio(model, irStateBuffer, currencyIndex[j], k, t, i) *
+                                                        effectiveMultiplier[j] +
+                                                    resFee[k][i],
+                                                tradeId[j], dateIndex, g, 0);
+                            }
                         }
                     }
                 }
             }
+            if (blockStart + nb == samples)
+                progressIndicator->updateProgress(++progressCounter, portfolio->size() + 1);
         }
-        progressIndicator->updateProgress(++progressCounter, portfolio->size() + 1);
+        timer.stop();
+        valuationTime += timer.elapsed().wall * 1e-9;
     }
-    timer.stop();
-    valuationTime += timer.elapsed().wall * 1e-9;
 
     totalTime = timerTotal.elapsed().wall * 1e-9;
     residualTime = totalTime - (calibrationTime + pathGenTime + valuationTime + asdTime + bufferTime);
@@ -552,6 +612,12 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     LOG("MC Other Timer       : " << McEngineStats::instance().other_timer.elapsed().wall / 1E9 << " sec");
     LOG("MC Path Timer        : " << McEngineStats::instance().path_timer.elapsed().wall / 1E9 << " sec");
     LOG("MC Calc Timer        : " << McEngineStats::instance().calc_timer.elapsed().wall / 1E9 << " sec");
+    if (useRegressionCache) {
+        Size hits = RandomVariableRegressionCache::instance().hits();
+        Size misses = RandomVariableRegressionCache::instance().misses();
+        LOG("Regression Cache     : " << hits << " hits, " << misses << " misses, hit rate "
+                                      << (hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0) << " %");
+    }
 
 } // runCoreEngine()
 
@@ -646,7 +712,8 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<Portfolio>& portfolio
         // we can use the mt progress indicator here although we are running on a single thread
         runCoreEngine(portfolio, model_, market_, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
                       aggDataNumberCreditStates_, asd_, outputCube,
-                      boost::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators()));
+                      boost::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators()),
+                      maxPathMemory_, useRegressionCache_);
     } catch (const std::exception& e) {
         QL_FAIL("Error during amc val engine run: " << e.what());
     }
@@ -744,9 +811,14 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
 
     ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
 
+    // the memory limit for the path storage is shared between the threads
+
+    Size maxPathMemoryPerThread = maxPathMemory_ == 0 ? 0 : std::max<Size>(maxPathMemory_ / eff_nThreads, 1);
+
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, &portfoliosAsString, &loaders, &simDates, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, maxPathMemoryPerThread, &portfoliosAsString, &loaders, &simDates,
+                    &progressIndicator](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -794,7 +866,8 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
                 // run core engine code (asd is written for thread id 0 only)
 
                 runCoreEngine(portfolio, cam, initMarket, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
-                              aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr, miniCubes_[id], progressIndicator);
+                              aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr, miniCubes_[id], progressIndicator,
+                              maxPathMemoryPerThread, useRegressionCache_);
 
                 // return code 0 = ok
 
@@ -83,6 +83,15 @@ public:
     //! Get aggregation data
     const boost::shared_ptr<ore::analytics::AggregationScenarioData>& aggregationScenarioData() const { return asd_; }
 
+    /*! Set a limit (in MB) for the memory used to store the simulated paths, fx / ir state buffers and the results
+        of one trade, 0 means no limit. If these do not fit into the limit for all samples, the paths are generated
+        and processed in blocks of samples. In multi-threaded runs the limit is shared between the threads. */
+    void setMaxPathMemory(const Size megaBytes) { maxPathMemory_ = megaBytes; }
+
+    /*! Enable the cache for the factorised regression design matrices in the calibration of the amc engines, this
+        only pays off if trades share their calibration paths and regressors. Hit rates are logged. Default is off. */
+    void setUseRegressionCache(const bool b) { useRegressionCache_ = b; }
+
 private:
     // set / get via additional methods
     boost::shared_ptr<ore::analytics::AggregationScenarioData> asd_;
@@ -90,6 +99,12 @@ private:
     // running in single or multi threaded mode?
     bool useMultithreading_ = false;
 
+    // memory limit for path storage in MB, 0 = no limit
+    Size maxPathMemory_ = 0;
+
+    // use the regression cache in the amc engine calibration
+    bool useRegressionCache_ = false;
+
     // shared inputs
     const std::vector<string> aggDataIndices_, aggDataCurrencies_;
     const Size aggDataNumberCreditStates_;
@@ -23,6 +23,7 @@
 #include <orea/scenario/clonedscenariogenerator.hpp>
 
 #include <ored/marketdata/clonedloader.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/portfolio/enginefactory.hpp>
 #include <ored/portfolio/trade.hpp>
@@ -100,6 +101,10 @@ void MultiThreadedValuationEngine::setAggregationScenarioData(
     aggregationScenarioData_ = aggregationScenarioData;
 }
 
+void MultiThreadedValuationEngine::setUseMarketSnapshot(const bool useMarketSnapshot) {
+    useMarketSnapshot_ = useMarketSnapshot;
+}
+
 void MultiThreadedValuationEngine::buildCube(
     const boost::shared_ptr<ore::data::Portfolio>& portfolio,
     const std::function<std::vector<boost::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
@@ -124,9 +129,15 @@ void MultiThreadedValuationEngine::buildCube(
         "configuration '"
         << configuration_ << "'.");
 
+    // the init market records the bootstrapped curves in a snapshot which is reused in the worker threads
+
+    boost::shared_ptr<ore::data::MarketSnapshot> snapshot;
+    if (useMarketSnapshot_)
+        snapshot = boost::make_shared<ore::data::MarketSnapshot>(today_);
+
     boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<ore::data::TodaysMarket>(
         today_, todaysMarketParams_, loader_, curveConfigs_, true, true, true, referenceData_, false,
-        iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+        iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_, snapshot);
 
     auto engineFactory = boost::make_shared<ore::data::EngineFactory>(
         engineData_, initMarket,
@@ -152,6 +163,26 @@ void MultiThreadedValuationEngine::buildCube(
 
     QL_REQUIRE(eff_nThreads > 0, "effective threads are zero, this is not allowed.");
 
+    /* build a sim market against the init market once, so that all curves required by the sim markets in the worker
+       threads are bootstrapped here and added to the snapshot, then freeze the snapshot so that it can be shared
+       between the worker threads */
+
+    if (snapshot && eff_nThreads > 1) {
+        LOG("Build market snapshot for worker threads.");
+        try {
+            auto simMarket = boost::make_shared<ore::analytics::ScenarioSimMarket>(
+                initMarket, simMarketData_, configuration_, *curveConfigs_, *todaysMarketParams_, true,
+                useSpreadedTermStructures_, false, false, iborFallbackConfig_, handlePseudoCurrenciesSimMarket_);
+        } catch (const std::exception& e) {
+            // the worker threads will report the error, curves not in the snapshot are bootstrapped there
+            WLOG("Error while building market snapshot: " << e.what());
+        }
+    }
+    if (snapshot) {
+        snapshot->freeze();
+        LOG("Market snapshot contains " << snapshot->size() << " bootstrapped curves.");
+    }
+
     std::vector<boost::shared_ptr<ore::data::Portfolio>> portfolios;
     for (Size i = 0; i < eff_nThreads; ++i)
         portfolios.push_back(boost::make_shared<ore::data::Portfolio>());
@@ -260,8 +291,9 @@ void MultiThreadedValuationEngine::buildCube(
 
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfoliosAsString,
-                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, dryRun, &snapshot, &calculators, &cptyCalculators, mporStickyDate,
+                    &portfoliosAsString, &scenarioGenerators, &loaders, &workerPricingStats,
+                    &progressIndicator](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -277,7 +309,7 @@ void MultiThreadedValuationEngine::buildCube(
 
                 boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<ore::data::TodaysMarket>(
                     today_, todaysMarketParams_, loaders[id], curveConfigs_, true, true, true, referenceData_, false,
-                    iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+                    iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_, snapshot);
 
                 // build sim market
 
@@ -70,6 +70,10 @@ public:
     // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
     void setAggregationScenarioData(const boost::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
 
+    /* can be optionally called to switch off the market snapshot, i.e. to bootstrap all curves in each worker thread
+       instead of taking them from a snapshot built in the main thread (default: on) */
+    void setUseMarketSnapshot(const bool useMarketSnapshot);
+
     /* analoguous to buildCube() in the single-threaded engine, results are retrieved using below constructors
        if no cptyCalculators is given a function returning an empty vector of calculators will be returned */
     void
@@ -121,6 +125,7 @@ private:
     std::string context_;
 
     boost::shared_ptr<AggregationScenarioData> aggregationScenarioData_;
+    bool useMarketSnapshot_ = true;
 
     std::vector<boost::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
     std::vector<boost::shared_ptr<ore::analytics::NPVCube>> miniNettingSetCubes_;
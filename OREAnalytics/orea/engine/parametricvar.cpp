@@ -39,8 +39,8 @@ namespace ore {
 namespace analytics {   
 
 ParametricVarCalculator::ParametricVarParams::ParametricVarParams(const std::string& m, QuantLib::Size samp,
-                                                                  QuantLib::Size sd)
-    : method(parseParametricVarMethod(m)), samples(samp), seed(sd) {}
+                                                                  QuantLib::Size sd, QuantLib::Size thr)
+    : method(parseParametricVarMethod(m)), samples(samp), seed(sd), threads(std::max<QuantLib::Size>(thr, 1)) {}
 
 ParametricVarCalculator::ParametricVarParams::Method parseParametricVarMethod(const std::string& s) {
     static map<std::string, ParametricVarCalculator::ParametricVarParams::Method> m = {
@@ -116,8 +116,9 @@ QuantLib::Real ParametricVarCalculator::var(QuantLib::Real confidence, const boo
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
         QL_REQUIRE(parametricVarParams_.seed != Null<Size>(),
                     "ParametricVarCalculator::computeVar(): method MonteCarlo requires mcSamples");
-        return QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence, parametricVarParams_.samples,
-                                                        parametricVarParams_.seed, *covarianceSalvage_);
+        return QuantExt::deltaGammaVarMcDiagonal(omega_, delta, gamma, confidence, parametricVarParams_.samples,
+                                                 parametricVarParams_.seed, *covarianceSalvage_,
+                                                 parametricVarParams_.threads);
     } else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::CornishFisher)
         return QuantExt::deltaGammaVarCornishFisher(omega_, delta, gamma, confidence, *covarianceSalvage_);
     else if (parametricVarParams_.method == ParametricVarCalculator::ParametricVarParams::Method::Saddlepoint) {
@@ -127,8 +128,9 @@ QuantLib::Real ParametricVarCalculator::var(QuantLib::Real confidence, const boo
         } catch (const std::exception& e) {
             ALOG("Saddlepoint VaR computation exited with an error: " << e.what()
                                                                         << ", falling back on Monte-Carlo");
-            res = QuantExt::deltaGammaVarMc<PseudoRandom>(omega_, delta, gamma, confidence,
-                parametricVarParams_.samples, parametricVarParams_.seed, *covarianceSalvage_);
+            res = QuantExt::deltaGammaVarMcDiagonal(omega_, delta, gamma, confidence, parametricVarParams_.samples,
+                                                    parametricVarParams_.seed, *covarianceSalvage_,
+                                                    parametricVarParams_.threads);
         }        
         return res;
     } else
@@ -61,11 +61,14 @@ public:
         };
 
         ParametricVarParams() {};
-        ParametricVarParams(const std::string& m, QuantLib::Size samples, QuantLib::Size seed);
+        ParametricVarParams(const std::string& m, QuantLib::Size samples, QuantLib::Size seed,
+                            QuantLib::Size threads = 1);
 
         Method method = Method::Delta;
         QuantLib::Size samples = QuantLib::Null<QuantLib::Size>();
         QuantLib::Size seed = QuantLib::Null<QuantLib::Size>();
+        //! number of threads used by the MonteCarlo method
+        QuantLib::Size threads = 1;
     };
 
     ParametricVarCalculator(const ParametricVarParams& parametricVarParams, const QuantLib::Matrix& omega,
@@ -25,9 +25,11 @@
 #include <orea/scenario/simplescenariofactory.hpp>
 
 #include <ored/marketdata/inflationcurve.hpp>
+#include <ored/utilities/csvfilereader.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/marketdata.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <qle/indexes/inflationindexwrapper.hpp>
@@ -69,9 +71,12 @@
 #include <qle/instruments/fixedbmaswap.hpp>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/operation.hpp>
 
+#include <fstream>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -706,68 +711,63 @@ void writeSensitivity(const RiskFactorKey& a, const RiskFactorKey& b, const Real
     parSensi[std::make_pair(a, b)] = value;
     DLOG("ParInstrument Sensi " << a << " w.r.t. " << b << " " << setprecision(6) << value);
 }
-} // namespace
-
-void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shared_ptr<ScenarioSimMarket>& simMarket) {
-
-    LOG("Cache base scenario par rates and flat vols");
-
-    if (relevantRiskFactors_.empty()) {
-        DLOG("Relevant risk factors not provided");
-    } else {
-        DLOG("Relevant risk factors provided:");
-        for (auto const& rf : relevantRiskFactors_)
-            DLOG("Relevant risk factor " << rf);
-    }
 
-    // remove todays fixings from relevant indices for the scope of this method
-    struct TodaysFixingsRemover {
-        TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
-            Date today = Settings::instance().evaluationDate();
-            for (auto const& n : names) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(n);
-                if (t[today] != Null<Real>()) {
-                    DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
-                    savedFixings_.insert(std::make_pair(n, t[today]));
-                    t[today] = Null<Real>();
-                    IndexManager::instance().setHistory(n, t);
-                }
+// remove todays fixings from the given indices for the lifetime of an instance
+struct TodaysFixingsRemover {
+    TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
+        Date today = Settings::instance().evaluationDate();
+        for (auto const& n : names) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(n);
+            if (t[today] != Null<Real>()) {
+                DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
+                savedFixings_.insert(std::make_pair(n, t[today]));
+                t[today] = Null<Real>();
+                IndexManager::instance().setHistory(n, t);
             }
         }
-        ~TodaysFixingsRemover() {
-            for (auto const& p : savedFixings_) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
-                t[today_] = p.second;
-                IndexManager::instance().setHistory(p.first, t);
-                DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
-            }
+    }
+    ~TodaysFixingsRemover() {
+        for (auto const& p : savedFixings_) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
+            t[today_] = p.second;
+            IndexManager::instance().setHistory(p.first, t);
+            DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
         }
-        const Date today_;
-        std::set<std::pair<std::string, Real>> savedFixings_;
-    };
-    TodaysFixingsRemover fixingRemover(removeTodaysFixingIndices_);
+    }
+    const Date today_;
+    std::set<std::pair<std::string, Real>> savedFixings_;
+};
 
-    // We must have a ShiftScenarioGenerator
-    boost::shared_ptr<ScenarioGenerator> simMarketScenGen = simMarket->scenarioGenerator();
-    boost::shared_ptr<ShiftScenarioGenerator> scenarioGenerator = 
-        boost::dynamic_pointer_cast<ShiftScenarioGenerator>(simMarketScenGen);
-    
-    struct SimMarketResetter {
-        SimMarketResetter(boost::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {}
-        ~SimMarketResetter() { simMarket_->reset(); }
-        boost::shared_ptr<SimMarket> simMarket_;
-    } simMarketResetter(simMarket);
+// reset the sim market when an instance goes out of scope
+struct SimMarketResetter {
+    SimMarketResetter(boost::shared_ptr<SimMarket> simMarket) : simMarket_(simMarket) {}
+    ~SimMarketResetter() { simMarket_->reset(); }
+    boost::shared_ptr<SimMarket> simMarket_;
+};
 
-    simMarket->reset();
-    scenarioGenerator->reset();
-    simMarket->update(asof_);
+// log the keys that are only in one of the two sets
+void logKeyDifferences(const std::string& label, const std::set<RiskFactorKey>& cached,
+                       const std::set<RiskFactorKey>& current) {
+    std::set<RiskFactorKey> cachedOnly, currentOnly;
+    std::set_difference(cached.begin(), cached.end(), current.begin(), current.end(),
+                        std::inserter(cachedOnly, cachedOnly.begin()));
+    std::set_difference(current.begin(), current.end(), cached.begin(), cached.end(),
+                        std::inserter(currentOnly, currentOnly.begin()));
+    for (auto const& k : cachedOnly)
+        LOG(label << " key '" << k << "' is in the cache, but not in the current configuration");
+    for (auto const& k : currentOnly)
+        LOG(label << " key '" << k << "' is in the current configuration, but not in the cache");
+}
+} // namespace
+
+void ParSensitivityAnalysis::computeBaseParRatesAndShiftSizes(const boost::shared_ptr<ScenarioSimMarket>& simMarket,
+                                                              map<RiskFactorKey, Real>& parRatesBase,
+                                                              map<RiskFactorKey, Real>& parCapVols) {
 
     if (!relevantRiskFactors_.empty())
         augmentRelevantRiskFactors();
     createParInstruments(simMarket);
 
-    map<RiskFactorKey, Real> parRatesBase, parCapVols; // for both ir and yoy caps
-
     for (auto& p : parHelpers_) {
         try {
             Real parRate = impliedQuote(p.second);
@@ -822,6 +822,45 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
     }
 
     LOG("Caching base scenario par rates and float vols done.");
+}
+
+bool ParSensitivityAnalysis::isParRawScenario(const ShiftScenarioGenerator::ScenarioDescription& desc) const {
+    // use single "UP" shift scenarios only, use only scenarios relevant for par instruments,
+    // use relevant scenarios only, if specified
+    // ignore risk factor types that have been disabled
+    return desc.type() == ShiftScenarioGenerator::ScenarioDescription::Type::Up && isParType(desc.key1().keytype) &&
+           typesDisabled_.count(desc.key1().keytype) == 0 &&
+           (relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc.key1()) != relevantRiskFactors_.end());
+}
+
+void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shared_ptr<ScenarioSimMarket>& simMarket) {
+
+    LOG("Cache base scenario par rates and flat vols");
+
+    if (relevantRiskFactors_.empty()) {
+        DLOG("Relevant risk factors not provided");
+    } else {
+        DLOG("Relevant risk factors provided:");
+        for (auto const& rf : relevantRiskFactors_)
+            DLOG("Relevant risk factor " << rf);
+    }
+
+    // remove todays fixings from relevant indices for the scope of this method
+    TodaysFixingsRemover fixingRemover(removeTodaysFixingIndices_);
+
+    // We must have a ShiftScenarioGenerator
+    boost::shared_ptr<ScenarioGenerator> simMarketScenGen = simMarket->scenarioGenerator();
+    boost::shared_ptr<ShiftScenarioGenerator> scenarioGenerator = 
+        boost::dynamic_pointer_cast<ShiftScenarioGenerator>(simMarketScenGen);
+    
+    SimMarketResetter simMarketResetter(simMarket);
+
+    simMarket->reset();
+    scenarioGenerator->reset();
+    simMarket->update(asof_);
+
+    map<RiskFactorKey, Real> parRatesBase, parCapVols; // for both ir and yoy caps
+    computeBaseParRatesAndShiftSizes(simMarket, parRatesBase, parCapVols);
 
     /****************************************************************
      * Discount curve instrument fair rate sensitivity to zero shifts
@@ -858,12 +897,7 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
 
         simMarket->update(asof_);
 
-        // use single "UP" shift scenarios only, use only scenarios relevant for par instruments,
-        // use relevant scenarios only, if specified
-        // ignore risk factor types that have been disabled
-        if (desc[i].type() != ShiftScenarioGenerator::ScenarioDescription::Type::Up ||
-            !isParType(desc[i].key1().keytype) || typesDisabled_.count(desc[i].key1().keytype) == 1 ||
-            !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end()))
+        if (!isParRawScenario(desc[i]))
             continue;
 
         // Since we are not using ValuationEngine we need to manually perform the trade updates here
@@ -1011,6 +1045,11 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
 
     } // end of loop over samples
 
+    // remember the par and raw keys of the configuration, they identify the par sensitivities written to a cache
+
+    parKeys_ = parKeysCheck;
+    rawKeys_ = rawKeysCheck;
+
     // check for
     // a) par instruments which have no sensitivity to any of the risk factors
     // b) risk factors w.r.t. which no par instrument has a sensitivity
@@ -1105,6 +1144,116 @@ void ParSensitivityAnalysis::alignPillars() {
     LOG("Alignment of pillars done.");
 }
 
+void ParSensitivityAnalysis::writeParInstrumentSensitivities(const std::string& fileName) const {
+    LOG("Write par instrument sensitivities to '" << fileName << "'");
+    QL_REQUIRE(!parKeys_.empty(), "can not write par instrument sensitivities to '"
+                                      << fileName << "', they have not been computed");
+    std::ofstream file(fileName);
+    QL_REQUIRE(file.is_open(), "error opening file '" << fileName << "' to write par instrument sensitivities");
+    file << "#Type,Key1,Key2,Value\n";
+    file << "AsOf," << io::iso_date(asof_) << ",,\n";
+    file << std::setprecision(17);
+    for (auto const& k : parKeys_)
+        file << "ParKey,\"" << k << "\",,\n";
+    for (auto const& k : rawKeys_)
+        file << "RawKey,\"" << k << "\",,\n";
+    for (auto const& p : parSensi_)
+        file << "ParSensitivity,\"" << p.first.first << "\",\"" << p.first.second << "\"," << p.second << "\n";
+    file.close();
+    QL_REQUIRE(!file.fail(), "error writing par instrument sensitivities to '" << fileName << "'");
+    LOG("Wrote " << parSensi_.size() << " par instrument sensitivities for " << parKeys_.size() << " par keys and "
+                 << rawKeys_.size() << " raw keys");
+}
+
+bool ParSensitivityAnalysis::readParInstrumentSensitivities(const std::string& fileName, const Size maxStaleness,
+                                                           const boost::shared_ptr<ScenarioSimMarket>& simMarket) {
+    LOG("Read par instrument sensitivities from '" << fileName << "'");
+    if (!std::ifstream(fileName).good()) {
+        LOG("File '" << fileName << "' does not exist, par instrument sensitivities have to be computed");
+        return false;
+    }
+    Date cacheAsof;
+    ParContainer parSensi;
+    std::set<RiskFactorKey> parKeys, rawKeys;
+    try {
+        // the keys may contain backslashes (escaped slashes), so we do not use an escape character here
+        CSVFileReader reader(fileName, true, ",", "", "\"");
+        while (reader.next()) {
+            std::string type = reader.get(0);
+            if (type == "AsOf") {
+                cacheAsof = parseDate(reader.get(1));
+            } else if (type == "ParKey") {
+                parKeys.insert(parseRiskFactorKey(reader.get(1)));
+            } else if (type == "RawKey") {
+                rawKeys.insert(parseRiskFactorKey(reader.get(1)));
+            } else if (type == "ParSensitivity") {
+                parSensi[std::make_pair(parseRiskFactorKey(reader.get(1)), parseRiskFactorKey(reader.get(2)))] =
+                    parseReal(reader.get(3));
+            } else {
+                QL_FAIL("unexpected row type '" << type << "' in line " << reader.currentLine());
+            }
+        }
+        reader.close();
+    } catch (const std::exception& e) {
+        StructuredAnalyticsErrorMessage("Par sensitivity cache", "Could not read par instrument sensitivities",
+                                        "file '" + fileName + "': " + e.what())
+            .log();
+        return false;
+    }
+    if (cacheAsof == Date() || cacheAsof > asof_ || asof_ - cacheAsof > static_cast<Date::serial_type>(maxStaleness)) {
+        LOG("Par instrument sensitivities in '" << fileName << "' were computed for as of date '"
+                                                << cacheAsof << "', which is not within " << maxStaleness
+                                                << " days before " << io::iso_date(asof_)
+                                                << ", they have to be recomputed");
+        return false;
+    }
+
+    // the shift sizes depend on today's market (relative shifts, par rates), so we recompute them, this also creates
+    // the par instruments from which we read the par keys of the current configuration
+
+    TodaysFixingsRemover fixingRemover(removeTodaysFixingIndices_);
+    auto scenarioGenerator = boost::dynamic_pointer_cast<ShiftScenarioGenerator>(simMarket->scenarioGenerator());
+    QL_REQUIRE(scenarioGenerator, "readParInstrumentSensitivities(): sim market must have a ShiftScenarioGenerator");
+    SimMarketResetter simMarketResetter(simMarket);
+    simMarket->reset();
+    scenarioGenerator->reset();
+    simMarket->update(asof_);
+
+    shiftSizes_.clear();
+    map<RiskFactorKey, Real> parRatesBase, parCapVols;
+    computeBaseParRatesAndShiftSizes(simMarket, parRatesBase, parCapVols);
+
+    // only reuse the cached par instrument sensitivities if they were computed for exactly the same par and raw keys
+
+    std::set<RiskFactorKey> currentParKeys, currentRawKeys;
+    for (auto const& p : parHelpers_)
+        currentParKeys.insert(p.first);
+    for (auto const& p : parCaps_)
+        currentParKeys.insert(p.first);
+    for (auto const& p : parYoYCaps_)
+        currentParKeys.insert(p.first);
+    auto desc = scenarioGenerator->scenarioDescriptions();
+    for (Size i = 1; i < desc.size(); ++i) {
+        if (isParRawScenario(desc[i]))
+            currentRawKeys.insert(desc[i].key1());
+    }
+    if (parKeys != currentParKeys || rawKeys != currentRawKeys) {
+        logKeyDifferences("Par", parKeys, currentParKeys);
+        logKeyDifferences("Raw", rawKeys, currentRawKeys);
+        LOG("Par instrument sensitivities in '" << fileName
+                                                << "' were computed for a different sensitivity configuration, "
+                                                   "they have to be recomputed");
+        return false;
+    }
+
+    parSensi_ = std::move(parSensi);
+    parKeys_ = std::move(parKeys);
+    rawKeys_ = std::move(rawKeys);
+    LOG("Read " << parSensi_.size() << " par instrument sensitivities computed for " << io::iso_date(cacheAsof)
+                << ", recomputed " << shiftSizes_.size() << " shift sizes");
+    return true;
+}
+
 bool ParSensitivityAnalysis::isParType(RiskFactorKey::KeyType type) { return parTypes_.find(type) != parTypes_.end(); }
 
 void ParSensitivityAnalysis::disable(const set<RiskFactorKey::KeyType>& types) {
@@ -2411,6 +2560,35 @@ ParSensitivityConverter::convertSensitivity(const boost::numeric::ublas::vector<
     return parSensitivities;
 }
 
+boost::numeric::ublas::matrix<Real>
+ParSensitivityConverter::convertSensitivities(const boost::numeric::ublas::matrix<Real>& zeroSensitivities) const {
+
+    DLOG("Start sensitivity conversion for " << zeroSensitivities.size2() << " sensitivity vectors");
+
+    Size dim = zeroSensitivities.size1();
+    QL_REQUIRE(jacobi_transp_inv_.size1() == dim,
+               "Size mismatch between Transoposed Jacobi inverse matrix ["
+                   << jacobi_transp_inv_.size1() << " x " << jacobi_transp_inv_.size2()
+                   << "] and zero sensitivity matrix [" << dim << " x " << zeroSensitivities.size2() << "]");
+
+    // Matrix storing approximation for \frac{\partial V}{\partial z_i} for each zero factor z_i (rows) and trade
+    boost::numeric::ublas::matrix<Real> zeroDerivs(zeroSensitivities);
+    for (Size i = 0; i < dim; ++i)
+        boost::numeric::ublas::row(zeroDerivs, i) /= zeroShifts_[i];
+
+    // One sparse matrix product for all trades instead of one matrix vector product per trade
+    boost::numeric::ublas::matrix<Real> parSensitivities(dim, zeroSensitivities.size2());
+    boost::numeric::ublas::axpy_prod(jacobi_transp_inv_, zeroDerivs, parSensitivities, true);
+
+    // first order approximation of the NPV change due to the configured shift in each of the par factors c_i
+    for (Size i = 0; i < dim; ++i)
+        boost::numeric::ublas::row(parSensitivities, i) *= parShifts_[i];
+
+    DLOG("Sensitivity conversion done");
+
+    return parSensitivities;
+}
+
 void ParSensitivityConverter::writeConversionMatrix(Report& report) const {
     
     // Report headers
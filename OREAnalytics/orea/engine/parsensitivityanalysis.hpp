@@ -36,6 +36,7 @@
 #include <ql/instruments/inflationcapfloor.hpp>
 #include <ql/math/matrixutilities/sparsematrix.hpp>
 
+#include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
 #include <map>
@@ -76,6 +77,20 @@ public:
         return parSensi_;
     }
 
+    /*! Write the par instrument sensitivities (i.e. the Jacobian) together with the par and raw keys they were
+        computed for to \p fileName, so that they can be reused in a later run via readParInstrumentSensitivities()
+        instead of calling computeParInstrumentSensitivities() */
+    void writeParInstrumentSensitivities(const std::string& fileName) const;
+
+    /*! Read the par instrument sensitivities from \p fileName written by a previous run and recompute the shift sizes
+        from today's market given by \p simMarket. Returns false, if the file does not exist, can not be parsed, was
+        written for an as of date that is more than \p maxStaleness calendar days before or any day after the as of
+        date of this instance, or if its par and raw keys do not match the current configuration exactly. In this
+        case the par instrument sensitivities are left unchanged and computeParInstrumentSensitivities() has to be
+        called. */
+    bool readParInstrumentSensitivities(const std::string& fileName, const QuantLib::Size maxStaleness,
+                                        const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
+
     //! align pillars in scenario simulation market parameters with those of the par instruments
     void alignPillars();
 
@@ -181,6 +196,15 @@ private:
                     const boost::shared_ptr<Convention>& convention, bool singleCurve, bool fromZero,
                     const std::string& expDiscountCurve, const ore::analytics::RiskFactorKey& key);
 
+    /*! Create the par instruments on \p simMarket, which must be in its base scenario, and compute their base par
+        rates resp. flat vols and the shift sizes */
+    void computeBaseParRatesAndShiftSizes(const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+                                          std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parRatesBase,
+                                          std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parCapVols);
+
+    //! Returns true if the scenario is a raw risk factor shift that is relevant for the par instrument sensitivities
+    bool isParRawScenario(const ore::analytics::ShiftScenarioGenerator::ScenarioDescription& desc) const;
+
     //! Populate `shiftSizes_` for \p key given the implied fair par rate \p parRate
     void populateShiftSizes(const ore::analytics::RiskFactorKey& key, QuantLib::Real parRate,
         const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
@@ -193,6 +217,8 @@ private:
     ore::analytics::SensitivityScenarioData sensitivityData_;
     //! sensitivity of par rates w.r.t. raw rate shifts (including optionlet/cap volatility)
     ParContainer parSensi_;
+    //! par and raw keys of the configuration for which parSensi_ was computed
+    std::set<ore::analytics::RiskFactorKey> parKeys_, rawKeys_;
     //! par helpers (all except cap/floors)
     std::map<ore::analytics::RiskFactorKey, boost::shared_ptr<Instrument>> parHelpers_;
     //! par helpers: IR cap / floors
@@ -295,6 +321,16 @@ public:
     boost::numeric::ublas::vector<Real>
     convertSensitivity(const boost::numeric::ublas::vector<Real>& zeroSensitivities);
 
+    //! Takes a matrix of zero sensitivities and returns a matrix of par sensitivities
+    /*! \param  zeroSensitivities matrix of zero sensitivities, the rows are ordered according to rawKeys(), each
+                                 column holds the sensitivities of one trade
+
+        \return matrix of par sensitivities, the rows are ordered according to parKeys(), the columns correspond to
+                the columns of the input matrix
+    */
+    boost::numeric::ublas::matrix<Real>
+    convertSensitivities(const boost::numeric::ublas::matrix<Real>& zeroSensitivities) const;
+
     //! Write the inverse of the transposed Jacobian to the \p reportOut
     void writeConversionMatrix(ore::data::Report& reportOut) const;
 
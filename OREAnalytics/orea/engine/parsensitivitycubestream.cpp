@@ -29,8 +29,11 @@ namespace analytics {
 
 // Note: iterator initialisation below works because currentDeltas_ is
 //       (empty) initialised before itCurrent_
-ParSensitivityCubeStream::ParSensitivityCubeStream(const boost::shared_ptr<ZeroToParCube>& cube, const string& currency)
-    : cube_(cube), currency_(currency), tradeIdx_(cube_->zeroCube()->tradeIdx().begin()), itCurrent_(currentDeltas_.begin()) {
+ParSensitivityCubeStream::ParSensitivityCubeStream(const boost::shared_ptr<ZeroToParCube>& cube, const string& currency,
+                                                   const Size batchSize)
+    : cube_(cube), currency_(currency), batchSize_(std::max<Size>(batchSize, 1)),
+      tradeIdx_(cube_->zeroCube()->tradeIdx().begin()), tradePos_(0), batchStart_(0),
+      itCurrent_(currentDeltas_.begin()) {
     // Call init
     init();
 }
@@ -42,12 +45,10 @@ SensitivityRecord ParSensitivityCubeStream::next() {
     while (itCurrent_ == currentDeltas_.end() && tradeIdx_ != cube_->zeroCube()->tradeIdx().end()) {
         // Move to next trade
         tradeIdx_++;
+        tradePos_++;
         // update par deltas
         if (tradeIdx_ != cube_->zeroCube()->tradeIdx().end()) {
-            DLOG("Retrieving par deltas for trade " << tradeIdx_->first);
-            currentDeltas_ = cube_->parDeltas(tradeIdx_->second);
-            itCurrent_ = currentDeltas_.begin();
-            DLOG("There are " << currentDeltas_.size() << " par deltas for trade " << tradeIdx_->first);
+            updateCurrentDeltas();
         }
 
     }
@@ -77,6 +78,9 @@ SensitivityRecord ParSensitivityCubeStream::next() {
 void ParSensitivityCubeStream::reset() {
     // Reset all
     tradeIdx_ = cube_->zeroCube()->tradeIdx().begin();
+    tradePos_ = 0;
+    batchDeltas_.clear();
+    batchStart_ = 0;
     currentDeltas_ = {};
     itCurrent_ = currentDeltas_.begin();
     // Call init
@@ -87,12 +91,25 @@ void ParSensitivityCubeStream::init() {
     // If we have trade IDs in the underlying cube
     if (!cube_->zeroCube()->tradeIdx().empty()) {
         tradeIdx_ = cube_->zeroCube()->tradeIdx().begin();
-        DLOG("Retrieving par deltas for trade " << tradeIdx_->first);
-        currentDeltas_ = cube_->parDeltas(tradeIdx_->second);
-        itCurrent_ = currentDeltas_.begin();
-        DLOG("There are " << currentDeltas_.size() << " par deltas for trade " << tradeIdx_->first);
+        tradePos_ = 0;
+        updateCurrentDeltas();
     }
 }
 
+void ParSensitivityCubeStream::updateCurrentDeltas() {
+    if (tradePos_ < batchStart_ || tradePos_ >= batchStart_ + batchDeltas_.size()) {
+        // convert the zero deltas of the next batch of trades in one go
+        std::vector<Size> tradeIndices;
+        for (auto it = tradeIdx_; it != cube_->zeroCube()->tradeIdx().end() && tradeIndices.size() < batchSize_; ++it)
+            tradeIndices.push_back(it->second);
+        DLOG("Retrieving par deltas for " << tradeIndices.size() << " trades starting with " << tradeIdx_->first);
+        batchDeltas_ = cube_->parDeltas(tradeIndices);
+        batchStart_ = tradePos_;
+    }
+    currentDeltas_ = std::move(batchDeltas_[tradePos_ - batchStart_]);
+    itCurrent_ = currentDeltas_.begin();
+    DLOG("There are " << currentDeltas_.size() << " par deltas for trade " << tradeIdx_->first);
+}
+
 } // namespace analytics
 } // namespace ore
@@ -26,6 +26,7 @@
 #include <orea/engine/zerotoparcube.hpp>
 
 #include <string>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -35,9 +36,10 @@ namespace analytics {
 class ParSensitivityCubeStream : public ore::analytics::SensitivityStream {
 public:
     /*! Constructor providing the sensitivity \p cube and currency of the
-        sensitivities
+        sensitivities. The par deltas are computed in batches of \p batchSize trades.
     */
-    ParSensitivityCubeStream(const boost::shared_ptr<ZeroToParCube>& cube, const std::string& currency);
+    ParSensitivityCubeStream(const boost::shared_ptr<ZeroToParCube>& cube, const std::string& currency,
+                             const QuantLib::Size batchSize = 1000);
 
     /*! Returns the next SensitivityRecord in the stream
 
@@ -53,8 +55,15 @@ private:
     boost::shared_ptr<ZeroToParCube> cube_;
     //! Currency of the sensitivities in the SensitivityCube
     std::string currency_;
+    //! Number of trades for which the par deltas are computed in one go
+    QuantLib::Size batchSize_;
     //! TradeId and index of current trade ID in the underlying cube
     std::map<std::string, QuantLib::Size>::const_iterator tradeIdx_;
+    //! Position of the current trade ID in the underlying cube's trade index map
+    QuantLib::Size tradePos_;
+    //! Par deltas for the current batch of trades and position of the first trade of the batch
+    std::vector<std::map<ore::analytics::RiskFactorKey, QuantLib::Real>> batchDeltas_;
+    QuantLib::Size batchStart_;
     //! Par deltas for current trade ID
     std::map<ore::analytics::RiskFactorKey, QuantLib::Real> currentDeltas_;
     //! Iterator to current delta
@@ -62,6 +71,8 @@ private:
 
     //! Shared initialisation
     void init();
+    //! Set the par deltas for the current trade ID, computing the next batch if required
+    void updateCurrentDeltas();
 };
 
 } // namespace analytics
@@ -21,7 +21,7 @@
 #include <orea/app/structuredanalyticserror.hpp>
 #include <ored/utilities/to_string.hpp>
 
-#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
 
 using namespace QuantLib;
 using namespace ore::analytics;
@@ -48,48 +48,58 @@ ZeroToParCube::ZeroToParCube(const boost::shared_ptr<SensitivityCube>& zeroCube,
 }
 
 map<RiskFactorKey, Real> ZeroToParCube::parDeltas(QuantLib::Size tradeIdx) const {
+    return parDeltas(std::vector<Size>(1, tradeIdx)).front();
+}
 
-    DLOG("Calculating par deltas for trade index " << tradeIdx);
+std::vector<map<RiskFactorKey, Real>> ZeroToParCube::parDeltas(const std::vector<Size>& tradeIdx) const {
 
-    map<RiskFactorKey, Real> result;
+    DLOG("Calculating par deltas for " << tradeIdx.size() << " trade indices");
 
-    // Get the "par-convertible" zero deltas
-    boost::numeric::ublas::vector<Real> zeroDeltas(parConverter_->rawKeys().size(), 0.0);
+    std::vector<map<RiskFactorKey, Real>> result(tradeIdx.size());
+
+    // Get the "par-convertible" zero deltas, one column per trade
+    boost::numeric::ublas::matrix<Real> zeroDeltas(parConverter_->rawKeys().size(), tradeIdx.size(), 0.0);
     const boost::shared_ptr<NPVSensiCube>& sensiCube = zeroCube_->npvCube();
 
-    for (auto const& kv : sensiCube->getTradeNPVs(tradeIdx)) {
-        auto factor = zeroCube_->upFactor(kv.first);
-        // index might not belong to an up/down scenario
-        if (factor.keytype != RiskFactorKey::KeyType::None) {
-            auto it = factorToIndex_.find(factor);
-            if (it == factorToIndex_.end()) {
-                if (ParSensitivityAnalysis::isParType(factor.keytype) && typesDisabled_.count(factor.keytype) != 1) {
-                    if (continueOnError_) {
-                        StructuredAnalyticsErrorMessage("Par conversion", "",
-                                                        "Par factor " + ore::data::to_string(factor) +
-                                                            " not found in factorToIndex map")
-                            .log();
-                    } else {
-                        QL_REQUIRE(!ParSensitivityAnalysis::isParType(factor.keytype) ||
-                                typesDisabled_.count(factor.keytype) == 1,
-                                "ZeroToParCube::parDeltas(): par factor " << factor << " not found in factorToIndex map");
+    for (Size t = 0; t < tradeIdx.size(); ++t) {
+        for (auto const& kv : sensiCube->getTradeNPVs(tradeIdx[t])) {
+            auto factor = zeroCube_->upFactor(kv.first);
+            // index might not belong to an up/down scenario
+            if (factor.keytype != RiskFactorKey::KeyType::None) {
+                auto it = factorToIndex_.find(factor);
+                if (it == factorToIndex_.end()) {
+                    if (ParSensitivityAnalysis::isParType(factor.keytype) &&
+                        typesDisabled_.count(factor.keytype) != 1) {
+                        if (continueOnError_) {
+                            StructuredAnalyticsErrorMessage("Par conversion", "",
+                                                            "Par factor " + ore::data::to_string(factor) +
+                                                                " not found in factorToIndex map")
+                                .log();
+                        } else {
+                            QL_REQUIRE(!ParSensitivityAnalysis::isParType(factor.keytype) ||
+                                           typesDisabled_.count(factor.keytype) == 1,
+                                       "ZeroToParCube::parDeltas(): par factor " << factor
+                                                                                 << " not found in factorToIndex map");
+                        }
                     }
+                } else if (!zeroCube_->twoSidedDelta(factor.keytype)) {
+                    zeroDeltas(it->second, t) = zeroCube_->delta(tradeIdx[t], kv.first);
+                } else {
+                    Size downIdx = zeroCube_->downFactors().at(factor).index;
+                    zeroDeltas(it->second, t) = zeroCube_->delta(tradeIdx[t], kv.first, downIdx);
                 }
-            } else if (!zeroCube_->twoSidedDelta(factor.keytype)) {
-                zeroDeltas[it->second] = zeroCube_->delta(tradeIdx, kv.first);
-            } else {
-                Size downIdx = zeroCube_->downFactors().at(factor).index;
-                zeroDeltas[it->second] = zeroCube_->delta(tradeIdx, kv.first, downIdx);
             }
         }
     }
 
     // Convert the zero deltas to par deltas
-    boost::numeric::ublas::vector<Real> parDeltas = parConverter_->convertSensitivity(zeroDeltas);
+    boost::numeric::ublas::matrix<Real> parDeltas = parConverter_->convertSensitivities(zeroDeltas);
     Size counter = 0;
     for (const auto& key : parConverter_->parKeys()) {
-        if (!close(parDeltas[counter], 0.0)) {
-            result[key] = parDeltas[counter];
+        for (Size t = 0; t < tradeIdx.size(); ++t) {
+            if (!close(parDeltas(counter, t), 0.0)) {
+                result[t][key] = parDeltas(counter, t);
+            }
         }
         counter++;
     }
@@ -97,20 +107,22 @@ map<RiskFactorKey, Real> ZeroToParCube::parDeltas(QuantLib::Size tradeIdx) const
     // Add non-zero deltas that do not need to be converted from underlying zero cube
     for (const auto& key : zeroCube_->upFactors()) {
         if (!ParSensitivityAnalysis::isParType(key.first.keytype) || typesDisabled_.count(key.first.keytype) == 1) {
-            Real delta = 0.0;
-            if (!zeroCube_->twoSidedDelta(key.first.keytype)) {
-                delta = zeroCube_->delta(tradeIdx, key.second.index);
-            } else {
-                Size downIdx = zeroCube_->downFactors().at(key.first).index;
-                delta = zeroCube_->delta(tradeIdx, key.second.index, downIdx);
-            }
-            if (!close(delta, 0.0)) {
-                result[key.first] = delta;
+            for (Size t = 0; t < tradeIdx.size(); ++t) {
+                Real delta = 0.0;
+                if (!zeroCube_->twoSidedDelta(key.first.keytype)) {
+                    delta = zeroCube_->delta(tradeIdx[t], key.second.index);
+                } else {
+                    Size downIdx = zeroCube_->downFactors().at(key.first).index;
+                    delta = zeroCube_->delta(tradeIdx[t], key.second.index, downIdx);
+                }
+                if (!close(delta, 0.0)) {
+                    result[t][key.first] = delta;
+                }
             }
         }
     }
 
-    DLOG("Finished calculating par deltas for trade index " << tradeIdx);
+    DLOG("Finished calculating par deltas for " << tradeIdx.size() << " trade indices");
 
     return result;
 }
@@ -24,6 +24,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <orea/cube/sensitivitycube.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
@@ -59,6 +60,11 @@ public:
     //! Return the non-zero par deltas for the given trade index
     std::map<ore::analytics::RiskFactorKey, QuantLib::Real> parDeltas(QuantLib::Size tradeIdx) const;
 
+    /*! Return the non-zero par deltas for each of the given trade indices. The zero to par conversion is done for
+        all trades in one sparse matrix product, which is faster than converting the trades one by one. */
+    std::vector<std::map<ore::analytics::RiskFactorKey, QuantLib::Real>>
+    parDeltas(const std::vector<QuantLib::Size>& tradeIdx) const;
+
 private:
     boost::shared_ptr<ore::analytics::SensitivityCube> zeroCube_;
     boost::shared_ptr<ParSensitivityConverter> parConverter_;
@@ -28,6 +28,7 @@
 #include <qle/cashflows/floatingratefxlinkednotionalcoupon.hpp>
 #include <qle/cashflows/fxlinkedcashflow.hpp>
 #include <qle/cashflows/overnightindexedcoupon.hpp>
+#include <qle/cashflows/overnightpastfixingscache.hpp>
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/indexes/genericindex.hpp>
 
@@ -192,6 +193,8 @@ void FixingManager::applyFixings(Date start, Date end) {
                 if (d >= fixEnd)
                     break;
             }
+            // the fixings are on or after the previous update date, declare this to the overnight coupon caches
+            QuantExt::OvernightPastFixingsCache::ForwardFixingUpdates forwardUpdates;
             m.first->addFixings(history, true);
         }
     }
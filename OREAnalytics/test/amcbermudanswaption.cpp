@@ -794,6 +794,87 @@ BOOST_DATA_TEST_CASE(testBermudanSwaptionExposure, boost::unit_test::data::make(
 
 } // testBermudanSwaptionExposure
 
+BOOST_AUTO_TEST_CASE(testBermudanSwaptionExposureInSampleBlocks) {
+
+    BOOST_TEST_MESSAGE("Testing Bermudan swaption exposure generated in sample blocks vs a single block");
+
+    // semiannual grid over 21 years, swaption EUR 10y10y with yearly exercises starting at 10y
+
+    std::vector<Period> tenorGrid;
+    for (Size i = 0; i < 42; ++i)
+        tenorGrid.push_back(((i + 1) * 6) * Months);
+    Calendar cal = TARGET();
+    boost::shared_ptr<DateGrid> grid = boost::make_shared<DateGrid>(tenorGrid, cal, ActualActual(ActualActual::ISDA));
+
+    boost::shared_ptr<ScenarioGeneratorData> sgd(new ScenarioGeneratorData);
+    sgd->sequenceType() = SobolBrownianBridge;
+    sgd->seed() = 42;
+    sgd->setGrid(grid);
+
+    Date fwdStartDate = cal.advance(cal.advance(referenceDate, 2 * Days), 10 * Years);
+    Date endDate = cal.advance(fwdStartDate, 10 * Years);
+    Schedule fixedSchedule(fwdStartDate, endDate, 1 * Years, cal, Following, Following, DateGeneration::Forward, false);
+    Schedule floatingSchedule(fwdStartDate, endDate, 6 * Months, cal, Following, Following, DateGeneration::Forward,
+                              false);
+    auto underlying = boost::make_shared<VanillaSwap>(VanillaSwap::Payer, 1.0, fixedSchedule, 0.02,
+                                                      Thirty360(Thirty360::BondBasis), floatingSchedule,
+                                                      *market->iborIndex("EUR-EURIBOR-6M"), 0.0, Actual360());
+    underlying->setPricingEngine(boost::make_shared<QuantLib::DiscountingSwapEngine>(market->discountCurve("EUR")));
+
+    std::vector<Date> exerciseDates;
+    for (Size i = 0; i < 10; ++i)
+        exerciseDates.push_back(grid->dates()[19 + 2 * i]);
+    auto swaption = boost::make_shared<Swaption>(underlying, boost::make_shared<BermudanExercise>(exerciseDates),
+                                                 Settlement::Physical, Settlement::PhysicalOTC);
+    swaption->setPricingEngine(boost::make_shared<McLgmSwaptionEngine>(
+        lgm_eur, MersenneTwisterAntithetic, SobolBrownianBridge, 2000, 0, 4711, 4712, 6, LsmBasisSystem::Monomial,
+        SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7, Handle<YieldTermStructure>(), grid->dates(),
+        std::vector<Size>{0}));
+
+    class TestTrade : public Trade {
+    public:
+        TestTrade(const string& tradeType, const string& curr, const boost::shared_ptr<InstrumentWrapper>& inst)
+            : Trade(tradeType) {
+            instrument_ = inst;
+            npvCurrency_ = curr;
+        }
+        void build(const boost::shared_ptr<EngineFactory>&) override {}
+    };
+    auto trade =
+        boost::make_shared<TestTrade>("BermudanSwaption", "EUR", boost::make_shared<VanillaInstrument>(swaption));
+    trade->id() = "DummyTradeId";
+    auto portfolio = boost::make_shared<Portfolio>();
+    portfolio->add(trade);
+
+    /* with about 3kB per sample for the paths, buffers and results a memory limit of 1 MB yields three blocks for
+       1000 samples, the last one being smaller than the others, without a limit all samples are processed at once */
+
+    Size samples = 1000;
+    std::vector<boost::shared_ptr<NPVCube>> cubes;
+    for (Size maxPathMemory : {0, 1}) {
+        AMCValuationEngine amcValEngine(ccLgm, sgd, boost::shared_ptr<Market>(), std::vector<string>(),
+                                        std::vector<string>(), 0);
+        amcValEngine.setMaxPathMemory(maxPathMemory);
+        cubes.push_back(boost::make_shared<DoublePrecisionInMemoryCube>(
+            referenceDate, std::set<string>{"DummyTradeId"}, grid->dates(), samples));
+        amcValEngine.buildCube(portfolio, cubes.back());
+    }
+
+    // the t0 npv is averaged over the blocks with weights proportional to the block sizes
+
+    BOOST_TEST_MESSAGE("T0 NPV single block = " << cubes[0]->getT0(0, 0) << ", blocked = " << cubes[1]->getT0(0, 0));
+    BOOST_CHECK_CLOSE(cubes[1]->getT0(0, 0), cubes[0]->getT0(0, 0), 1E-10);
+
+    // the paths do not depend on the block size, so neither do the simulated exposures
+
+    for (Size j = 0; j < grid->dates().size(); ++j) {
+        for (Size i = 0; i < samples; ++i) {
+            BOOST_CHECK_SMALL(cubes[1]->get(0, j, i, 0) - cubes[0]->get(0, j, i, 0), 1E-12);
+        }
+    }
+
+} // testBermudanSwaptionExposureInSampleBlocks
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,142 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <orea/aggregation/creditmigrationhelper.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+
+#include <ored/portfolio/trade.hpp>
+
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <numeric>
+
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// one issuer (with three rating states, the last one is default) and one counterparty with a netting set
+const std::string parametersXml = "<Root><CreditSimulation>"
+                                  "<TransitionMatrices><TransitionMatrix><Name>Rating</Name>"
+                                  "<Data>0.90,0.08,0.02,0.10,0.80,0.10,0.0,0.0,1.0</Data>"
+                                  "</TransitionMatrix></TransitionMatrices>"
+                                  "<Entities>"
+                                  "<Entity><Name>ISSUER</Name><FactorLoadings>0.5</FactorLoadings>"
+                                  "<TransitionMatrix>Rating</TransitionMatrix><InitialState>0</InitialState></Entity>"
+                                  "<Entity><Name>CPTY</Name><FactorLoadings>0.3</FactorLoadings>"
+                                  "<TransitionMatrix>Rating</TransitionMatrix><InitialState>1</InitialState></Entity>"
+                                  "</Entities>"
+                                  "<NettingSetIds>NS</NettingSetIds>"
+                                  "<Risk><Market>Y</Market><Credit>Y</Credit><ZeroMarketPnl>N</ZeroMarketPnl>"
+                                  "<Evaluation>TerminalSimulation</Evaluation><DoubleDefault>N</DoubleDefault>"
+                                  "<Seed>42</Seed><Paths>50</Paths><CreditMode>Migration</CreditMode>"
+                                  "<LoanExposureMode>Value</LoanExposureMode></Risk>"
+                                  "</CreditSimulation></Root>";
+
+class TestTrade : public Trade {
+public:
+    TestTrade(const std::string& id, const std::string& issuer) : Trade("Test", Envelope("CPTY", std::string("NS"))) {
+        this->id() = id;
+        issuer_ = issuer;
+    }
+    void build(const boost::shared_ptr<EngineFactory>&) override {}
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CreditMigrationHelperTest)
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionsThreadIndependence) {
+
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distributions do not depend on the number of threads...");
+
+    Date asof(30, July, 2015);
+    std::vector<Date> dates = {Date(30, January, 2016), Date(30, July, 2016), Date(30, July, 2017)};
+    Size samples = 20;
+
+    auto parameters = boost::make_shared<CreditSimulationParameters>();
+    parameters->fromXMLString(parametersXml);
+
+    // trade npvs on depth 0 and the npvs in the three issuer states on depth 1, 2, 3
+
+    MersenneTwisterUniformRng rng(1);
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, std::set<std::string>{"TRADE"}, dates,
+                                                                 samples, 4, 0.0);
+    auto nettedCube =
+        boost::make_shared<DoublePrecisionInMemoryCube>(asof, std::set<std::string>{"NS"}, dates, samples, 0.0);
+    auto aggData = boost::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+    cube->setT0(1.0, 0);
+    nettedCube->setT0(1.0, 0);
+    for (Size d = 0; d < dates.size(); ++d) {
+        for (Size s = 0; s < samples; ++s) {
+            Real npv = 0.5 + rng.next().value;
+            cube->set(npv, 0, d, s, 0);
+            cube->set(npv + 0.1, 0, d, s, 1);
+            cube->set(npv - 0.2, 0, d, s, 2);
+            cube->set(0.3 * npv, 0, d, s, 3);
+            nettedCube->set(npv - 0.8, 0, d, s);
+            aggData->set(d, s, 2.0 * rng.next().value - 1.0, AggregationScenarioDataType::CreditState, "0");
+        }
+    }
+
+    CreditMigrationHelper helper(parameters, cube, nettedCube, aggData, Null<Size>(), 1, -5.0, 5.0, 50,
+                                 Matrix(1, 1, 1.0), "EUR");
+    helper.build({{"TRADE", boost::make_shared<TestTrade>("TRADE", "ISSUER")}});
+
+    std::vector<Size> dateIndices = {0, 1, 2};
+
+    // without a block size all paths form one block regardless of the threads, i.e. we get the sequential result
+
+    std::vector<Array> ref = helper.pnlDistributions(dateIndices, 1, 0);
+    BOOST_REQUIRE_EQUAL(ref.size(), dateIndices.size());
+    for (Size threads : {2, 4}) {
+        std::vector<Array> res = helper.pnlDistributions(dateIndices, threads, 0);
+        for (Size k = 0; k < dateIndices.size(); ++k) {
+            Array single = helper.pnlDistribution(dateIndices[k]);
+            BOOST_CHECK_EQUAL_COLLECTIONS(res[k].begin(), res[k].end(), ref[k].begin(), ref[k].end());
+            BOOST_CHECK_EQUAL_COLLECTIONS(single.begin(), single.end(), ref[k].begin(), ref[k].end());
+        }
+    }
+
+    // with a given block size (here 7 blocks, the last one smaller) the result is the same for all thread numbers
+
+    std::vector<Array> refBlocks = helper.pnlDistributions(dateIndices, 1, 3);
+    for (Size threads : {2, 3, 8}) {
+        std::vector<Array> res = helper.pnlDistributions(dateIndices, threads, 3);
+        for (Size k = 0; k < dateIndices.size(); ++k)
+            BOOST_CHECK_EQUAL_COLLECTIONS(res[k].begin(), res[k].end(), refBlocks[k].begin(), refBlocks[k].end());
+    }
+
+    // the distributions are probability distributions
+
+    for (Size k = 0; k < dateIndices.size(); ++k) {
+        BOOST_CHECK_CLOSE(std::accumulate(ref[k].begin(), ref[k].end(), 0.0), 1.0, 1E-10);
+        BOOST_CHECK_CLOSE(std::accumulate(refBlocks[k].begin(), refBlocks[k].end(), 0.0), 1.0, 1E-10);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <oret/datapaths.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+#include <orea/engine/multithreadedvaluationengine.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/irlgmdata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/dategrid.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace ore::data;
+using namespace ore::analytics;
+
+namespace {
+
+// collect the t0 and all simulated values of the mini cubes per trade id, the split of the portfolio between the
+// threads depends on the measured pricing times, so the values are not compared cube by cube
+std::map<std::string, std::vector<Real>> cubeValues(const std::vector<boost::shared_ptr<NPVCube>>& cubes) {
+    std::map<std::string, std::vector<Real>> result;
+    for (auto const& c : cubes) {
+        for (auto const& [id, pos] : c->idsAndIndexes()) {
+            auto& v = result[id];
+            v.push_back(c->getT0(pos));
+            for (Size d = 0; d < c->numDates(); ++d)
+                for (Size s = 0; s < c->samples(); ++s)
+                    v.push_back(c->get(pos, d, s));
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MultiThreadedValuationEngineTest)
+
+BOOST_AUTO_TEST_CASE(testMarketSnapshot) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded valuation engine with and without market snapshot...");
+
+#ifndef QL_ENABLE_SESSIONS
+    BOOST_TEST_MESSAGE("Skipping test, the multi-threaded valuation engine requires QL_ENABLE_SESSIONS = ON.");
+#else
+    Date today(6, November, 2020);
+    Settings::instance().evaluationDate() = today;
+
+    auto conventions = boost::make_shared<Conventions>();
+    conventions->fromFile(TEST_INPUT_FILE("conventions.xml"));
+    InstrumentConventions::instance().setConventions(conventions);
+
+    auto curveConfigs = boost::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(TEST_INPUT_FILE("curveconfig.xml"));
+    auto todaysMarketParams = boost::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(TEST_INPUT_FILE("todaysmarket.xml"));
+    auto engineData = boost::make_shared<EngineData>();
+    engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    auto loader = boost::make_shared<CSVLoader>(TEST_INPUT_FILE("market.txt"), TEST_INPUT_FILE("fixings.txt"), false);
+
+    // the yield curve is a bootstrapped discount curve, the default curve is bootstrapped from cds upfront quotes
+    std::string creditName = "RED:8B69AP|SNRFOR|USD|CR";
+    auto simMarketData = boost::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->baseCcy() = "USD";
+    simMarketData->ccys() = {"USD"};
+    simMarketData->setDiscountCurveNames({"USD"});
+    simMarketData->setYieldCurveTenors("", {3 * Months, 6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years,
+                                            7 * Years, 10 * Years, 15 * Years, 20 * Years, 30 * Years});
+    simMarketData->interpolation() = "LogLinear";
+    simMarketData->setDefaultNames({creditName});
+    simMarketData->setDefaultTenors("", {6 * Months, 1 * Years, 2 * Years, 3 * Years, 5 * Years, 7 * Years,
+                                         10 * Years, 15 * Years, 20 * Years, 30 * Years});
+    simMarketData->setSimulateSurvivalProbabilities(false);
+    simMarketData->setDefaultCurveCalendars("", "WeekendsOnly");
+    simMarketData->setRecoveryRates({creditName});
+    simMarketData->setSimulateRecoveryRates(false);
+
+    // scenario generator on a single factor lgm model for USD
+    auto initMarket = boost::make_shared<TodaysMarket>(today, todaysMarketParams, loader, curveConfigs);
+    std::vector<boost::shared_ptr<IrModelData>> irConfigs;
+    irConfigs.push_back(boost::make_shared<IrLgmData>(
+        "USD", CalibrationType::None, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::HullWhite, false,
+        ParamType::Constant, std::vector<Time>(), std::vector<Real>{0.01}, false, ParamType::Constant,
+        std::vector<Time>(), std::vector<Real>{0.01}));
+    auto camData = boost::make_shared<CrossAssetModelData>(irConfigs, std::vector<boost::shared_ptr<FxBsData>>(),
+                                                           std::map<CorrelationKey, Handle<Quote>>());
+    CrossAssetModelBuilder modelBuilder(initMarket, camData);
+
+    Size samples = 10;
+    auto grid = boost::make_shared<DateGrid>("10,6M");
+    auto sgd = boost::make_shared<ScenarioGeneratorData>();
+    sgd->sequenceType() = SobolBrownianBridge;
+    sgd->seed() = 42;
+    sgd->setGrid(grid);
+    ScenarioGeneratorBuilder sgb(sgd);
+    auto scenarioGenerator = sgb.build(*modelBuilder.model(), boost::make_shared<SimpleScenarioFactory>(),
+                                       simMarketData, today, initMarket);
+
+    auto calculators = []() {
+        return std::vector<boost::shared_ptr<ValuationCalculator>>{boost::make_shared<NPVCalculator>("USD")};
+    };
+
+    std::vector<std::map<std::string, std::vector<Real>>> results;
+    for (bool useMarketSnapshot : {true, false}) {
+        auto portfolio = boost::make_shared<Portfolio>();
+        portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+        MultiThreadedValuationEngine engine(2, today, grid, samples, loader, scenarioGenerator, engineData,
+                                            curveConfigs, todaysMarketParams, Market::defaultConfiguration,
+                                            simMarketData);
+        engine.setUseMarketSnapshot(useMarketSnapshot);
+        engine.buildCube(portfolio, calculators);
+        BOOST_REQUIRE_EQUAL(engine.outputCubes().size(), 2U);
+        results.push_back(cubeValues(engine.outputCubes()));
+    }
+
+    BOOST_REQUIRE_EQUAL(results[0].size(), 4U);
+    BOOST_REQUIRE_EQUAL(results[1].size(), 4U);
+    for (auto const& [id, v] : results[0]) {
+        BOOST_TEST_MESSAGE("Checking trade " << id);
+        auto w = results[1].find(id);
+        BOOST_REQUIRE(w != results[1].end());
+        BOOST_REQUIRE_EQUAL(v.size(), w->second.size());
+        for (Size i = 0; i < v.size(); ++i)
+            BOOST_CHECK_EQUAL(v[i], w->second[i]);
+    }
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
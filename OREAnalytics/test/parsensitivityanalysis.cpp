@@ -57,8 +57,11 @@
 
 #include <test/oreatoplevelfixture.hpp>
 
+#include <boost/filesystem.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <fstream>
+
 using namespace std;
 using namespace QuantLib;
 using namespace QuantExt;
@@ -1186,6 +1189,59 @@ void testParConversion(ObservationMode::Mode om) {
         }
     }
 
+    // the batched conversion of all trades must reproduce the trade by trade conversion
+    std::vector<Size> tradeIndices;
+    for (auto const& t : sensiCube->tradeIdx())
+        tradeIndices.push_back(t.second);
+    auto batchParDeltas = parCube.parDeltas(tradeIndices);
+    BOOST_REQUIRE_EQUAL(batchParDeltas.size(), tradeIndices.size());
+    for (Size i = 0; i < tradeIndices.size(); ++i) {
+        auto singleParDeltas = parCube.parDeltas(tradeIndices[i]);
+        BOOST_CHECK_EQUAL(singleParDeltas.size(), batchParDeltas[i].size());
+        for (auto const& kv : singleParDeltas) {
+            BOOST_CHECK_CLOSE(kv.second, batchParDeltas[i][kv.first], 1E-10);
+        }
+    }
+
+    // the par instrument sensitivities read from a cache file must reproduce the computed ones, the shift sizes are
+    // recomputed from today's market
+    string cacheFile = boost::filesystem::unique_path().string();
+    parAnalysis.writeParInstrumentSensitivities(cacheFile);
+    ParSensitivityAnalysis staleParAnalysis(today + 1, simMarketData, *sensiData, "default");
+    BOOST_CHECK(!staleParAnalysis.readParInstrumentSensitivities(cacheFile, 0, zeroAnalysis->simMarket()));
+    ParSensitivityAnalysis cachedParAnalysis(today, simMarketData, *sensiData, "default");
+    BOOST_REQUIRE(cachedParAnalysis.readParInstrumentSensitivities(cacheFile, 0, zeroAnalysis->simMarket()));
+    BOOST_REQUIRE_EQUAL(cachedParAnalysis.parSensitivities().size(), parAnalysis.parSensitivities().size());
+    for (auto const& p : parAnalysis.parSensitivities()) {
+        BOOST_CHECK_CLOSE(cachedParAnalysis.parSensitivities().at(p.first), p.second, 1E-10);
+    }
+    BOOST_REQUIRE_EQUAL(cachedParAnalysis.shiftSizes().size(), parAnalysis.shiftSizes().size());
+    for (auto const& s : parAnalysis.shiftSizes()) {
+        BOOST_CHECK_CLOSE(cachedParAnalysis.shiftSizes().at(s.first).first, s.second.first, 1E-10);
+        BOOST_CHECK_CLOSE(cachedParAnalysis.shiftSizes().at(s.first).second, s.second.second, 1E-10);
+    }
+
+    // a cache that was written for a different set of raw keys must be rejected
+    string mismatchFile = boost::filesystem::unique_path().string();
+    {
+        std::ifstream in(cacheFile);
+        std::ofstream out(mismatchFile);
+        string line;
+        bool removed = false;
+        while (std::getline(in, line)) {
+            if (!removed && line.rfind("RawKey,", 0) == 0)
+                removed = true;
+            else
+                out << line << "\n";
+        }
+        BOOST_REQUIRE(removed);
+    }
+    ParSensitivityAnalysis mismatchParAnalysis(today, simMarketData, *sensiData, "default");
+    BOOST_CHECK(!mismatchParAnalysis.readParInstrumentSensitivities(mismatchFile, 0, zeroAnalysis->simMarket()));
+    BOOST_CHECK(mismatchParAnalysis.parSensitivities().empty());
+    boost::filesystem::remove(mismatchFile);
+    boost::filesystem::remove(cacheFile);
+
     struct Results {
         string id;
         string label;
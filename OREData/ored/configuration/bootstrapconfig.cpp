@@ -25,10 +25,10 @@ namespace ore {
 namespace data {
 
 BootstrapConfig::BootstrapConfig(Real accuracy, Real globalAccuracy, bool dontThrow, Size maxAttempts, Real maxFactor,
-                                 Real minFactor, Size dontThrowSteps)
+                                 Real minFactor, Size dontThrowSteps, bool globalNewton)
     : accuracy_(accuracy), globalAccuracy_(globalAccuracy == Null<Real>() ? accuracy_ : globalAccuracy),
       dontThrow_(dontThrow), maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor),
-      dontThrowSteps_(dontThrowSteps) {}
+      dontThrowSteps_(dontThrowSteps), globalNewton_(globalNewton) {}
 
 void BootstrapConfig::fromXML(XMLNode* node) {
 
@@ -74,6 +74,11 @@ void BootstrapConfig::fromXML(XMLNode* node) {
         QL_REQUIRE(dontThrowSteps > 0, "DontThrowSteps (" << dontThrowSteps << ") must be a positive integer");
         dontThrowSteps_ = static_cast<Size>(dontThrowSteps);
     }
+
+    globalNewton_ = false;
+    if (XMLNode* n = XMLUtils::getChildNode(node, "GlobalNewton")) {
+        globalNewton_ = parseBool(XMLUtils::getNodeValue(n));
+    }
 }
 
 XMLNode* BootstrapConfig::toXML(XMLDocument& doc) {
@@ -86,6 +91,7 @@ XMLNode* BootstrapConfig::toXML(XMLDocument& doc) {
     XMLUtils::addChild(doc, node, "MaxFactor", maxFactor_);
     XMLUtils::addChild(doc, node, "MinFactor", minFactor_);
     XMLUtils::addChild(doc, node, "DontThrowSteps", static_cast<int>(dontThrowSteps_));
+    XMLUtils::addChild(doc, node, "GlobalNewton", globalNewton_);
 
     return node;
 }
@@ -234,7 +234,9 @@ namespace data {
 DefaultCurve::DefaultCurve(Date asof, DefaultCurveSpec spec, const Loader& loader,
                            const CurveConfigurations& curveConfigs,
                            map<string, boost::shared_ptr<YieldCurve>>& yieldCurves,
-                           map<string, boost::shared_ptr<DefaultCurve>>& defaultCurves) {
+                           map<string, boost::shared_ptr<DefaultCurve>>& defaultCurves,
+                           const boost::shared_ptr<MarketSnapshot>& snapshot)
+    : snapshot_(snapshot != nullptr && snapshot->asof() == asof ? snapshot : nullptr) {
     const boost::shared_ptr<DefaultCurveConfig>& configs = curveConfigs.defaultCurveConfig(spec.curveConfigID());
     bool built = false;
     std::string errors;
@@ -266,7 +268,9 @@ DefaultCurve::DefaultCurve(Date asof, DefaultCurveSpec spec, const Loader& loade
             switch (config.second.type()) {
             case DefaultCurveConfig::Config::Type::SpreadCDS:
             case DefaultCurveConfig::Config::Type::Price:
-                buildCdsCurve(configs->curveID(), config.second, asof, spec, loader, yieldCurves);
+                // the config priority is part of the snapshot name, since a fallback config yields a different curve
+                buildCdsCurve(configs->curveID(), config.second, asof, spec, loader, yieldCurves,
+                              spec.name() + "/" + std::to_string(config.first));
                 break;
             case DefaultCurveConfig::Config::Type::HazardRate:
                 buildHazardRateCurve(configs->curveID(), config.second, asof, spec, loader);
@@ -304,7 +308,8 @@ DefaultCurve::DefaultCurve(Date asof, DefaultCurveSpec spec, const Loader& loade
 
 void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveConfig::Config& config, const Date& asof,
                                  const DefaultCurveSpec& spec, const Loader& loader,
-                                 map<string, boost::shared_ptr<YieldCurve>>& yieldCurves) {
+                                 map<string, boost::shared_ptr<YieldCurve>>& yieldCurves,
+                                 const std::string& snapshotName) {
 
     LOG("Start building default curve of type SpreadCDS for curve " << curveID);
 
@@ -494,42 +499,56 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
 
         // build single name curve
 
-        boost::shared_ptr<DefaultProbabilityTermStructure> tmp = boost::make_shared<SpCurve>(
-            asof, helpers, config.dayCounter(), LogLinear(),
-            QuantExt::IterativeBootstrap<SpCurve>(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                  minFactor, dontThrowSteps));
-
-        // As for yield curves we need to copy the piecewise curve because on eval date changes the relative date
-        // helpers with trigger a bootstrap.
         vector<Date> dates;
         vector<Real> survivalProbs;
-        dates.push_back(asof);
-        survivalProbs.push_back(1.0);
-
-        for (Size i = 0; i < helpers.size(); ++i) {
-            if (helpers[i]->latestDate() > asof) {
-                Date pillarDate = helpers[i]->pillarDate();
-                Probability sp = tmp->survivalProbability(pillarDate);
-
-                // In some cases the bootstrapped survival probability at one tenor will be `close` to that at a
-                // previous tenor. Here we don't add that survival probability and date to avoid issues when creating
-                // the InterpolatedSurvivalProbabilityCurve below.
-                if (!survivalProbs.empty() && close(survivalProbs.back(), sp)) {
-                    DLOG("Survival probability for curve " << spec.name() << " at date " << io::iso_date(pillarDate)
-                                                           << " is the same as that at previous date "
-                                                           << io::iso_date(dates.back()) << " so skipping it.");
-                    continue;
-                }
 
-                dates.push_back(pillarDate);
-                survivalProbs.push_back(sp);
-                TLOG(io::iso_date(pillarDate) << "," << fixed << setprecision(9) << sp);
+        // If the curve is part of the snapshot, build the interpolated curve from the stored pillars. This yields the
+        // same curve as the bootstrap below, since the stored values were produced by it.
+        const MarketSnapshot::CurvePillars* pillars = snapshot_ ? snapshot_->defaultCurve(snapshotName) : nullptr;
+        if (pillars) {
+            DLOG("Building default curve " << spec.name() << " from market snapshot");
+            dates = pillars->dates;
+            survivalProbs = pillars->values;
+        } else {
+            boost::shared_ptr<DefaultProbabilityTermStructure> tmp = boost::make_shared<SpCurve>(
+                asof, helpers, config.dayCounter(), LogLinear(),
+                QuantExt::IterativeBootstrap<SpCurve>(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
+                                                      minFactor, dontThrowSteps));
+
+            // As for yield curves we need to copy the piecewise curve because on eval date changes the relative date
+            // helpers with trigger a bootstrap.
+            dates.push_back(asof);
+            survivalProbs.push_back(1.0);
+
+            for (Size i = 0; i < helpers.size(); ++i) {
+                if (helpers[i]->latestDate() > asof) {
+                    Date pillarDate = helpers[i]->pillarDate();
+                    Probability sp = tmp->survivalProbability(pillarDate);
+
+                    // In some cases the bootstrapped survival probability at one tenor will be `close` to that at a
+                    // previous tenor. Here we don't add that survival probability and date to avoid issues when
+                    // creating the InterpolatedSurvivalProbabilityCurve below.
+                    if (!survivalProbs.empty() && close(survivalProbs.back(), sp)) {
+                        DLOG("Survival probability for curve " << spec.name() << " at date "
+                                                               << io::iso_date(pillarDate)
+                                                               << " is the same as that at previous date "
+                                                               << io::iso_date(dates.back()) << " so skipping it.");
+                        continue;
+                    }
+
+                    dates.push_back(pillarDate);
+                    survivalProbs.push_back(sp);
+                    TLOG(io::iso_date(pillarDate) << "," << fixed << setprecision(9) << sp);
+                }
             }
-        }
-        if (dates.size() == 1) {
-            // We might have removed points above. To make the interpolation work, we need at least two points though.
-            dates.push_back(dates.back() + 1);
-            survivalProbs.push_back(survivalProbs.back());
+            if (dates.size() == 1) {
+                // We might have removed points above. To make the interpolation work, we need at least two points
+                // though.
+                dates.push_back(dates.back() + 1);
+                survivalProbs.push_back(survivalProbs.back());
+            }
+            if (snapshot_)
+                snapshot_->addDefaultCurve(snapshotName, dates, survivalProbs);
         }
         qlCurve = boost::make_shared<QuantExt::InterpolatedSurvivalProbabilityCurve<LogLinear>>(
             dates, survivalProbs, config.dayCounter(), Calendar(), std::vector<Handle<Quote>>(), std::vector<Date>(),
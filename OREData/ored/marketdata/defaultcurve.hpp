@@ -27,6 +27,7 @@
 #include <ored/configuration/curveconfigurations.hpp>
 #include <ored/marketdata/curvespec.hpp>
 #include <ored/marketdata/loader.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
 #include <ql/termstructures/credit/interpolatedhazardratecurve.hpp>
 #include <ql/termstructures/credit/piecewisedefaultcurve.hpp>
 #include <qle/termstructures/creditcurve.hpp>
@@ -53,7 +54,9 @@ public:
     //! Detailed constructor
     DefaultCurve(Date asof, DefaultCurveSpec spec, const Loader& loader, const CurveConfigurations& curveConfigs,
                  map<string, boost::shared_ptr<YieldCurve>>& yieldCurves,
-                 map<string, boost::shared_ptr<DefaultCurve>>& defaultCurves);
+                 map<string, boost::shared_ptr<DefaultCurve>>& defaultCurves,
+                 //! optional snapshot from which bootstrapped curves are taken, or to which they are added
+                 const boost::shared_ptr<MarketSnapshot>& snapshot = nullptr);
     //@}
     //! \name Inspectors
     //@{
@@ -65,11 +68,13 @@ private:
     DefaultCurveSpec spec_;
     boost::shared_ptr<QuantExt::CreditCurve> curve_;
     Real recoveryRate_;
+    boost::shared_ptr<MarketSnapshot> snapshot_;
 
     //! Build a default curve from CDS spread quotes
     void buildCdsCurve(const std::string& curveID, const DefaultCurveConfig::Config& config, const QuantLib::Date& asof,
                        const DefaultCurveSpec& spec, const Loader& loader,
-                       std::map<std::string, boost::shared_ptr<YieldCurve>>& yieldCurves);
+                       std::map<std::string, boost::shared_ptr<YieldCurve>>& yieldCurves,
+                       const std::string& snapshotName);
 
     //! Build a default curve from hazard rate quotes
     void buildHazardRateCurve(const std::string& curveID, const DefaultCurveConfig::Config& config,
@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/marketsnapshot.hpp>
+
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace data {
+
+void MarketSnapshot::addYieldCurve(const std::string& curveSpecName, const std::vector<QuantLib::Date>& dates,
+                                   const std::vector<QuantLib::Real>& values) {
+    if (frozen_)
+        return;
+    QL_REQUIRE(dates.size() == values.size(), "MarketSnapshot::addYieldCurve(): dates size ("
+                                                  << dates.size() << ") does not match values size (" << values.size()
+                                                  << ") for curve '" << curveSpecName << "'");
+    yieldCurves_[curveSpecName] = CurvePillars{dates, values};
+}
+
+const MarketSnapshot::CurvePillars* MarketSnapshot::yieldCurve(const std::string& curveSpecName) const {
+    auto c = yieldCurves_.find(curveSpecName);
+    return c == yieldCurves_.end() ? nullptr : &c->second;
+}
+
+void MarketSnapshot::addDefaultCurve(const std::string& name, const std::vector<QuantLib::Date>& dates,
+                                     const std::vector<QuantLib::Real>& survivalProbabilities) {
+    if (frozen_)
+        return;
+    QL_REQUIRE(dates.size() == survivalProbabilities.size(),
+               "MarketSnapshot::addDefaultCurve(): dates size (" << dates.size()
+                                                                 << ") does not match survival probabilities size ("
+                                                                 << survivalProbabilities.size() << ") for curve '"
+                                                                 << name << "'");
+    defaultCurves_[name] = CurvePillars{dates, survivalProbabilities};
+}
+
+const MarketSnapshot::CurvePillars* MarketSnapshot::defaultCurve(const std::string& name) const {
+    auto c = defaultCurves_.find(name);
+    return c == defaultCurves_.end() ? nullptr : &c->second;
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/marketsnapshot.hpp
+    \brief snapshot of bootstrapped market objects that can be reused in further market builds
+    \ingroup marketdata
+*/
+
+#pragma once
+
+#include <ql/time/date.hpp>
+#include <ql/types.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Snapshot of bootstrapped market objects
+/*! The snapshot stores the pillar data of bootstrapped curves built by a TodaysMarket. A snapshot that is handed
+    to another TodaysMarket built from the same market data and curve configurations lets this market instantiate
+    the interpolated curves directly from the stored pillars instead of running the bootstrap again. The resulting
+    curves are identical to the bootstrapped ones.
+
+    While the snapshot is not frozen, market builds add the curves they bootstrap. Once frozen, the snapshot is
+    read-only and can be shared between several threads, e.g. the workers of the MultiThreadedValuationEngine, each
+    of which builds its own independent market from it.
+
+    Currently covered are yield curves of bootstrapped type, built without preserving the quote linkage, and single
+    name default curves of type SpreadCDS or Price. Other market objects are always built from the market data.
+*/
+class MarketSnapshot {
+public:
+    //! pillar dates and values of a curve, the interpolation variable of a yield curve or survival probabilities
+    struct CurvePillars {
+        std::vector<QuantLib::Date> dates;
+        std::vector<QuantLib::Real> values;
+    };
+
+    explicit MarketSnapshot(const QuantLib::Date& asof) : asof_(asof) {}
+
+    const QuantLib::Date& asof() const { return asof_; }
+
+    //! add the pillars of a yield curve identified by its curve spec name, ignored if the snapshot is frozen
+    void addYieldCurve(const std::string& curveSpecName, const std::vector<QuantLib::Date>& dates,
+                       const std::vector<QuantLib::Real>& values);
+
+    //! the pillars of a yield curve, or nullptr if the curve is not part of the snapshot
+    const CurvePillars* yieldCurve(const std::string& curveSpecName) const;
+
+    //! add the survival probability pillars of a default curve, ignored if the snapshot is frozen
+    void addDefaultCurve(const std::string& name, const std::vector<QuantLib::Date>& dates,
+                         const std::vector<QuantLib::Real>& survivalProbabilities);
+
+    //! the survival probability pillars of a default curve, or nullptr if the curve is not part of the snapshot
+    const CurvePillars* defaultCurve(const std::string& name) const;
+
+    //! make the snapshot read-only
+    void freeze() { frozen_ = true; }
+    bool frozen() const { return frozen_; }
+
+    //! total number of curves in the snapshot
+    QuantLib::Size size() const { return yieldCurves_.size() + defaultCurves_.size(); }
+
+private:
+    QuantLib::Date asof_;
+    bool frozen_ = false;
+    std::map<std::string, CurvePillars> yieldCurves_;
+    std::map<std::string, CurvePillars> defaultCurves_;
+};
+
+} // namespace data
+} // namespace ore
@@ -28,6 +28,7 @@
 #include <ored/marketdata/curvespec.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketimpl.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
 #include <ored/marketdata/todaysmarketcalibrationinfo.hpp>
 #include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/marketdata/dependencygraph.hpp>
@@ -103,7 +104,9 @@ public:
         //! build calibration info?
         const bool buildCalibrationInfo = true,
         //! support pseudo currencies
-        const bool handlePseudoCurrencies = true);
+        const bool handlePseudoCurrencies = true,
+        //! optional snapshot to take bootstrapped curves from, curves not in the snapshot are added to it
+        const boost::shared_ptr<MarketSnapshot>& snapshot = nullptr);
 
     boost::shared_ptr<TodaysMarketCalibrationInfo> calibrationInfo() const { return calibrationInfo_; }
 
@@ -125,6 +128,7 @@ private:
     const boost::shared_ptr<ReferenceDataManager> referenceData_;
     const IborFallbackConfig iborFallbackConfig_;
     const bool buildCalibrationInfo_;
+    const boost::shared_ptr<MarketSnapshot> snapshot_;
 
     // initialise market
     void initialise(const Date& asof);
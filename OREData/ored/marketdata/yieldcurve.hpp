@@ -33,6 +33,7 @@
 #include <ored/marketdata/fxtriangulation.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/market.hpp>
+#include <ored/marketdata/marketsnapshot.hpp>
 #include <ored/marketdata/todaysmarketcalibrationinfo.hpp>
 #include <ored/marketdata/yieldcurve.hpp>
 
@@ -106,7 +107,9 @@ public:
         //! build calibration info
         const bool buildCalibrationInfo = true,
 	//! market object to look up external discount curves
-        const Market* market = nullptr);
+        const Market* market = nullptr,
+        //! optional snapshot from which bootstrapped curves are taken, or to which they are added
+        const boost::shared_ptr<MarketSnapshot>& snapshot = nullptr);
 
     //! \name Inspectors
     //@{
@@ -164,6 +167,7 @@ private:
     const bool preserveQuoteLinkage_;
     bool buildCalibrationInfo_;
     const Market* market_;
+    boost::shared_ptr<MarketSnapshot> snapshot_;
 
     boost::shared_ptr<YieldTermStructure> piecewisecurve(vector<boost::shared_ptr<RateHelper>> instruments);
 
@@ -185,13 +185,14 @@ public:
         bool useQuadrature = parseBool(modelParameter("useQuadrature", {}, false, "false"));
         Size nBuckets = parseInteger(engineParameter("buckets"));
         bool homogeneousPoolWhenJustified = parseBool(engineParameter("homogeneousPoolWhenJustified"));
+        Size nThreads = parseInteger(engineParameter("threads", {}, false, "1"));
 
         homogeneous = homogeneous && homogeneousPoolWhenJustified;
         LOG("Use " << (homogeneous ? "" : "in") << "homogeneous pool loss model for qualifier " << qualifier);
         DLOG("useQuadrature is set to " << std::boolalpha << useQuadrature);
         return boost::make_shared<QuantExt::GaussPoolLossModel>(homogeneous, gaussLM, nBuckets, gaussCopulaMax,
                                                                 gaussCopulaMin, gaussCopulaSteps, useQuadrature,
-                                                                useStochasticRecovery);
+                                                                useStochasticRecovery, nThreads);
     }
 
 protected:
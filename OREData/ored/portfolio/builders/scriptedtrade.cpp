@@ -266,6 +266,8 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
         }
         DLOG("sobol bb ordering    = " << mcParams_.sobolOrdering);
         DLOG("sobol direction int. = " << mcParams_.sobolDirectionIntegers);
+        DLOG("vectorised path gen. = " << std::boolalpha << mcParams_.vectorisedPathGeneration);
+        DLOG("path gen. threads    = " << mcParams_.pathGenerationThreads);
     } else if (engineParam_ == "FD") {
         DLOG("stateGridPoints      = " << modelSize_);
         DLOG("mesherEpsilon        = " << mesherEpsilon_);
@@ -283,6 +285,10 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
     } else if (modelParam_ == "LocalVolAndreasenHuge") {
         DLOG("moneyness points = " << calibrationMoneyness_.size());
     }
+    if (modelParam_ == "LocalVolDupire" || modelParam_ == "LocalVolAndreasenHuge") {
+        DLOG("localVolGridSize     = " << localVolGridSize_);
+        DLOG("localVolGridStdDevs  = " << localVolGridStdDevs_);
+    }
 
     // 22 build the pricing engine and return it
 
@@ -495,6 +501,11 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
             parseListOfValues<Real>(engineParameter("CalibrationMoneyness", {resolvedProductTag_}), &parseReal);
     }
 
+    if (modelParam_ == "LocalVolDupire" || modelParam_ == "LocalVolAndreasenHuge") {
+        localVolGridSize_ = parseInteger(engineParameter("LocalVolGridSize", {resolvedProductTag_}, false, "0"));
+        localVolGridStdDevs_ = parseReal(engineParameter("LocalVolGridStdDevs", {resolvedProductTag_}, false, "5.0"));
+    }
+
     if (engineParam_ == "MC") {
         mcParams_.seed = parseInteger(engineParameter("Seed", {resolvedProductTag_}, false, "42"));
         modelSize_ = parseInteger(engineParameter("Samples", {resolvedProductTag_}));
@@ -509,6 +520,10 @@ void ScriptedTradeEngineBuilder::populateModelParameters() {
             engineParameter("SobolOrdering", {resolvedProductTag_}, false, "Steps"));
         mcParams_.sobolDirectionIntegers = parseSobolRsgDirectionIntegers(
             engineParameter("SobolDirectionIntegers", {resolvedProductTag_}, false, "JoeKuoD7"));
+        mcParams_.vectorisedPathGeneration =
+            parseBool(engineParameter("VectorisedPathGeneration", {resolvedProductTag_}, false, "false"));
+        mcParams_.pathGenerationThreads =
+            parseInteger(engineParameter("PathGenerationThreads", {resolvedProductTag_}, false, "1"));
         if (auto tmp = engineParameter("TrainingSamples", {resolvedProductTag_}, false, ""); !tmp.empty()) {
             mcParams_.trainingSamples = parseInteger(tmp);
             mcParams_.trainingSeed = parseInteger(engineParameter("TrainingSeed", {resolvedProductTag_}, false, "43"));
@@ -1200,7 +1215,8 @@ void ScriptedTradeEngineBuilder::buildLocalVol(const std::string& id, const Ibor
                                                             !calibrate_ || zeroVolatility_);
     model_ = boost::make_shared<LocalVol>(modelSize_, modelCcys_, modelCurves_, modelFxSpots_, modelIrIndices_,
                                           modelInfIndices_, modelIndices_, modelIndicesCurrencies_, builder->model(),
-                                          correlations_, mcParams_, simulationDates_, iborFallbackConfig);
+                                          correlations_, mcParams_, simulationDates_, iborFallbackConfig,
+                                          localVolGridSize_, localVolGridStdDevs_);
     modelBuilders_.insert(std::make_pair(id, builder));
 }
 
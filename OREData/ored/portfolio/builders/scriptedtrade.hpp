@@ -136,6 +136,8 @@ protected:
     Model::McParams mcParams_;
     bool interactive_, zeroVolatility_, continueOnCalibrationError_;
     std::vector<Real> calibrationMoneyness_;
+    Size localVolGridSize_ = 0;
+    Real localVolGridStdDevs_ = 5.0;
     Real mesherEpsilon_, mesherScaling_, mesherConcentration_;
     Size mesherMaxConcentratingPoints_;
     bool mesherIsStatic_;
@@ -643,12 +643,19 @@ Real NumericLgmRiskParticipationAgreementEngine::protectionLegNpv() const {
 
         auto states = stateGrid(eventTimes[i]);
 
-        // rollback underlying PV to current event date, if we are not on the latest event date
+        // rollback underlying PV components and swaption PV to current event date in one pass over the grid, if we
+        // are not on the latest event date
 
         if (i < static_cast<int>(eventDates.size()) - 1) {
-            for (auto& u : underlyingPv) {
-                u.second = rollback(u.second, eventTimes[i + 1], eventTimes[i]);
-            }
+            std::vector<const RandomVariable*> v;
+            for (auto const& u : underlyingPv)
+                v.push_back(&u.second);
+            v.push_back(&swaptionPv);
+            auto r = rollback(v, eventTimes[i + 1], eventTimes[i]);
+            Size j = 0;
+            for (auto& u : underlyingPv)
+                u.second = std::move(r[j++]);
+            swaptionPv = std::move(r[j]);
         }
 
         // move relevant PV components to index 0
@@ -660,12 +667,6 @@ Real NumericLgmRiskParticipationAgreementEngine::protectionLegNpv() const {
             }
         }
 
-        // rollback swaption PV
-
-        if (i < static_cast<int>(eventDates.size()) - 1) {
-            swaptionPv = rollback(swaptionPv, eventTimes[i + 1], eventTimes[i]);
-        }
-
         // loop over floating coupons with fixingDate == eventDate and add them to the underlyingPv
 
         for (Size k = 0; k < floatingIndices[i].size(); ++k) {
@@ -801,10 +802,10 @@ Real NumericLgmRiskParticipationAgreementEngine::protectionLegNpv() const {
 
         RandomVariable currentPositivePv = max(tmp, RandomVariable(gridSize(), 0.0));
 
-        // if on an option date, compute the option pv (as of t0)
+        // if on an option date, compute the option pv (as of t0) as the inner product with the state density
 
         if (optionDateIndex[i] != Null<Size>()) {
-            optionPv[optionDateIndex[i]] = rollback(currentPositivePv, eventTimes[i], 0.0).at(0);
+            optionPv[optionDateIndex[i]] = rollbackToZero(currentPositivePv, eventTimes[i]);
         }
 
         // loop over fixed coupons with payment == eventDate and add them to the underlying pv
@@ -824,9 +825,8 @@ Real NumericLgmRiskParticipationAgreementEngine::protectionLegNpv() const {
             underlyingPv[0] += u.second;
     }
 
-    underlyingPv[0] = rollback(underlyingPv[0], eventTimes[0], 0.0);
-
-    swaptionPv = rollback(swaptionPv, eventTimes[0], 0.0);
+    Real underlyingNpv = rollbackToZero(underlyingPv[0], eventTimes[0]);
+    Real swaptionNpv = rollbackToZero(swaptionPv, eventTimes[0]);
 
     // compute a CVA using the option pvs
 
@@ -844,8 +844,8 @@ Real NumericLgmRiskParticipationAgreementEngine::protectionLegNpv() const {
 
     results_.additionalResults["OptionNpvs"] = optionPv;
     results_.additionalResults["OptionExerciseDates"] = optionDates;
-    results_.additionalResults["UnderlyingNpv"] = underlyingPv.at(0).at(0);
-    results_.additionalResults["SwaptionNpv"] = swaptionPv.at(0);
+    results_.additionalResults["UnderlyingNpv"] = underlyingNpv;
+    results_.additionalResults["SwaptionNpv"] = swaptionNpv;
     results_.additionalResults["FXSpot"] = fxSpots_[arguments_.underlyingCcys[0]]->value();
 
     // return result
@@ -78,6 +78,11 @@ void ScriptedInstrumentPricingEngine::calculate() const {
 
     auto workingContext = boost::make_shared<Context>(*context_);
 
+    // the model might use a different size than the initial context, e.g. an fd model on a 2d mesh
+
+    if (workingContext->varSize() != model_->size())
+        workingContext->resetSize(model_->size());
+
     // set TODAY in the context
 
     checkDuplicateName(workingContext, "TODAY");
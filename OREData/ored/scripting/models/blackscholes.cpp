@@ -21,6 +21,8 @@
 #include <ored/utilities/to_string.hpp>
 #include <ored/model/utilities.hpp>
 
+#include <qle/methods/affinestateevolution.hpp>
+
 #include <ql/math/comparison.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
@@ -264,6 +266,23 @@ void BlackScholes::populatePathValues(const Size nSamples, std::map<Date, std::v
         logState0[j] = std::log(model_->processes()[j]->x0());
     }
 
+    if (mcParams_.vectorisedPathGeneration) {
+        // evolve the log states of all paths together per simulation date and exponentiate them afterwards
+        std::vector<std::vector<RandomVariable*>> output(effectiveSimulationDates_.size() - 1,
+                                                         std::vector<RandomVariable*>(indices_.size()));
+        for (Size i = 0; i < effectiveSimulationDates_.size() - 1; ++i) {
+            for (Size j = 0; j < indices_.size(); ++j)
+                output[i][j] = rvs[j][i];
+        }
+        QuantExt::evolveAffineStateVectorised(gen, nSamples, logState0, drift, {}, sqrtCov, output, 1024,
+                                              mcParams_.pathGenerationThreads);
+        for (auto& r : output) {
+            for (auto& v : r)
+                *v = exp(*v);
+        }
+        return;
+    }
+
     for (Size path = 0; path < nSamples; ++path) {
         auto seq = gen->next();
         logState = logState0;
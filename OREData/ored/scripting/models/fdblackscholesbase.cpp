@@ -19,6 +19,7 @@
 #include <ored/scripting/models/fdblackscholesbase.hpp>
 #include <ored/scripting/utilities.hpp>
 
+#include <qle/methods/fdm2dblackscholesop.hpp>
 #include <qle/methods/fdmblackscholesmesher.hpp>
 #include <qle/methods/fdmblackscholesop.hpp>
 
@@ -31,6 +32,7 @@
 #include <qle/cashflows/overnightindexedcoupon.hpp>
 
 #include <ql/math/comparison.hpp>
+#include <ql/math/interpolations/bicubicsplineinterpolation.hpp>
 #include <ql/math/interpolations/cubicinterpolation.hpp>
 #include <ql/methods/finitedifferences/meshers/fdmmeshercomposite.hpp>
 #include <ql/quotes/simplequote.hpp>
@@ -129,19 +131,33 @@ FdBlackScholesBase::FdBlackScholesBase(
                     quantoTargetCcyIndex_ =
                         std::distance(currencies.begin(), std::find(currencies.begin(), currencies.end(), payCcy));
                     quantoCorrelationMultiplier_ = ccy2 == payCcy ? 1.0 : -1.0;
+                    DLOG("FdBlackScholesBase model will be run for index '"
+                         << indices_[0].name() << "' with a quanto-adjustment " << currencies_[quantoSourceCcyIndex_]
+                         << " => " << currencies_[quantoTargetCcyIndex_] << " derived from index '"
+                         << indices_[1].name() << "'");
+                    return;
                 }
-                DLOG("FdBlackScholesBase model will be run for index '"
-                     << indices_[0].name() << "' with a quanto-adjustment " << currencies_[quantoSourceCcyIndex_]
-                     << " => " << currencies_[quantoTargetCcyIndex_] << " derived from index '" << indices_[1].name()
-                     << "'");
-                return;
             }
         }
+
+        // otherwise we solve a 2d pde, for this both underlyings must be denominated in the base ccy
+
+        for (Size i = 0; i < 2; ++i) {
+            std::string ccy = indices_[i].isFx() ? indices_[i].fx()->targetCurrency().code() : indexCurrencies_[i];
+            QL_REQUIRE(ccy == currencies_.front(), "FdBlackScholesBase: index '"
+                                                       << indices_[i].name() << "' has currency " << ccy
+                                                       << ", this must be equal to the model base ccy "
+                                                       << currencies_.front() << " for a 2d fd scheme");
+        }
+        twoDimensional_ = true;
+        DLOG("FdBlackScholesBase model will be run on a 2d mesh for indices '" << indices_[0].name() << "' and '"
+                                                                                << indices_[1].name() << "'");
+        return;
     }
 
-    // otherwise we need more than one dimension, which we currently not support
+    // otherwise we need more than two dimensions, which we currently not support
 
-    QL_FAIL("FdBlackScholesBase: model does not support multi-dim fd schemes currently.");
+    QL_FAIL("FdBlackScholesBase: model does not support fd schemes with more than two dimensions currently.");
 
 } // FdBlackScholesBase ctor
 
@@ -165,6 +181,8 @@ Matrix FdBlackScholesBase::getCorrelation() const {
     return correlation;
 }
 
+Size FdBlackScholesBase::size() const { return twoDimensional_ ? Model::size() * Model::size() : Model::size(); }
+
 const Date& FdBlackScholesBase::referenceDate() const {
     calculate();
     return referenceDate_;
@@ -195,8 +213,12 @@ void FdBlackScholesBase::performCalculations() const {
 
     // 0c if we only have one effective sim date (today), we set the underlying values = spot
 
+    Size nDim = twoDimensional_ ? 2 : 1;
+
     if (effectiveSimulationDates_.size() == 1) {
-        underlyingValues_ = RandomVariable(size(), model_->processes()[0]->x0());
+        underlyingValues_.clear();
+        for (Size i = 0; i < nDim; ++i)
+            underlyingValues_.push_back(RandomVariable(size(), model_->processes()[i]->x0()));
         return;
     }
 
@@ -238,13 +260,17 @@ void FdBlackScholesBase::performCalculations() const {
     // 2 set up mesher if we do not have one already or if we want to rebuild it every time
 
     if (mesher_ == nullptr || !staticMesher_) {
-        mesher_ = boost::make_shared<FdmMesherComposite>(boost::make_shared<QuantExt::FdmBlackScholesMesher>(
-            size(), model_->processes()[0], timeGrid_.back(),
-            calibrationStrikes[0] == Null<Real>()
-                ? atmForward(model_->processes()[0]->x0(), model_->processes()[0]->riskFreeRate(),
-                             model_->processes()[0]->dividendYield(), timeGrid_.back())
-                : calibrationStrikes[0],
-            Null<Real>(), Null<Real>(), mesherEpsilon_, mesherScaling_, cPoints[0]));
+        std::vector<boost::shared_ptr<Fdm1dMesher>> meshers;
+        for (Size i = 0; i < nDim; ++i) {
+            auto p = model_->processes()[i];
+            meshers.push_back(boost::make_shared<QuantExt::FdmBlackScholesMesher>(
+                Model::size(), p, timeGrid_.back(),
+                calibrationStrikes[i] == Null<Real>()
+                    ? atmForward(p->x0(), p->riskFreeRate(), p->dividendYield(), timeGrid_.back())
+                    : calibrationStrikes[i],
+                Null<Real>(), Null<Real>(), mesherEpsilon_, mesherScaling_, cPoints[i]));
+        }
+        mesher_ = boost::make_shared<FdmMesherComposite>(meshers);
     }
 
     // 3 set up operator using atmf vol and without discounting, floor forward variances at zero
@@ -259,19 +285,28 @@ void FdBlackScholesBase::performCalculations() const {
             true);
     }
 
-    operator_ =
-        boost::make_shared<QuantExt::FdmBlackScholesOp>(mesher_, model_->processes()[0], calibrationStrikes[0], false,
-                                                        -static_cast<Real>(Null<Real>()), 0, quantoHelper, false, true);
+    if (twoDimensional_) {
+        operator_ = boost::make_shared<QuantExt::Fdm2dBlackScholesOp>(
+            mesher_, model_->processes()[0], model_->processes()[1], getCorrelation()[0][1], calibrationStrikes[0],
+            calibrationStrikes[1], false, true);
+    } else {
+        operator_ = boost::make_shared<QuantExt::FdmBlackScholesOp>(mesher_, model_->processes()[0],
+                                                                    calibrationStrikes[0], false,
+                                                                    -static_cast<Real>(Null<Real>()), 0, quantoHelper,
+                                                                    false, true);
+    }
 
-    // 4 set up bwd solver, hardcoded Douglas scheme (= CrankNicholson)
+    // 4 set up bwd solver, hardcoded Douglas scheme (= CrankNicholson) in 1d, Hundsdorfer-Verwer in 2d
 
     solver_ = boost::make_shared<FdmBackwardSolver>(
-        operator_, std::vector<boost::shared_ptr<BoundaryCondition<FdmLinearOp>>>(), nullptr, FdmSchemeDesc::Douglas());
+        operator_, std::vector<boost::shared_ptr<BoundaryCondition<FdmLinearOp>>>(), nullptr,
+        twoDimensional_ ? FdmSchemeDesc::Hundsdorfer() : FdmSchemeDesc::Douglas());
 
-    // 5 fill random variable with underlying values, these are valid for all times
+    // 5 fill random variables with underlying values, these are valid for all times
 
-    auto locations = mesher_->locations(0);
-    underlyingValues_ = exp(RandomVariable(locations));
+    underlyingValues_.clear();
+    for (Size i = 0; i < nDim; ++i)
+        underlyingValues_.push_back(exp(RandomVariable(mesher_->locations(i))));
 
     // set additional results provided by this model
 
@@ -280,6 +315,9 @@ void FdBlackScholesBase::performCalculations() const {
             (calibrationStrikes[i] == Null<Real>() ? "ATMF" : std::to_string(calibrationStrikes[i]));
     }
 
+    if (twoDimensional_)
+        additionalResults_["FdBlackScholes.Correlation"] = getCorrelation()[0][1];
+
     for (Size i = 0; i < indices_.size(); ++i) {
         Size timeStep = 0;
         for (auto const& d : effectiveSimulationDates_) {
@@ -301,7 +339,9 @@ void FdBlackScholesBase::performCalculations() const {
 
 RandomVariable FdBlackScholesBase::getIndexValue(const Size indexNo, const Date& d, const Date& fwd) const {
 
-    QL_REQUIRE(indexNo == 0, "FdBlackScholesBase::getIndexValue(): indexNo (" << indexNo << ") must be 0");
+    QL_REQUIRE(indexNo < underlyingValues_.size(), "FdBlackScholesBase::getIndexValue(): indexNo ("
+                                                       << indexNo << ") must be less than "
+                                                       << underlyingValues_.size());
 
     // determine the effective forward date (if applicable)
 
@@ -319,7 +359,7 @@ RandomVariable FdBlackScholesBase::getIndexValue(const Size indexNo, const Date&
 
     // init the result with the underlying values themselves
 
-    RandomVariable res(underlyingValues_);
+    RandomVariable res(underlyingValues_[indexNo]);
 
     // compute forwarding factor and multiply the result by this factor
 
@@ -473,11 +513,28 @@ Real FdBlackScholesBase::extractT0Result(const RandomVariable& value) const {
     if (r.deterministic())
         return r.at(0);
 
-    // otherwise interpolate the result at the spot of the underlying process
+    // otherwise interpolate the result at the spot of the underlying process(es)
+
+    if (twoDimensional_) {
+        // the mesher layout is such that the first direction runs fastest
+        Size n = Model::size();
+        Array x(n), y(n);
+        Matrix z(n, n);
+        for (Size i = 0; i < n; ++i) {
+            x[i] = underlyingValues_[0].at(i);
+            y[i] = underlyingValues_[1].at(i * n);
+        }
+        for (Size j = 0; j < n; ++j)
+            for (Size i = 0; i < n; ++i)
+                z[j][i] = r.at(i + j * n);
+        BicubicSpline interpolation(x.begin(), x.end(), y.begin(), y.end(), z);
+        interpolation.enableExtrapolation();
+        return interpolation(model_->processes()[0]->x0(), model_->processes()[1]->x0());
+    }
 
-    Array x(underlyingValues_.size());
-    Array y(underlyingValues_.size());
-    underlyingValues_.copyToArray(x);
+    Array x(underlyingValues_[0].size());
+    Array y(underlyingValues_[0].size());
+    underlyingValues_[0].copyToArray(x);
     r.copyToArray(y);
     MonotonicCubicNaturalSpline interpolation(x.begin(), x.end(), y.begin());
     interpolation.enableExtrapolation();
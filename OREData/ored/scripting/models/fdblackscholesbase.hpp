@@ -37,8 +37,11 @@
 namespace ore {
 namespace data {
 
-/* At the moment this is the FD Black Scholes model class, restricted to one underlying. TODOs:
-   - extend to several underlyings,
+/* At the moment this is the FD Black Scholes model class, restricted to one or two underlyings. For two underlyings
+   (without a quanto adjustment, see below) a two dimensional PDE is solved on a log-spot mesh with stateGridPoints
+   points in each direction, using a Hundsdorfer-Verwer ADI scheme; in this case both underlyings must be denominated
+   in the model's base ccy and the random variables of the model have size stateGridPoints^2. TODOs:
+   - extend to more than two underlyings,
    - cover both black scholes and local vol models
    - refactor with BlackScholesBase, there is quite a bit of code duplication */
 class FdBlackScholesBase : public ModelImpl {
@@ -73,6 +76,7 @@ public:
 
     // Model interface implementation
     Type type() const override { return Type::FD; }
+    Size size() const override;
     const Date& referenceDate() const override;
     RandomVariable npv(const RandomVariable& amount, const Date& obsdate, const Filter& filter,
                        const boost::optional<long>& memSlot, const RandomVariable& addRegressor1,
@@ -123,6 +127,9 @@ protected:
     Size quantoSourceCcyIndex_, quantoTargetCcyIndex_;
     Real quantoCorrelationMultiplier_;
 
+    // true if we solve a 2d pde for two underlyings
+    bool twoDimensional_ = false;
+
     // these are all initialised when the interface functions above are called
     mutable std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>> basisFns_;
     mutable Date referenceDate_;                      // the model reference date
@@ -132,7 +139,7 @@ protected:
     mutable boost::shared_ptr<FdmMesher> mesher_;     // the mesher for the FD solver
     mutable boost::shared_ptr<FdmLinearOpComposite> operator_; // the operator
     mutable boost::shared_ptr<FdmBackwardSolver> solver_;      // the sovler
-    mutable RandomVariable underlyingValues_;                  // the discretised underlying
+    mutable std::vector<RandomVariable> underlyingValues_;     // the discretised underlying(s)
 };
 
 } // namespace data
@@ -20,6 +20,7 @@
 #include <qle/models/infdkvectorised.hpp>
 
 #include <qle/math/randomvariablelsmbasissystem.hpp>
+#include <qle/methods/affinestateevolution.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 
 #include <ored/utilities/indexparser.hpp>
@@ -273,6 +274,20 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
                                           times.size() - 1, isTraining ? mcParams_.trainingSeed : mcParams_.seed,
                                           mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers);
 
+        if (mcParams_.vectorisedPathGeneration) {
+            std::vector<Array> drift(times.size() - 1, Array(1, 0.0));
+            std::vector<Matrix> diffusion(times.size() - 1, Matrix(1, 1));
+            std::vector<std::vector<RandomVariable*>> output(times.size() - 1);
+            auto date = effectiveSimulationDates_.begin();
+            for (Size i = 0; i < times.size() - 1; ++i) {
+                diffusion[i][0][0] = stdDevs[i];
+                output[i].push_back(&irStates[*(++date)][0]);
+            }
+            evolveAffineStateVectorised(gen, nSamples, Array(1, 0.0), drift, {}, diffusion, output, 1024,
+                                        mcParams_.pathGenerationThreads);
+            return;
+        }
+
         for (auto s = std::next(irStates.begin(), 1); s != irStates.end(); ++s)
             for (auto& r : s->second)
                 r.expand();
@@ -292,6 +307,12 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
 
         // case process size > 1 or we have injected paths, we use the normal process interface to evolve the process
 
+        if (injectedPathTimes_ == nullptr && mcParams_.vectorisedPathGeneration &&
+            cam_->discretization() == CrossAssetModel::Discretization::Exact) {
+            populatePathValuesVectorised(nSamples, paths, irStates, infStates, isTraining);
+            return;
+        }
+
         boost::shared_ptr<MultiPathGeneratorBase> pathGen;
 
         // build a temporary repository of the state prcess values, since we want to access them not path by path
@@ -416,6 +437,59 @@ void GaussianCam::populatePathValues(const Size nSamples, std::map<Date, std::ve
     }
 }
 
+void GaussianCam::populatePathValuesVectorised(
+    const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
+    std::map<Date, std::vector<RandomVariable>>& irStates,
+    std::map<Date, std::vector<std::pair<RandomVariable, RandomVariable>>>& infStates, const bool isTraining) const {
+
+    auto process = boost::dynamic_pointer_cast<CrossAssetStateProcess>(cam_->stateProcess());
+    QL_REQUIRE(process, "GaussianCam::populatePathValuesVectorised(): expected CrossAssetStateProcess");
+
+    // for the exact discretisation the state process evolves as x_{i+1} = a_i + B_i x_i + D_i z_i
+
+    Size steps = timeGrid_.size() - 1;
+    std::vector<Array> a(steps);
+    std::vector<Matrix> B(steps), D(steps);
+    Array x0 = process->initialValues();
+    process->resetCache(steps);
+    for (Size i = 0; i < steps; ++i) {
+        std::tie(a[i], B[i]) = process->affineExpectation(timeGrid_[i], timeGrid_.dt(i));
+        D[i] = process->stdDeviation(timeGrid_[i], x0, timeGrid_.dt(i));
+    }
+
+    // the states relevant on the effective simulation dates are written directly to the target random variables
+
+    std::vector<std::vector<RandomVariable*>> output(steps);
+    auto date = effectiveSimulationDates_.begin();
+    for (Size j = 1; j < effectiveSimulationDates_.size(); ++j) {
+        ++date;
+        auto& o = output[positionInTimeGrid_[j] - 1];
+        o.resize(process->size(), nullptr);
+        for (Size k = 0; k < indices_.size(); ++k)
+            o[indexPositionInProcess_[k]] = &paths[*date][k];
+        for (Size k = 0; k < currencies_.size(); ++k)
+            o[currencyPositionInProcess_[k]] = &irStates[*date][k];
+        for (Size k = 0; k < infIndices_.size(); ++k) {
+            o[infIndexPositionInProcess_[k]] = &infStates[*date][k].first;
+            o[infIndexPositionInProcess_[k] + 1] = &infStates[*date][k].second;
+        }
+    }
+
+    auto gen = makeMultiPathVariateGenerator(isTraining ? mcParams_.trainingSequenceType : mcParams_.sequenceType,
+                                             process->factors(), steps,
+                                             isTraining ? mcParams_.trainingSeed : mcParams_.seed,
+                                             mcParams_.sobolOrdering, mcParams_.sobolDirectionIntegers);
+
+    evolveAffineStateVectorised(gen, nSamples, x0, a, B, D, output, 1024, mcParams_.pathGenerationThreads);
+
+    // FX and EQ states are log spots
+
+    for (auto d = std::next(effectiveSimulationDates_.begin()); d != effectiveSimulationDates_.end(); ++d) {
+        for (Size k = 0; k < indices_.size(); ++k)
+            paths[*d][k] = exp(paths[*d][k]);
+    }
+}
+
 RandomVariable GaussianCam::getIndexValue(const Size indexNo, const Date& d, const Date& fwd) const {
     auto res = underlyingPaths_.at(d).at(indexNo);
     // compute forwarding factor
@@ -100,6 +100,11 @@ private:
                             std::map<Date, std::vector<RandomVariable>>& irStates,
                             std::map<Date, std::vector<std::pair<RandomVariable, RandomVariable>>>& infStates,
                             const std::vector<Real>& times, const bool isTraining) const;
+    // evolves all samples together per time step, requires the exact discretization of the cam state process
+    void populatePathValuesVectorised(
+        const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
+        std::map<Date, std::vector<RandomVariable>>& irStates,
+        std::map<Date, std::vector<std::pair<RandomVariable, RandomVariable>>>& infStates, const bool isTraining) const;
     // input parameters
     const Handle<CrossAssetModel> cam_;
     const std::vector<Handle<YieldTermStructure>> curves_;
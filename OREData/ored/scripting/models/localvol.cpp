@@ -34,9 +34,10 @@ using namespace QuantExt;
 LocalVol::LocalVol(const Size paths, const std::string& currency, const Handle<YieldTermStructure>& curve,
                    const std::string& index, const std::string& indexCurrency,
                    const Handle<BlackScholesModelWrapper>& model, const McParams& mcParams,
-                   const std::set<Date>& simulationDates, const IborFallbackConfig& iborFallbackConfig)
+                   const std::set<Date>& simulationDates, const IborFallbackConfig& iborFallbackConfig,
+                   const Size localVolGridSize, const Real localVolGridStdDevs)
     : LocalVol(paths, {currency}, {curve}, {}, {}, {}, {index}, {indexCurrency}, model, {}, mcParams, simulationDates,
-               iborFallbackConfig) {}
+               iborFallbackConfig, localVolGridSize, localVolGridStdDevs) {}
 
 LocalVol::LocalVol(
     const Size paths, const std::vector<std::string>& currencies, const std::vector<Handle<YieldTermStructure>>& curves,
@@ -46,9 +47,16 @@ LocalVol::LocalVol(
     const std::vector<std::string>& indices, const std::vector<std::string>& indexCurrencies,
     const Handle<BlackScholesModelWrapper>& model,
     const std::map<std::pair<std::string, std::string>, Handle<QuantExt::CorrelationTermStructure>>& correlations,
-    const McParams& mcParams, const std::set<Date>& simulationDates, const IborFallbackConfig& iborFallbackConfig)
+    const McParams& mcParams, const std::set<Date>& simulationDates, const IborFallbackConfig& iborFallbackConfig,
+    const Size localVolGridSize, const Real localVolGridStdDevs)
     : BlackScholesBase(paths, currencies, curves, fxSpots, irIndices, infIndices, indices, indexCurrencies, model,
-                       correlations, mcParams, simulationDates, iborFallbackConfig) {}
+                       correlations, mcParams, simulationDates, iborFallbackConfig),
+      localVolGridSize_(localVolGridSize), localVolGridStdDevs_(localVolGridStdDevs) {
+    QL_REQUIRE(localVolGridSize_ == 0 || localVolGridSize_ >= 2,
+               "LocalVol: localVolGridSize (" << localVolGridSize_ << ") must be 0 or >= 2");
+    QL_REQUIRE(localVolGridStdDevs_ > 0.0,
+               "LocalVol: localVolGridStdDevs (" << localVolGridStdDevs_ << ") must be positive");
+}
 
 void LocalVol::performCalculations() const {
 
@@ -129,6 +137,27 @@ void LocalVol::performCalculations() const {
         sqrtdt[i] = std::sqrt(dt[i]);
     }
 
+    // if the local vol grid is used, precompute it and evolve the process on it
+
+    if (localVolGridSize_ > 0) {
+        LocalVolGrid grid = buildLocalVolGrid(deterministicDrift, t);
+        populatePathValuesOnGrid(size(), underlyingPaths_,
+                                 makeMultiPathVariateGenerator(mcParams_.sequenceType, indices_.size(),
+                                                               timeGrid_.size() - 1, mcParams_.seed,
+                                                               mcParams_.sobolOrdering,
+                                                               mcParams_.sobolDirectionIntegers),
+                                 correlation, sqrtCorr, deterministicDrift, eqComIdx, dt, sqrtdt, grid);
+        if (trainingSamples() != Null<Size>()) {
+            populatePathValuesOnGrid(trainingSamples(), underlyingPathsTraining_,
+                                     makeMultiPathVariateGenerator(mcParams_.trainingSequenceType, indices_.size(),
+                                                                   timeGrid_.size() - 1, mcParams_.trainingSeed,
+                                                                   mcParams_.sobolOrdering,
+                                                                   mcParams_.sobolDirectionIntegers),
+                                     correlation, sqrtCorr, deterministicDrift, eqComIdx, dt, sqrtdt, grid);
+        }
+        return;
+    }
+
     // evolve the process using correlated normal variates and set the underlying path values
 
     populatePathValues(size(), underlyingPaths_,
@@ -213,6 +242,198 @@ void LocalVol::populatePathValues(const Size nSamples, std::map<Date, std::vecto
     }
 } // populatePathValues()
 
+LocalVol::LocalVolGrid LocalVol::buildLocalVolGrid(const std::vector<Array>& deterministicDrift,
+                                                   const std::vector<Real>& t) const {
+
+    LocalVolGrid grid;
+    grid.xMin.resize(indices_.size());
+    grid.dx.resize(indices_.size());
+    grid.vol.resize(indices_.size(), std::vector<Real>(t.size() * localVolGridSize_, 0.0));
+
+    Real T = timeGrid_.back();
+
+    for (Size j = 0; j < indices_.size(); ++j) {
+
+        auto const& process = model_->processes()[j];
+
+        // the log-spot grid covers the range of the deterministic forward plus / minus a number of atm std devs
+
+        Real logSpot = std::log(process->x0());
+        Real minDrift = 0.0, maxDrift = 0.0, cumDrift = 0.0;
+        for (Size i = 0; i < deterministicDrift.size(); ++i) {
+            cumDrift += deterministicDrift[i][j];
+            minDrift = std::min(minDrift, cumDrift);
+            maxDrift = std::max(maxDrift, cumDrift);
+        }
+        Real atmVol = 0.0;
+        try {
+            atmVol = process->blackVolatility()->blackVol(T, process->x0() * std::exp(cumDrift));
+        } catch (...) {
+        }
+        if (!std::isfinite(atmVol))
+            atmVol = 0.0;
+        Real width = localVolGridStdDevs_ * std::max(atmVol, 0.01) * std::sqrt(T);
+        grid.xMin[j] = logSpot + minDrift - width;
+        grid.dx[j] = (maxDrift - minDrift + 2.0 * width) / static_cast<Real>(localVolGridSize_ - 1);
+
+        for (Size i = 0; i < t.size(); ++i) {
+
+            // evaluate the local variance, localVol might throw / return nan, inf, mark these points as invalid
+
+            Real* v = &grid.vol[j][i * localVolGridSize_];
+            std::vector<bool> valid(localVolGridSize_, false);
+            for (Size k = 0; k < localVolGridSize_; ++k) {
+                Real vol = Null<Real>();
+                try {
+                    vol = process->localVolatility()->localVol(t[i], std::exp(grid.xMin[j] + k * grid.dx[j]));
+                } catch (...) {
+                }
+                if (vol != Null<Real>() && std::isfinite(vol) && vol >= 0.0) {
+                    v[k] = vol * vol;
+                    valid[k] = true;
+                }
+            }
+
+            // fill invalid points by linear interpolation of the local variance between the adjacent valid points,
+            // extrapolate flat; if there are no valid points at all, use the previous time slice or zero
+
+            Size firstValid = std::distance(valid.begin(), std::find(valid.begin(), valid.end(), true));
+            if (firstValid == localVolGridSize_) {
+                for (Size k = 0; k < localVolGridSize_; ++k)
+                    v[k] = i == 0 ? 0.0 : v[k - localVolGridSize_];
+            } else {
+                Size lastValid = firstValid;
+                for (Size k = 0; k < localVolGridSize_; ++k) {
+                    if (valid[k]) {
+                        for (Size l = lastValid + 1; l < k; ++l)
+                            v[l] = v[lastValid] + (v[k] - v[lastValid]) * static_cast<Real>(l - lastValid) /
+                                                      static_cast<Real>(k - lastValid);
+                        lastValid = k;
+                    }
+                }
+                for (Size k = 0; k < firstValid; ++k)
+                    v[k] = v[firstValid];
+                for (Size k = lastValid + 1; k < localVolGridSize_; ++k)
+                    v[k] = v[lastValid];
+            }
+
+            // smooth the local variance in the spot direction with a (1,2,1) filter, this removes spikes from the
+            // numerical differentiation in the Dupire formula and keeps the local variance non-negative
+
+            std::vector<Real> tmp(v, v + localVolGridSize_);
+            for (Size k = 1; k < localVolGridSize_ - 1; ++k)
+                v[k] = 0.25 * (tmp[k - 1] + 2.0 * tmp[k] + tmp[k + 1]);
+
+            // convert back to vol
+
+            for (Size k = 0; k < localVolGridSize_; ++k)
+                v[k] = std::sqrt(v[k]);
+        }
+    }
+
+    return grid;
+}
+
+void LocalVol::populatePathValuesOnGrid(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
+                                        const boost::shared_ptr<MultiPathVariateGeneratorBase>& gen,
+                                        const Matrix& correlation, const Matrix& sqrtCorr,
+                                        const std::vector<Array>& deterministicDrift,
+                                        const std::vector<Size>& eqComIdx, const std::vector<Real>& dt,
+                                        const std::vector<Real>& sqrtdt, const LocalVolGrid& grid) const {
+
+    // we generate the variates for a block of paths and then evolve all paths of the block together step by step,
+    // the block size limits the memory needed to store the variates
+
+    constexpr Size blockSize = 1024;
+
+    Size nSteps = timeGrid_.size() - 1;
+    Size nIndices = indices_.size();
+
+    std::vector<std::vector<RandomVariable*>> rvs(nIndices,
+                                                  std::vector<RandomVariable*>(effectiveSimulationDates_.size() - 1));
+    auto date = effectiveSimulationDates_.begin();
+    for (Size i = 0; i < effectiveSimulationDates_.size() - 1; ++i) {
+        ++date;
+        for (Size j = 0; j < nIndices; ++j) {
+            rvs[j][i] = &paths[*date][j];
+            rvs[j][i]->expand();
+        }
+    }
+
+    // variates[i * nIndices + k][p] is the variate for time step i, factor k, path p in the current block
+
+    std::vector<std::vector<Real>> variates(nSteps * nIndices, std::vector<Real>(blockSize));
+    std::vector<std::vector<Real>> logState(nIndices, std::vector<Real>(blockSize)),
+        vol(nIndices, std::vector<Real>(blockSize));
+
+    for (Size offset = 0; offset < nSamples; offset += blockSize) {
+
+        Size n = std::min(blockSize, nSamples - offset);
+
+        for (Size p = 0; p < n; ++p) {
+            auto seq = gen->next();
+            for (Size i = 0; i < nSteps; ++i)
+                for (Size k = 0; k < nIndices; ++k)
+                    variates[i * nIndices + k][p] = seq.value[i][k];
+        }
+
+        for (Size j = 0; j < nIndices; ++j)
+            std::fill(logState[j].begin(), logState[j].begin() + n, std::log(model_->processes()[j]->x0()));
+
+        Size dateIndex = 0;
+        auto pos = std::next(positionInTimeGrid_.begin());
+
+        for (Size i = 0; i < nSteps; ++i) {
+
+            // interpolate the local vol on the grid, flat extrapolation in log-spot
+
+            for (Size j = 0; j < nIndices; ++j) {
+                const Real* v = &grid.vol[j][i * localVolGridSize_];
+                for (Size p = 0; p < n; ++p) {
+                    Real x = std::min(std::max((logState[j][p] - grid.xMin[j]) / grid.dx[j], 0.0),
+                                      static_cast<Real>(localVolGridSize_ - 1));
+                    Size k = std::min(static_cast<Size>(x), localVolGridSize_ - 2);
+                    Real w = x - static_cast<Real>(k);
+                    vol[j][p] = (1.0 - w) * v[k] + w * v[k + 1];
+                }
+            }
+
+            // update the states, the loop order ensures that all vols are computed from the states at t_i
+
+            for (Size j = 0; j < nIndices; ++j) {
+                Real* x = logState[j].data();
+                const Real* volj = vol[j].data();
+                Real drift = deterministicDrift[i][j];
+                for (Size p = 0; p < n; ++p) {
+                    Real dw = 0.0;
+                    for (Size k = 0; k < nIndices; ++k)
+                        dw += sqrtCorr[j][k] * variates[i * nIndices + k][p];
+                    x[p] += volj[p] * dw * sqrtdt[i] - 0.5 * volj[p] * volj[p] * dt[i] + drift;
+                }
+                // drift adjustment for eq / com indices that are not in base ccy
+                if (eqComIdx[j] != Null<Size>()) {
+                    const Real* volIdx = vol[eqComIdx[j]].data();
+                    Real c = correlation[eqComIdx[j]][j] * dt[i];
+                    for (Size p = 0; p < n; ++p)
+                        x[p] -= c * volIdx[p] * volj[p];
+                }
+            }
+
+            // on the effective simulation dates populate the underlying paths
+
+            if (i + 1 == *pos) {
+                for (Size j = 0; j < nIndices; ++j) {
+                    Real* target = rvs[j][dateIndex]->data() + offset;
+                    for (Size p = 0; p < n; ++p)
+                        target[p] = std::exp(logState[j][p]);
+                }
+                ++dateIndex;
+                ++pos;
+            }
+        }
+    }
+} // populatePathValuesOnGrid()
+
 RandomVariable LocalVol::getFutureBarrierProb(const std::string& index, const Date& obsdate1, const Date& obsdate2,
                                               const RandomVariable& barrier, const bool above) const {
     QL_FAIL("getFutureBarrierProb not implemented by LocalVol");
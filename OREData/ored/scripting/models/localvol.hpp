@@ -37,6 +37,10 @@ public:
        - calibrationMoneyness: a vector of relative forward atm moneyness used to calibrate the Andrease-Huge volatility
          surface to
        - we assume that the given correlations are constant and read the value only at t = 0
+       - localVolGridSize: if > 0, the local vol is precomputed on the refined time grid x a uniform log-spot grid
+         with this number of points per underlying, and paths are evolved in blocks using linear interpolation
+         on this grid; if 0, the local vol is evaluated on each path directly
+       - localVolGridStdDevs: the log-spot grid covers this number of atm standard deviations around the spot
     */
     LocalVol(
         const Size paths, const std::vector<std::string>& currencies,
@@ -47,13 +51,15 @@ public:
         const Handle<BlackScholesModelWrapper>& model,
         const std::map<std::pair<std::string, std::string>, Handle<QuantExt::CorrelationTermStructure>>& correlations,
         const McParams& mcparams, const std::set<Date>& simulationDates,
-        const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig());
+        const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
+        const Size localVolGridSize = 0, const Real localVolGridStdDevs = 5.0);
 
     // ctor for a single underlying
     LocalVol(const Size paths, const std::string& currency, const Handle<YieldTermStructure>& curve,
              const std::string& index, const std::string& indexCurrency, const Handle<BlackScholesModelWrapper>& model,
              const McParams& mcparams, const std::set<Date>& simulationDates,
-             const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig());
+             const IborFallbackConfig& iborFallbackConfig = IborFallbackConfig::defaultConfig(),
+             const Size localVolGridSize = 0, const Real localVolGridStdDevs = 5.0);
 
 private:
     // ModelImpl interface implementation
@@ -69,6 +75,27 @@ private:
                             const Matrix& sqrtCorr, const std::vector<Array>& deterministicDrift,
                             const std::vector<Size>& eqComIdx, const std::vector<Real>& t, const std::vector<Real>& dt,
                             const std::vector<Real>& sqrtdt) const;
+
+    /* precomputed local vol on the refined time grid x a uniform log-spot grid, for each underlying j the vol at
+       time step i and log-spot xMin[j] + k * dx[j] is stored in vol[j][i * localVolGridSize_ + k] */
+    struct LocalVolGrid {
+        std::vector<Real> xMin, dx;
+        std::vector<std::vector<Real>> vol;
+    };
+
+    // helper method to build the local vol grid
+    LocalVolGrid buildLocalVolGrid(const std::vector<Array>& deterministicDrift, const std::vector<Real>& t) const;
+
+    // helper method to populate path values using the precomputed local vol grid, evolving blocks of paths
+    void populatePathValuesOnGrid(const Size nSamples, std::map<Date, std::vector<RandomVariable>>& paths,
+                                  const boost::shared_ptr<MultiPathVariateGeneratorBase>& gen,
+                                  const Matrix& correlation, const Matrix& sqrtCorr,
+                                  const std::vector<Array>& deterministicDrift, const std::vector<Size>& eqComIdx,
+                                  const std::vector<Real>& dt, const std::vector<Real>& sqrtdt,
+                                  const LocalVolGrid& grid) const;
+
+    const Size localVolGridSize_;
+    const Real localVolGridStdDevs_;
 };
 
 } // namespace data
@@ -57,6 +57,10 @@ public:
         QuantLib::LsmBasisSystem::PolynomialType polynomType = QuantLib::LsmBasisSystem::PolynomialType::Monomial;
         QuantLib::SobolBrownianGenerator::Ordering sobolOrdering = QuantLib::SobolBrownianGenerator::Steps;
         QuantLib::SobolRsg::DirectionIntegers sobolDirectionIntegers = QuantLib::SobolRsg::DirectionIntegers::JoeKuoD7;
+        // evolve all samples together per time step instead of path by path, where the model supports this
+        bool vectorisedPathGeneration = false;
+        // number of threads used for the vectorised path generation
+        Size pathGenerationThreads = 1;
     };
 
     explicit Model(const Size n) : n_(n) {}
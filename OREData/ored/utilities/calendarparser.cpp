@@ -76,10 +76,19 @@ QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name) const
         calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), "JoinBusinessDays"),
                             calendarNames.end());
         calendarNames.erase(std::remove(calendarNames.begin(), calendarNames.end(), ""), calendarNames.end());
+        for (auto& c : calendarNames)
+            boost::trim(c);
+        // Have we built this joint calendar already?
+        std::string jointName = boost::algorithm::join(calendarNames, ",");
+        {
+            boost::shared_lock<boost::shared_mutex> jointLock(jointMutex_);
+            auto j = jointCalendars_.find(jointName);
+            if (j != jointCalendars_.end())
+                return j->second;
+        }
         // Populate a vector of calendars.
         std::vector<QuantLib::Calendar> calendars;
         for (Size i = 0; i < calendarNames.size(); i++) {
-            boost::trim(calendarNames[i]);
             try {
                 calendars.push_back(parseCalendar(calendarNames[i]));
             } catch (std::exception& e) {
@@ -88,10 +97,24 @@ QuantLib::Calendar CalendarParser::parseCalendar(const std::string& name) const
                 QL_FAIL("Cannot convert \"" << name << "\" to Calendar [unhandled exception]");
             }
         }
-        return QuantExt::LargeJointCalendar(calendars);
+        QuantLib::Calendar joint = QuantExt::LargeJointCalendar(calendars, QuantLib::JoinHolidays,
+                                                                jointCalendarFirstYear_, jointCalendarLastYear_);
+        boost::unique_lock<boost::shared_mutex> jointLock(jointMutex_);
+        // another thread might have added the calendar in the meantime, then we return that one
+        return jointCalendars_.insert(std::make_pair(jointName, joint)).first->second;
     }
 }
 
+void CalendarParser::setJointCalendarYearRange(QuantLib::Year firstYear, QuantLib::Year lastYear) {
+    QL_REQUIRE(firstYear <= lastYear, "CalendarParser::setJointCalendarYearRange(): first year ("
+                                          << firstYear << ") must be <= last year (" << lastYear << ")");
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    boost::unique_lock<boost::shared_mutex> jointLock(jointMutex_);
+    jointCalendarFirstYear_ = firstYear;
+    jointCalendarLastYear_ = lastYear;
+    jointCalendars_.clear();
+}
+
 QuantLib::Calendar CalendarParser::addCalendar(const std::string baseName, std::string& newName) {
     auto cal = parseCalendar(baseName);
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
@@ -428,6 +451,9 @@ void CalendarParser::reset() {
 
     calendars_ = ref;
 
+    boost::unique_lock<boost::shared_mutex> jointLock(jointMutex_);
+    jointCalendars_.clear();
+
     // add ql calendar names
     for (auto const& c : ref) {
         calendars_[c.second.name()] = c.second;
@@ -439,6 +465,10 @@ void CalendarParser::resetAddedAndRemovedHolidays() {
     for (auto& m : calendars_) {
         m.second.resetAddedAndRemovedHolidays();
     }
+    boost::unique_lock<boost::shared_mutex> jointLock(jointMutex_);
+    for (auto& m : jointCalendars_) {
+        m.second.resetAddedAndRemovedHolidays();
+    }
 }
 
 } // namespace data
@@ -32,6 +32,9 @@
 namespace ore {
 namespace data {
 
+/*! Joint calendars (e.g. "TARGET,US,UK") are built once per name (with whitespace around the single calendar names
+    removed) and shared. Their business days are precomputed for the years in the joint calendar year range, see
+    QuantExt::LargeJointCalendar. */
 class CalendarParser : public QuantLib::Singleton<CalendarParser, std::integral_constant<bool, true>> {
 public:
     CalendarParser();
@@ -39,10 +42,15 @@ public:
     QuantLib::Calendar addCalendar(const std::string baseName, std::string& newName);
     void reset();
     void resetAddedAndRemovedHolidays();
+    //! set the year range for the precomputed business days of joint calendars, this clears the joint calendars
+    void setJointCalendarYearRange(QuantLib::Year firstYear, QuantLib::Year lastYear);
 
 private:
     mutable boost::shared_mutex mutex_;
     std::map<std::string, QuantLib::Calendar> calendars_;
+    QuantLib::Year jointCalendarFirstYear_ = 1990, jointCalendarLastYear_ = 2100;
+    mutable boost::shared_mutex jointMutex_;
+    mutable std::map<std::string, QuantLib::Calendar> jointCalendars_;
 };
 
 } // namespace data
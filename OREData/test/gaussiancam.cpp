@@ -49,9 +49,11 @@ BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(GaussianCamTest)
 
-BOOST_AUTO_TEST_CASE(testRepricingCalibrationInstruments) {
+BOOST_DATA_TEST_CASE(testRepricingCalibrationInstruments, boost::unit_test::data::make({false, true}),
+                     vectorisedPathGeneration) {
 
-    BOOST_TEST_MESSAGE("test repricing of calibration instruments in Gaussian CAM...");
+    BOOST_TEST_MESSAGE("test repricing of calibration instruments in Gaussian CAM (vectorised path generation = "
+                       << std::boolalpha << vectorisedPathGeneration << ")...");
 
     constexpr Size paths = 25000;
 
@@ -164,10 +166,13 @@ BOOST_AUTO_TEST_CASE(testRepricingCalibrationInstruments) {
         std::make_pair("EUR-EURIBOR-6M", *testMarket->iborIndex("EUR-EURIBOR-6M"))};
     std::vector<std::string> indices = {"FX-GENERIC-USD-EUR", "EQ-SP5"};
     std::vector<std::string> indexCurrencies = {"USD", "USD"};
+    Model::McParams mcParams;
+    mcParams.vectorisedPathGeneration = vectorisedPathGeneration;
+    mcParams.pathGenerationThreads = vectorisedPathGeneration ? 2 : 1;
     auto gaussianCam = boost::make_shared<GaussianCam>(
         model, paths, modelCcys, modelCurves, modelFxSpots, irIndices,
         std::vector<std::pair<std::string, boost::shared_ptr<ZeroInflationIndex>>>(), indices, indexCurrencies,
-        std::set<Date>(calibrationExpiries.begin(), calibrationExpiries.end()), Model::McParams());
+        std::set<Date>(calibrationExpiries.begin(), calibrationExpiries.end()), mcParams);
 
     // generate MC prices for the calibration instruments and compare them with analytical prices
 
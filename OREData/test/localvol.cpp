@@ -61,7 +61,8 @@ BOOST_AUTO_TEST_SUITE(LocalVolTest)
 namespace {
 void testCalibrationInstrumentRepricing(const std::vector<Date>& expiries, const std::vector<Real>& moneyness,
                                         const boost::shared_ptr<GeneralizedBlackScholesProcess>& process,
-                                        const Size timeStepsPerYear, const Size paths, const Real tol) {
+                                        const Size timeStepsPerYear, const Size paths, const Real tol,
+                                        const Size localVolGridSize = 0) {
 
     // set up a local vol model with simulation dates = expiries, calibrated to options (expiry, moneyness) with
     // the expiry taken from the expiries vector and the moneyness taken from the moneyness vector
@@ -74,7 +75,8 @@ void testCalibrationInstrumentRepricing(const std::vector<Date>& expiries, const
     Model::McParams mcParams;
     mcParams.regressionOrder = 1;
     auto localVol = boost::make_shared<LocalVol>(paths, "EUR", process->riskFreeRate(), "EQ-DUMMY", "EUR",
-                                                 builder.model(), mcParams, simDates);
+                                                 builder.model(), mcParams, simDates,
+                                                 IborFallbackConfig::defaultConfig(), localVolGridSize);
 
     // loop over the calibration options and price them in the local vol model using MC
     // the result should be close to the market price of the options
@@ -132,6 +134,30 @@ void testCalibrationInstrumentRepricing(const std::vector<Date>& expiries, const
     }
     BOOST_TEST_MESSAGE("max error = " << maxError);
 }
+
+class SabrTestSurface : public BlackVolatilityTermStructure {
+public:
+    SabrTestSurface(const Handle<Quote>& spot, const Handle<YieldTermStructure>& r,
+                    const Handle<YieldTermStructure>& q)
+        : BlackVolatilityTermStructure(0, NullCalendar(), Following, ActualActual(ActualActual::ISDA)), spot_(spot),
+          r_(r), q_(q) {}
+    Date maxDate() const override { return Date::maxDate(); }
+    Real minStrike() const override { return 0.0; }
+    Real maxStrike() const override { return QL_MAX_REAL; }
+
+private:
+    Real blackVolImpl(Time maturity, Real strike) const override {
+        Real forward = spot_->value() / r_->discount(maturity) * q_->discount(maturity);
+        Real w2 = std::min(maturity, 10.0) / 10.0, w1 = 1.0 - w2;
+        Real alpha = 0.17 * w1 + 0.10 * w2;
+        Real beta = 0.99;
+        Real nu = 0.3 * w1 + 0.05 * w2;
+        Real rho = -0.2;
+        return sabrVolatility(strike, forward, maturity, alpha, beta, nu, rho);
+    }
+    Handle<Quote> spot_;
+    Handle<YieldTermStructure> r_, q_;
+};
 } // namespace
 
 BOOST_AUTO_TEST_CASE(testFlatVols) {
@@ -171,29 +197,6 @@ BOOST_AUTO_TEST_CASE(testSabrVols) {
     Handle<YieldTermStructure> r(boost::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
     Handle<YieldTermStructure> q(boost::make_shared<FlatForward>(0, NullCalendar(), 0.03, Actual365Fixed()));
 
-    class SabrTestSurface : public BlackVolatilityTermStructure {
-    public:
-        SabrTestSurface(const Handle<Quote>& spot, const Handle<YieldTermStructure>& r,
-                        const Handle<YieldTermStructure>& q)
-            : BlackVolatilityTermStructure(0, NullCalendar(), Following, ActualActual(ActualActual::ISDA)), spot_(spot), r_(r), q_(q) {}
-        Date maxDate() const override { return Date::maxDate(); }
-        Real minStrike() const override { return 0.0; }
-        Real maxStrike() const override { return QL_MAX_REAL; }
-
-    private:
-        Real blackVolImpl(Time maturity, Real strike) const override {
-            Real forward = spot_->value() / r_->discount(maturity) * q_->discount(maturity);
-            Real w2 = std::min(maturity, 10.0) / 10.0, w1 = 1.0 - w2;
-            Real alpha = 0.17 * w1 + 0.10 * w2;
-            Real beta = 0.99;
-            Real nu = 0.3 * w1 + 0.05 * w2;
-            Real rho = -0.2;
-            return sabrVolatility(strike, forward, maturity, alpha, beta, nu, rho);
-        }
-        Handle<Quote> spot_;
-        Handle<YieldTermStructure> r_, q_;
-    };
-
     Handle<Quote> spot(boost::make_shared<SimpleQuote>(100.0));
     Handle<BlackVolTermStructure> vol(boost::make_shared<SabrTestSurface>(spot, r, q));
 
@@ -202,6 +205,28 @@ BOOST_AUTO_TEST_CASE(testSabrVols) {
     testCalibrationInstrumentRepricing(expiries, moneyness, process, 20, 10000, 0.30);
 }
 
+BOOST_AUTO_TEST_CASE(testSabrVolsOnLocalVolGrid) {
+    BOOST_TEST_MESSAGE("Testing LocalVol with sabr input vols using precomputed local vol grid...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::vector<Date> expiries{ref + 1 * Months, ref + 3 * Months, ref + 6 * Months, ref + 9 * Months,
+                               ref + 1 * Years,  ref + 2 * Years,  ref + 3 * Years,  ref + 4 * Years,
+                               ref + 5 * Years,  ref + 7 * Years,  ref + 10 * Years};
+
+    std::vector<Real> moneyness{-3.0, -2.0, -1.0, 0.0, 1.0, 2.0, 3.0};
+
+    Handle<YieldTermStructure> r(boost::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    Handle<YieldTermStructure> q(boost::make_shared<FlatForward>(0, NullCalendar(), 0.03, Actual365Fixed()));
+    Handle<Quote> spot(boost::make_shared<SimpleQuote>(100.0));
+    Handle<BlackVolTermStructure> vol(boost::make_shared<SabrTestSurface>(spot, r, q));
+
+    auto process = boost::make_shared<GeneralizedBlackScholesProcess>(spot, q, r, vol);
+
+    testCalibrationInstrumentRepricing(expiries, moneyness, process, 20, 10000, 0.30, 400);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -28,6 +28,9 @@
 #include <ql/time/calendars/chile.hpp>
 #include <ql/time/calendars/france.hpp>
 #include <ql/time/calendars/thailand.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/calendars/unitedkingdom.hpp>
+#include <ql/time/calendars/unitedstates.hpp>
 #include <ql/time/daycounters/all.hpp>
 #include <qle/calendars/colombia.hpp>
 #include <qle/calendars/israel.hpp>
@@ -1090,6 +1093,41 @@ BOOST_AUTO_TEST_CASE(testJointCalendar) {
     checkCalendars(expectedHolidays, hol);
 }
 
+BOOST_AUTO_TEST_CASE(testJointCalendarBitmap) {
+
+    BOOST_TEST_MESSAGE("Testing joint calendars with precomputed business days...");
+
+    std::vector<Calendar> cals = {TARGET(), UnitedStates(UnitedStates::Settlement), UnitedKingdom()};
+    Calendar rules = QuantExt::LargeJointCalendar(cals);
+    Calendar bitmap = QuantExt::LargeJointCalendar(cals, JoinHolidays, 2000, 2030);
+
+    // the range covers dates inside and outside the precomputed years
+    Date start(1, January, 1995), end(31, December, 2035);
+    for (Date d = start; d <= end; ++d) {
+        BOOST_REQUIRE_EQUAL(rules.isBusinessDay(d), bitmap.isBusinessDay(d));
+    }
+    BOOST_CHECK_EQUAL(rules.advance(start, 5000, Days), bitmap.advance(start, 5000, Days));
+    BOOST_CHECK_EQUAL(rules.businessDaysBetween(start, end), bitmap.businessDaysBetween(start, end));
+
+    // holidays added to an underlying calendar after construction are taken into account
+    Date h(15, June, 2020);
+    BOOST_REQUIRE(bitmap.isBusinessDay(h));
+    Calendar uk = UnitedKingdom();
+    uk.addHoliday(h);
+    BOOST_CHECK(!bitmap.isBusinessDay(h));
+    BOOST_CHECK_EQUAL(rules.businessDaysBetween(start, end), bitmap.businessDaysBetween(start, end));
+    uk.removeHoliday(h);
+    BOOST_CHECK(bitmap.isBusinessDay(h));
+
+    // parsed joint calendars are shared and match the calendars built from the rules
+    Calendar parsed1 = ore::data::parseCalendar("TARGET,US,UK");
+    Calendar parsed2 = ore::data::parseCalendar("TARGET, US, UK");
+    BOOST_CHECK_EQUAL(parsed1.name(), parsed2.name());
+    for (Date d = start; d <= end; ++d) {
+        BOOST_REQUIRE_EQUAL(rules.isBusinessDay(d), parsed1.isBusinessDay(d));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testParseBoostAny) {
 
     BOOST_TEST_MESSAGE("Testing parsing of Boost::Any...");
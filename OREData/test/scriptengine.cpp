@@ -24,6 +24,7 @@
 
 #include <ored/scripting/models/blackscholes.hpp>
 #include <ored/scripting/models/dummymodel.hpp>
+#include <ored/scripting/models/fdblackscholesbase.hpp>
 #include <ored/scripting/astprinter.hpp>
 #include <ored/scripting/scriptengine.hpp>
 #include <ored/scripting/scriptparser.hpp>
@@ -1393,6 +1394,70 @@ BOOST_AUTO_TEST_CASE(testAutocallable) {
     BOOST_CHECK_CLOSE(avg, avg2, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(testExchangeOptionFd2d) {
+    BOOST_TEST_MESSAGE("Testing exchange option in 2d fd black scholes model...");
+
+    Date ref(7, May, 2019);
+    Settings::instance().evaluationDate() = ref;
+
+    std::string script = "Option = PAY(max( Underlying1(Expiry) - Underlying2(Expiry), 0 ), Expiry, Expiry, PayCcy);";
+    ScriptParser parser(script);
+    BOOST_REQUIRE(parser.success());
+
+    Real s1 = 100.0, s2 = 95.0;
+    Real vol1 = 0.20, vol2 = 0.30, rho = 0.4;
+    Real rate = 0.02;
+    Date expiry(7, May, 2020);
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(ref, rate, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> yts0(boost::make_shared<FlatForward>(ref, 0.0, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts1(
+        boost::make_shared<BlackConstantVol>(ref, NullCalendar(), vol1, ActualActual(ActualActual::ISDA)));
+    Handle<BlackVolTermStructure> volts2(
+        boost::make_shared<BlackConstantVol>(ref, NullCalendar(), vol2, ActualActual(ActualActual::ISDA)));
+    auto process1 = boost::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(boost::make_shared<SimpleQuote>(s1)), yts0, yts, volts1);
+    auto process2 = boost::make_shared<GeneralizedBlackScholesProcess>(
+        Handle<Quote>(boost::make_shared<SimpleQuote>(s2)), yts0, yts, volts2);
+    std::map<std::pair<std::string, std::string>, Handle<QuantExt::CorrelationTermStructure>> correlations;
+    correlations[std::make_pair("EQ-1", "EQ-2")] = Handle<QuantExt::CorrelationTermStructure>(
+        boost::make_shared<QuantExt::FlatCorrelation>(0, NullCalendar(), rho, ActualActual(ActualActual::ISDA)));
+
+    std::set<Date> simulationDates = {expiry};
+    constexpr Size stateGridPoints = 100;
+
+    cpu_timer timer;
+    auto model = boost::make_shared<FdBlackScholesBase>(
+        stateGridPoints, std::vector<std::string>(1, "USD"), std::vector<Handle<YieldTermStructure>>(1, yts),
+        std::vector<Handle<Quote>>(), std::vector<std::pair<std::string, boost::shared_ptr<InterestRateIndex>>>(),
+        std::vector<std::pair<std::string, boost::shared_ptr<ZeroInflationIndex>>>(),
+        std::vector<std::string>{"EQ-1", "EQ-2"}, std::vector<std::string>(2, "USD"), std::set<std::string>{"USD"},
+        BlackScholesModelBuilder({yts}, {process1, process2}, simulationDates, {}, 100).model(), correlations,
+        simulationDates, IborFallbackConfig::defaultConfig(), "ATM");
+    BOOST_REQUIRE_EQUAL(model->size(), stateGridPoints * stateGridPoints);
+
+    auto context = boost::make_shared<Context>();
+    context->scalars["Underlying1"] = IndexVec{model->size(), "EQ-1"};
+    context->scalars["Underlying2"] = IndexVec{model->size(), "EQ-2"};
+    context->scalars["Expiry"] = EventVec{model->size(), expiry};
+    context->scalars["PayCcy"] = CurrencyVec{model->size(), "USD"};
+    context->scalars["Option"] = RandomVariable(model->size(), 0.0);
+
+    ScriptEngine engine(parser.ast(), context, model);
+    BOOST_REQUIRE_NO_THROW(engine.run());
+    BOOST_REQUIRE(context->scalars["Option"].which() == ValueTypeWhich::Number);
+    Real npv = model->extractT0Result(boost::get<RandomVariable>(context->scalars["Option"]));
+    timer.stop();
+    BOOST_TEST_MESSAGE("option value fd " << npv << " (timing " << timer.format(default_places, "%w") << "s)");
+
+    // analytical computation (Margrabe)
+    Real t = yts->timeFromReference(expiry);
+    Real vol = std::sqrt(vol1 * vol1 + vol2 * vol2 - 2.0 * rho * vol1 * vol2);
+    Real expected = blackFormula(Option::Call, s2, s1, vol * std::sqrt(t), 1.0);
+    BOOST_TEST_MESSAGE("option value expected " << expected);
+    BOOST_CHECK_CLOSE(npv, expected, 0.5);
+}
+
 BOOST_AUTO_TEST_CASE(testNestedIfThenElse) {
     BOOST_TEST_MESSAGE("Testing nested if-then-else statements...");
 
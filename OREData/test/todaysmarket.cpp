@@ -829,6 +829,37 @@ BOOST_AUTO_TEST_CASE(testZeroSpreadedYieldCurve) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testMarketSnapshot) {
+
+    BOOST_TEST_MESSAGE("Testing todays market built from market snapshot...");
+
+    Date asof(26, February, 2016);
+    auto loader = boost::make_shared<MarketDataLoader>();
+    auto params = marketParameters();
+    auto configs = curveConfigurations();
+
+    // first build records the bootstrapped curves, second build takes them from the frozen snapshot
+    auto snapshot = boost::make_shared<MarketSnapshot>(asof);
+    auto market1 = boost::make_shared<TodaysMarket>(asof, params, loader, configs, false, true, false, nullptr, false,
+                                                    IborFallbackConfig::defaultConfig(), true, true, snapshot);
+    BOOST_CHECK(snapshot->size() > 0);
+    snapshot->freeze();
+    auto market2 = boost::make_shared<TodaysMarket>(asof, params, loader, configs, false, true, false, nullptr, false,
+                                                    IborFallbackConfig::defaultConfig(), true, true, snapshot);
+
+    Date today = Settings::instance().evaluationDate();
+    for (auto const& ccy : {"EUR", "USD"}) {
+        Handle<YieldTermStructure> dts = market->discountCurve(ccy);
+        Handle<YieldTermStructure> dts1 = market1->discountCurve(ccy);
+        Handle<YieldTermStructure> dts2 = market2->discountCurve(ccy);
+        for (Size i = 1; i <= 120; i++) {
+            Date d = today + i * Months;
+            BOOST_CHECK_EQUAL(dts->discount(d), dts1->discount(d));
+            BOOST_CHECK_EQUAL(dts->discount(d), dts2->discount(d));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testNormalOptionletVolatility) {
 
     BOOST_TEST_MESSAGE("Testing normal optionlet volatilities...");
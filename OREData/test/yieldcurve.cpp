@@ -276,6 +276,41 @@ BOOST_DATA_TEST_CASE(testBootstrapARSinUSDPasses, bdata::make(curveConfigFiles),
     BOOST_TEST_MESSAGE("Discount: " << std::fixed << std::setprecision(14) << yts->discount(1.0));
 }
 
+// Test that the global Newton bootstrap reproduces the iterative bootstrap for the ARS-IN-USD passing configurations
+BOOST_DATA_TEST_CASE(testBootstrapARSinUSDGlobalNewton, bdata::make(curveConfigFiles), curveConfigFile) {
+
+    BOOST_TEST_MESSAGE("Testing ARS-IN-USD global newton bootstrap with configuration file: passing/"
+                       << curveConfigFile);
+
+    TodaysMarketArguments tma(Date(25, Sep, 2019), "ars_in_usd", "passing/" + curveConfigFile);
+
+    boost::shared_ptr<TodaysMarket> todaysMarket;
+    BOOST_REQUIRE_NO_THROW(todaysMarket =
+                               boost::make_shared<TodaysMarket>(tma.asof, tma.todaysMarketParameters, tma.loader,
+                                                                tma.curveConfigs, false, false));
+    Handle<YieldTermStructure> yts = todaysMarket->discountCurve("ARS");
+
+    for (auto const& id : tma.curveConfigs->yieldCurveConfigIds()) {
+        auto config = tma.curveConfigs->yieldCurveConfig(id);
+        const BootstrapConfig& bc = config->bootstrapConfig();
+        config->setBootstrapConfig(BootstrapConfig(bc.accuracy(), bc.globalAccuracy(), bc.dontThrow(),
+                                                   bc.maxAttempts(), bc.maxFactor(), bc.minFactor(),
+                                                   bc.dontThrowSteps(), true));
+    }
+
+    boost::shared_ptr<TodaysMarket> todaysMarketNewton;
+    BOOST_REQUIRE_NO_THROW(todaysMarketNewton =
+                               boost::make_shared<TodaysMarket>(tma.asof, tma.todaysMarketParameters, tma.loader,
+                                                                tma.curveConfigs, false, false));
+    Handle<YieldTermStructure> ytsNewton = todaysMarketNewton->discountCurve("ARS");
+
+    for (Real t : {0.1, 0.25, 0.5, 0.75, 1.0}) {
+        BOOST_TEST_MESSAGE("Discount(" << t << "): iterative " << std::fixed << std::setprecision(14)
+                                       << yts->discount(t) << ", global newton " << ytsNewton->discount(t));
+        BOOST_CHECK_SMALL(yts->discount(t) - ytsNewton->discount(t), 1.0E-8);
+    }
+}
+
 BOOST_DATA_TEST_CASE(testOiFirstFutureDateVsValuationDate, bdata::make(oiFutureCases), oiFutureCase) {
 
     BOOST_TEST_MESSAGE("Testing OI future. " << oiFutureCase);
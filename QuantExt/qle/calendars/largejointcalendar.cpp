@@ -65,6 +65,49 @@ bool LargeJointCalendar::Impl::isWeekend(Weekday w) const {
 }
 
 bool LargeJointCalendar::Impl::isBusinessDay(const Date& date) const {
+    if (!jointBitmap_.empty() && date.serialNumber() >= firstSerial_ &&
+        date.serialNumber() < firstSerial_ + static_cast<Date::serial_type>(days_)) {
+        std::size_t i = static_cast<std::size_t>(date.serialNumber() - firstSerial_);
+        bool adjusted = false;
+        for (auto const& c : calendars_) {
+            if (!c.addedHolidays().empty() || !c.removedHolidays().empty()) {
+                adjusted = true;
+                break;
+            }
+        }
+        if (!adjusted)
+            return bit(jointBitmap_, i);
+        switch (rule_) {
+        case JoinHolidays:
+            for (Size k = 0; k < calendars_.size(); ++k) {
+                if (!isBusinessDayFromBitmap(k, date, i))
+                    return false;
+            }
+            return true;
+        case JoinBusinessDays:
+            for (Size k = 0; k < calendars_.size(); ++k) {
+                if (isBusinessDayFromBitmap(k, date, i))
+                    return true;
+            }
+            return false;
+        default:
+            QL_FAIL("unknown joint calendar rule");
+        }
+    }
+    return isBusinessDayFromRules(date);
+}
+
+bool LargeJointCalendar::Impl::isBusinessDayFromBitmap(const Size k, const Date& d, const std::size_t i) const {
+    // this is the logic of Calendar::isBusinessDay(), with the rule based result read from the bitmap
+    const Calendar& c = calendars_[k];
+    if (!c.addedHolidays().empty() && c.addedHolidays().find(d) != c.addedHolidays().end())
+        return false;
+    if (!c.removedHolidays().empty() && c.removedHolidays().find(d) != c.removedHolidays().end())
+        return true;
+    return bit(calendarBitmaps_[k], i);
+}
+
+bool LargeJointCalendar::Impl::isBusinessDayFromRules(const Date& date) const {
     std::vector<Calendar>::const_iterator i;
     switch (rule_) {
     case JoinHolidays:
@@ -90,8 +133,45 @@ LargeJointCalendar::Impl::Impl(const std::vector<Calendar>& calendars, JointCale
     }
 }
 
-LargeJointCalendar::LargeJointCalendar(const std::vector<Calendar>& calendars, JointCalendarRule r) {
-    impl_ = ext::shared_ptr<Calendar::Impl>(new LargeJointCalendar::Impl(calendars, r));
+void LargeJointCalendar::Impl::buildBitmaps(Year firstYear, Year lastYear) {
+    QL_REQUIRE(firstYear <= lastYear,
+               "LargeJointCalendar: first year (" << firstYear << ") must be <= last year (" << lastYear << ")");
+    Date start(1, January, firstYear), end(31, December, lastYear);
+    firstSerial_ = start.serialNumber();
+    days_ = static_cast<std::size_t>(end - start) + 1;
+    Size words = (days_ + 63) / 64;
+    calendarBitmaps_.assign(calendars_.size(), std::vector<std::uint64_t>(words, 0));
+    jointBitmap_.assign(words, 0);
+    for (std::size_t i = 0; i < days_; ++i) {
+        Date d = start + static_cast<Date::serial_type>(i);
+        std::uint64_t mask = std::uint64_t(1) << (i & 63);
+        bool joint = rule_ == JoinHolidays;
+        for (Size k = 0; k < calendars_.size(); ++k) {
+            const Calendar& c = calendars_[k];
+            // we store the rule based business days, i.e. we undo the added / removed holidays, note that
+            // added holidays are always rule based business days and removed holidays rule based holidays
+            bool isBd;
+            if (c.addedHolidays().find(d) != c.addedHolidays().end())
+                isBd = true;
+            else if (c.removedHolidays().find(d) != c.removedHolidays().end())
+                isBd = false;
+            else
+                isBd = c.isBusinessDay(d);
+            if (isBd)
+                calendarBitmaps_[k][i >> 6] |= mask;
+            joint = rule_ == JoinHolidays ? joint && isBd : joint || isBd;
+        }
+        if (joint)
+            jointBitmap_[i >> 6] |= mask;
+    }
+}
+
+LargeJointCalendar::LargeJointCalendar(const std::vector<Calendar>& calendars, JointCalendarRule r, Year firstYear,
+                                       Year lastYear) {
+    auto impl = ext::make_shared<LargeJointCalendar::Impl>(calendars, r);
+    if (firstYear != Null<Year>() && lastYear != Null<Year>())
+        impl->buildBitmaps(firstYear, lastYear);
+    impl_ = impl;
 }
 
 } // namespace QuantExt
@@ -25,6 +25,9 @@
 
 #include <ql/time/calendar.hpp>
 #include <ql/time/calendars/jointcalendar.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <cstdint>
 
 namespace QuantExt {
 
@@ -34,6 +37,12 @@ namespace QuantExt {
 
     \ingroup calendars
 
+    If a year range is given, the business days of the underlying calendars in this range are precomputed as
+    bitmaps on construction, so that isBusinessDay() (and hence advance(), businessDaysBetween() etc.) reduce to
+    bit lookups there. Outside the range the underlying calendars are asked as usual. Holidays added to or removed
+    from the underlying calendars after construction are taken into account, changes to the holiday rules of the
+    underlying calendars themselves (e.g. adjustments of the base calendar of an underlying amended calendar) are not.
+
     \test the correctness of the returned results is tested by
           reproducing the calculations.
 */
@@ -46,14 +55,33 @@ private:
         bool isWeekend(QuantLib::Weekday) const override;
         bool isBusinessDay(const QuantLib::Date&) const override;
 
+        void buildBitmaps(QuantLib::Year firstYear, QuantLib::Year lastYear);
+
     private:
+        bool isBusinessDayFromRules(const QuantLib::Date&) const;
+        // business day of underlying calendar k at serial number firstSerial_ + i from the bitmap
+        bool isBusinessDayFromBitmap(const QuantLib::Size k, const QuantLib::Date& d, const std::size_t i) const;
+        static bool bit(const std::vector<std::uint64_t>& bitmap, const std::size_t i) {
+            return (bitmap[i >> 6] >> (i & 63)) & 1;
+        }
+
         QuantLib::JointCalendarRule rule_;
         std::vector<QuantLib::Calendar> calendars_;
+        // business days of the underlying calendars before added / removed holidays and of the joint calendar
+        // (if none of the underlying calendars has added / removed holidays) for serial numbers >= firstSerial_
+        QuantLib::Date::serial_type firstSerial_ = 0;
+        std::size_t days_ = 0;
+        std::vector<std::vector<std::uint64_t>> calendarBitmaps_;
+        std::vector<std::uint64_t> jointBitmap_;
     };
 
 public:
+    /*! If firstYear and lastYear are given, the business days in [1 Jan firstYear, 31 Dec lastYear] are
+        precomputed. */
     explicit LargeJointCalendar(const std::vector<QuantLib::Calendar>&,
-                                QuantLib::JointCalendarRule = QuantLib::JoinHolidays);
+                                QuantLib::JointCalendarRule = QuantLib::JoinHolidays,
+                                QuantLib::Year firstYear = QuantLib::Null<QuantLib::Year>(),
+                                QuantLib::Year lastYear = QuantLib::Null<QuantLib::Year>());
 };
 
 } // namespace QuantExt
@@ -108,6 +108,8 @@ AverageONIndexedCoupon::AverageONIndexedCoupon(const Date& paymentDate, Real nom
     for (Size i = 0; i < numPeriods_; ++i)
         dt_[i] = dayCounter.yearFraction(valueDates_[i], valueDates_[i + 1]);
 
+    pastFixingsCache_ = boost::make_shared<OvernightPastFixingsCache>(overnightIndex);
+
     // check that rate cutoff is < number of fixing dates
     QL_REQUIRE(rateCutoff_ < numPeriods_, "rate cutoff (" << rateCutoff_
                                                           << ") must be less than number of fixings in period ("
@@ -28,6 +28,7 @@
 #include <ql/cashflows/floatingratecoupon.hpp>
 #include <ql/indexes/iborindex.hpp>
 #include <ql/time/schedule.hpp>
+#include <qle/cashflows/overnightpastfixingscache.hpp>
 
 namespace QuantExt {
 using namespace QuantLib;
@@ -73,6 +74,8 @@ public:
     const Date& rateComputationEndDate() const { return rateComputationEndDate_; }
     //! the underlying index
     const ext::shared_ptr<OvernightIndex>& overnightIndex() const { return overnightIndex_; }
+    //! accumulated past fixings, used by the pricer
+    const boost::shared_ptr<OvernightPastFixingsCache>& pastFixingsCache() const { return pastFixingsCache_; }
     //@}
     //! \name FloatingRateCoupon interface
     //@{
@@ -92,6 +95,7 @@ private:
     Natural rateCutoff_;
     Period lookback_;
     Date rateComputationStartDate_, rateComputationEndDate_;
+    boost::shared_ptr<OvernightPastFixingsCache> pastFixingsCache_;
 };
 
 //! capped floored overnight indexed coupon
@@ -47,7 +47,9 @@ Rate AverageONIndexedCouponPricer::swapletRate() const {
     if (approximationType_ == Takada) {
         Size i = 0;
         Date valuationDate = Settings::instance().evaluationDate();
-        // Deal with past fixings.
+        // Deal with past fixings, continue from the accumulation cached for a previous evaluation date, if possible.
+        Real unused = 0.0;
+        coupon_->pastFixingsCache()->get(valuationDate, i, accumulatedRate, unused);
         while (i < numPeriods && fixingDates[std::min(i, nCutoff)] < valuationDate) {
             Rate pastFixing = overnightIndex_->pastFixing(fixingDates[std::min(i, nCutoff)]);
             QL_REQUIRE(pastFixing != Null<Real>(),
@@ -55,6 +57,7 @@ Rate AverageONIndexedCouponPricer::swapletRate() const {
             accumulatedRate += pastFixing * accrualFractions[i];
             ++i;
         }
+        coupon_->pastFixingsCache()->set(valuationDate, i, accumulatedRate, 0.0);
         // Use valuation date's fixing also if available.
         if (i < numPeriods && fixingDates[std::min(i, nCutoff)] == valuationDate) {
             Rate valuationDateFixing = overnightIndex_->pastFixing(valuationDate);
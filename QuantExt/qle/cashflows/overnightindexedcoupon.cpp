@@ -139,6 +139,8 @@ OvernightIndexedCoupon::OvernightIndexedCoupon(const Date& paymentDate, Real nom
     for (Size i = 0; i < n_; ++i)
         dt_[i] = dc.yearFraction(valueDates_[i], valueDates_[i + 1]);
 
+    pastFixingsCache_ = boost::make_shared<OvernightPastFixingsCache>(overnightIndex);
+
     setPricer(ext::shared_ptr<FloatingRateCouponPricer>(new OvernightIndexedCouponPricer));
 
     // check that rate cutoff is < number of fixing dates
@@ -207,8 +209,9 @@ void OvernightIndexedCouponPricer::compute() const {
 
     Real compoundFactor = 1.0, compoundFactorWithoutSpread = 1.0;
 
-    // already fixed part
+    // already fixed part, continue from the accumulation cached for a previous evaluation date, if possible
     Date today = Settings::instance().evaluationDate();
+    coupon_->pastFixingsCache()->get(today, i, compoundFactor, compoundFactorWithoutSpread);
     while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
         // rate must have been fixed
         Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
@@ -221,6 +224,7 @@ void OvernightIndexedCouponPricer::compute() const {
         compoundFactor *= (1.0 + pastFixing * dt[i]);
         ++i;
     }
+    coupon_->pastFixingsCache()->set(today, i, compoundFactor, compoundFactorWithoutSpread);
 
     // today is a border case
     if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
@@ -48,6 +48,7 @@
 #include <ql/cashflows/floatingratecoupon.hpp>
 #include <ql/indexes/iborindex.hpp>
 #include <ql/time/schedule.hpp>
+#include <qle/cashflows/overnightpastfixingscache.hpp>
 
 namespace QuantLib {
 class OptionletVolatilityStructure;
@@ -107,6 +108,8 @@ public:
     const Date& rateComputationEndDate() const { return rateComputationEndDate_; }
     //! the underlying index
     const ext::shared_ptr<OvernightIndex>& overnightIndex() const { return overnightIndex_; }
+    //! accumulated past fixings, used by the pricer
+    const boost::shared_ptr<OvernightPastFixingsCache>& pastFixingsCache() const { return pastFixingsCache_; }
     //@}
     //! \name FloatingRateCoupon interface
     //@{
@@ -127,6 +130,7 @@ private:
     Period lookback_;
     Natural rateCutoff_;
     Date rateComputationStartDate_, rateComputationEndDate_;
+    boost::shared_ptr<OvernightPastFixingsCache> pastFixingsCache_;
 };
 
 //! OvernightIndexedCoupon pricer
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/cashflows/overnightpastfixingscache.hpp>
+#include <qle/indexes/fallbackovernightindex.hpp>
+
+#include <ql/indexes/indexmanager.hpp>
+
+namespace QuantExt {
+
+OvernightPastFixingsCache::OvernightPastFixingsCache(const std::string& indexName) {
+    registerWith(IndexManager::instance().notifier(indexName));
+}
+
+OvernightPastFixingsCache::OvernightPastFixingsCache(const boost::shared_ptr<OvernightIndex>& index) {
+    registerWithIndex(index);
+}
+
+void OvernightPastFixingsCache::registerWithIndex(const boost::shared_ptr<OvernightIndex>& index) {
+    registerWith(IndexManager::instance().notifier(index->name()));
+    if (auto fallback = boost::dynamic_pointer_cast<FallbackOvernightIndex>(index)) {
+        registerWithIndex(fallback->originalIndex());
+        registerWithIndex(fallback->rfrIndex());
+    }
+}
+
+void OvernightPastFixingsCache::update() {
+    if (detail::OvernightPastFixingsCacheMode::instance().forwardFixingUpdates)
+        forwardHistoryChanged_ = true;
+    else
+        historyChanged_ = true;
+}
+
+bool OvernightPastFixingsCache::get(const Date& today, Size& i, Real& v1, Real& v2) {
+    if (!valid_ || today < today_ || historyChanged_ || (forwardHistoryChanged_ && today == today_)) {
+        valid_ = historyChanged_ = forwardHistoryChanged_ = false;
+        return false;
+    }
+    forwardHistoryChanged_ = false;
+    i = i_;
+    v1 = v1_;
+    v2 = v2_;
+    return true;
+}
+
+void OvernightPastFixingsCache::set(const Date& today, const Size i, const Real v1, const Real v2) {
+    valid_ = true;
+    historyChanged_ = forwardHistoryChanged_ = false;
+    today_ = today;
+    i_ = i;
+    v1_ = v1;
+    v2_ = v2;
+}
+
+OvernightPastFixingsCache::ForwardFixingUpdates::ForwardFixingUpdates()
+    : previous_(detail::OvernightPastFixingsCacheMode::instance().forwardFixingUpdates) {
+    detail::OvernightPastFixingsCacheMode::instance().forwardFixingUpdates = true;
+}
+
+OvernightPastFixingsCache::ForwardFixingUpdates::~ForwardFixingUpdates() {
+    detail::OvernightPastFixingsCacheMode::instance().forwardFixingUpdates = previous_;
+}
+
+} // namespace QuantExt
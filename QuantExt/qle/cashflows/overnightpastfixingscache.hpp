@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file overnightpastfixingscache.hpp
+    \brief cache for the accumulated past fixings of an overnight coupon
+
+        \ingroup cashflows
+*/
+
+#pragma once
+
+#include <ql/indexes/iborindex.hpp>
+#include <ql/patterns/observable.hpp>
+#include <ql/patterns/singleton.hpp>
+#include <ql/time/date.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! cache for the accumulated past fixings of an overnight coupon
+/*! The pricers of OvernightIndexedCoupon and AverageONIndexedCoupon accumulate the past fixings of the coupon period
+    (compound factors resp. the sum of the rates). This class stores the accumulation over the periods whose fixing
+    date is before a given evaluation date, so that the pricers only have to process the periods that became past
+    since the last call.
+
+    The cache is discarded when
+    - the evaluation date moves backward, or
+    - the fixing history of the index is changed. For a FallbackOvernightIndex this includes the fixing histories of
+      the original and the rfr index, since the past fixings after the switch date are read from the latter.
+
+    A client that only adds or changes fixings on or after the current evaluation date, like the fixing manager in a
+    simulation, can declare this by holding a ForwardFixingUpdates instance while it changes the history. Such
+    changes invalidate the cache only if the evaluation date does not move forward before the next call.
+
+        \ingroup cashflows
+*/
+class OvernightPastFixingsCache : public Observer {
+public:
+    explicit OvernightPastFixingsCache(const std::string& indexName);
+    //! observes the fixing history of the index and of the indices it reads its past fixings from
+    explicit OvernightPastFixingsCache(const boost::shared_ptr<OvernightIndex>& index);
+
+    void update() override;
+
+    /*! If a valid accumulation is available for the evaluation date today, return true and set the number of
+        accumulated periods i and the accumulated values v1, v2. Otherwise return false and leave the arguments
+        untouched. */
+    bool get(const Date& today, Size& i, Real& v1, Real& v2);
+
+    //! store the accumulation over the first i periods, all of which must have a fixing date before today
+    void set(const Date& today, const Size i, const Real v1, const Real v2);
+
+    /*! While an instance of this class exists, changes to the fixing histories are assumed to only affect fixing
+        dates on or after the evaluation date at which the caches were last set. */
+    class ForwardFixingUpdates {
+    public:
+        ForwardFixingUpdates();
+        ~ForwardFixingUpdates();
+        ForwardFixingUpdates(const ForwardFixingUpdates&) = delete;
+        ForwardFixingUpdates& operator=(const ForwardFixingUpdates&) = delete;
+
+    private:
+        bool previous_;
+    };
+
+private:
+    void registerWithIndex(const boost::shared_ptr<OvernightIndex>& index);
+    bool valid_ = false, historyChanged_ = false, forwardHistoryChanged_ = false;
+    Date today_;
+    Size i_ = 0;
+    Real v1_ = 0.0, v2_ = 0.0;
+};
+
+namespace detail {
+//! session wide flag backing OvernightPastFixingsCache::ForwardFixingUpdates
+class OvernightPastFixingsCacheMode : public QuantLib::Singleton<OvernightPastFixingsCacheMode> {
+    friend class QuantLib::Singleton<OvernightPastFixingsCacheMode>;
+
+private:
+    OvernightPastFixingsCacheMode() = default;
+
+public:
+    bool forwardFixingUpdates = false;
+};
+} // namespace detail
+
+} // namespace QuantExt
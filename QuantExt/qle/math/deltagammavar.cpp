@@ -23,8 +23,14 @@
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/math/matrixutilities/choleskydecomposition.hpp>
 #include <ql/math/matrixutilities/symmetricschurdecomposition.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <thread>
+
 namespace QuantExt {
 
 namespace detail {
@@ -420,4 +426,112 @@ Real deltaGammaVarSaddlepoint(const Matrix& omega, const Array& delta, const Mat
 
 } // deltaGammaVarSaddlepoint
 
+std::vector<Real> deltaGammaVarMcDiagonal(const Matrix& omega, const Array& delta, const Matrix& gamma,
+                                          const std::vector<Real>& p, const Size paths, const Size seed,
+                                          const CovarianceSalvage& sal, const Size nThreads, const Size blockSize) {
+    for (auto q : p)
+        detail::check(q);
+    detail::check(omega, delta, gamma);
+    QL_REQUIRE(paths > 0, "deltaGammaVarMcDiagonal: paths must be positive");
+    QL_REQUIRE(nThreads > 0, "deltaGammaVarMcDiagonal: nThreads must be positive");
+    QL_REQUIRE(blockSize > 0, "deltaGammaVarMcDiagonal: blockSize must be positive");
+
+    Real num = std::max(detail::absMax(delta), detail::absMax(gamma));
+    if (close_enough(num, 0.0))
+        return std::vector<Real>(p.size(), 0.0);
+
+    Matrix L = sal.salvage(omega).second;
+    if (L.rows() == 0) {
+        L = CholeskyDecomposition(omega, true);
+    }
+
+    // transform to the eigenbasis of 1/2 L^T gamma L, the PL is then deltaBar^T z + z^T diag(lambda) z
+
+    Matrix hLGL = 0.5 * transpose(L) * gamma * L;
+    SymmetricSchurDecomposition schur(hLGL);
+    const Array& lambda = schur.eigenvalues();
+    Array deltaBar = transpose(schur.eigenvectors()) * (transpose(L) * delta);
+    Size dim = lambda.size();
+
+    // one seed per block, so that the paths do not depend on the number of threads
+
+    Size nBlocks = (paths + blockSize - 1) / blockSize;
+    std::vector<Size> blockSeeds(nBlocks);
+    MersenneTwisterUniformRng seeder(seed);
+    for (auto& s : blockSeeds) {
+        // a zero seed would trigger a clock based seed in the mersenne twister
+        while ((s = seeder.nextInt32()) == 0)
+            ;
+    }
+
+    // generate the PL realisations
+
+    std::vector<Real> pl(paths);
+
+    auto runBlocks = [&](const Size t) {
+        for (Size b = t; b < nBlocks; b += nThreads) {
+            PseudoRandom::rsg_type rng = PseudoRandom::make_sequence_generator(dim, blockSeeds[b]);
+            Size end = std::min(paths, (b + 1) * blockSize);
+            for (Size i = b * blockSize; i < end; ++i) {
+                const std::vector<Real>& z = rng.nextSequence().value;
+                Real tmp = 0.0;
+                for (Size k = 0; k < dim; ++k)
+                    tmp += z[k] * (deltaBar[k] + lambda[k] * z[k]);
+                pl[i] = tmp;
+            }
+        }
+    };
+
+    Size nEffThreads = std::min(nThreads, nBlocks);
+    if (nEffThreads == 1) {
+        runBlocks(0);
+    } else {
+        std::vector<std::exception_ptr> errors(nEffThreads);
+        std::vector<std::thread> jobs;
+        for (Size t = 0; t < nEffThreads; ++t) {
+            jobs.emplace_back([&runBlocks, &errors, t]() {
+                try {
+                    runBlocks(t);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        for (auto& j : jobs)
+            j.join();
+        for (auto const& e : errors) {
+            if (e)
+                std::rethrow_exception(e);
+        }
+    }
+
+    // the quantile p is the k-th largest realisation with k = ceil(paths * (1 - p)), as for the right
+    // tail_quantile accumulator used in deltaGammaVarMc(); we only sort the part of the PL vector we need
+
+    std::vector<Size> k(p.size());
+    Size kMax = 1;
+    for (Size i = 0; i < p.size(); ++i) {
+        k[i] = std::max<Size>(1, static_cast<Size>(std::ceil(static_cast<Real>(paths) * (1.0 - p[i]))));
+        k[i] = std::min(k[i], paths);
+        kMax = std::max(kMax, k[i]);
+    }
+
+    std::nth_element(pl.begin(), pl.begin() + (kMax - 1), pl.end(), std::greater<Real>());
+    std::sort(pl.begin(), pl.begin() + kMax, std::greater<Real>());
+
+    std::vector<Real> res(p.size());
+    for (Size i = 0; i < p.size(); ++i)
+        res[i] = pl[k[i] - 1];
+
+    return res;
+} // deltaGammaVarMcDiagonal
+
+Real deltaGammaVarMcDiagonal(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p,
+                             const Size paths, const Size seed, const CovarianceSalvage& sal, const Size nThreads,
+                             const Size blockSize) {
+    return deltaGammaVarMcDiagonal(omega, delta, gamma, std::vector<Real>(1, p), paths, seed, sal, nThreads,
+                                   blockSize)
+        .front();
+}
+
 } // namespace QuantExt
@@ -75,6 +75,23 @@ std::vector<Real> deltaGammaVarMc(const Matrix& omega, const Array& delta, const
 				  const std::vector<Real>& p, const Size paths, const Size seed,
 				  const CovarianceSalvage& sal = NoCovarianceSalvage());
 
+//! function that computes a delta-gamma VaR using Monte Carlo in the eigenbasis of the gamma (multiple quantiles)
+/*! Same as deltaGammaVarMc(), but the PL is transformed once into the eigenbasis of 1/2 L^T gamma L (with L the
+ * pseudo square root of omega), in which it reads sum_k deltaBar_k z_k + lambda_k z_k^2 for independent standard
+ * normal variates z_k. A path then costs O(n) instead of O(n^2). The paths are generated in blocks of blockSize
+ * paths, each block using its own pseudo random sequence seeded from seed, so that the blocks can be processed on
+ * nThreads threads and the result does not depend on the number of threads. The quantiles are estimated from a
+ * partial sort of the PL realisations. */
+std::vector<Real> deltaGammaVarMcDiagonal(const Matrix& omega, const Array& delta, const Matrix& gamma,
+                                          const std::vector<Real>& p, const Size paths, const Size seed,
+                                          const CovarianceSalvage& sal = NoCovarianceSalvage(),
+                                          const Size nThreads = 1, const Size blockSize = 1024);
+
+//! function that computes a delta-gamma VaR using Monte Carlo in the eigenbasis of the gamma (single quantile)
+Real deltaGammaVarMcDiagonal(const Matrix& omega, const Array& delta, const Matrix& gamma, const Real p,
+                             const Size paths, const Size seed, const CovarianceSalvage& sal = NoCovarianceSalvage(),
+                             const Size nThreads = 1, const Size blockSize = 1024);
+
 namespace detail {
 void check(const Real p);
 void check(const Matrix& omega, const Array& delta);
@@ -19,10 +19,15 @@
 #ifndef quantext_nadaraya_watson_regression_hpp
 #define quantext_nadaraya_watson_regression_hpp
 
+#include <ql/errors.hpp>
 #include <ql/math/comparison.hpp>
 
 #include <boost/make_shared.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 /*! \file qle/math/nadarayawatson.hpp
     \brief Nadaraya-Watson regression
     \ingroup math
@@ -118,6 +123,121 @@ private:
     boost::shared_ptr<detail::RegressionImpl> impl_;
 };
 
+//! Binned Nadaraya Watson regression
+/*! Approximation of the Nadaraya Watson estimator for large samples. The x values are linearly binned on an
+    equidistant grid of gridSize points spanning [min x, max x] and the kernel sums are computed on the grid by a
+    discrete convolution, truncated where the distance exceeds kernelSupport. The estimator is evaluated by linear
+    interpolation of the kernel sums between the grid points, x values outside the grid are flat extrapolated.
+
+    The setup cost is O(n + gridSize * L) with L = min(gridSize, kernelSupport / grid spacing), an evaluation is
+    O(1), whereas an evaluation of NadarayaWatson is O(n).
+
+    \pre kernel needs a Real operator()(Real x) implementation and must be symmetric
+    \pre the $ x $ values do not need to be sorted
+
+    \ingroup math
+*/
+class BinnedNadarayaWatson {
+public:
+    template <class I1, class I2, class Kernel>
+    BinnedNadarayaWatson(const I1& xBegin, const I1& xEnd, const I2& yBegin, const Kernel& kernel,
+                         const Real kernelSupport, const Size gridSize = 1024);
+
+    Real operator()(Real x) const {
+        Real s0, s1, s2;
+        sums(x, s0, s1, s2);
+        return QuantLib::close_enough(s0, 0.0) ? 0.0 : s1 / s0;
+    }
+
+    Real standardDeviation(Real x) const {
+        Real s0, s1, s2;
+        sums(x, s0, s1, s2);
+        return QuantLib::close_enough(s0, 0.0) ? 0.0 : std::sqrt(std::max(s2 / s0 - (s1 * s1) / (s0 * s0), 0.0));
+    }
+
+private:
+    // kernel sums of 1, y, y^2 at x
+    void sums(Real x, Real& s0, Real& s1, Real& s2) const {
+        if (s0_.size() == 1) {
+            s0 = s0_[0];
+            s1 = s1_[0];
+            s2 = s2_[0];
+            return;
+        }
+        Real p = std::min(std::max((x - xMin_) / dx_, 0.0), static_cast<Real>(s0_.size() - 1));
+        Size i = std::min(static_cast<Size>(p), s0_.size() - 2);
+        Real w = p - static_cast<Real>(i);
+        s0 = (1.0 - w) * s0_[i] + w * s0_[i + 1];
+        s1 = (1.0 - w) * s1_[i] + w * s1_[i + 1];
+        s2 = (1.0 - w) * s2_[i] + w * s2_[i + 1];
+    }
+
+    Real xMin_, dx_;
+    std::vector<Real> s0_, s1_, s2_;
+};
+
+template <class I1, class I2, class Kernel>
+BinnedNadarayaWatson::BinnedNadarayaWatson(const I1& xBegin, const I1& xEnd, const I2& yBegin, const Kernel& kernel,
+                                           const Real kernelSupport, const Size gridSize) {
+
+    Size n = static_cast<Size>(xEnd - xBegin);
+    QL_REQUIRE(n > 0, "BinnedNadarayaWatson: no data given");
+    QL_REQUIRE(gridSize >= 2, "BinnedNadarayaWatson: grid size (" << gridSize << ") must be at least 2");
+    QL_REQUIRE(kernelSupport > 0.0, "BinnedNadarayaWatson: kernel support (" << kernelSupport << ") must be positive");
+
+    auto minMax = std::minmax_element(xBegin, xEnd);
+    xMin_ = *minMax.first;
+    Real xMax = *minMax.second;
+    Size m = QuantLib::close_enough(xMin_, xMax) ? 1 : gridSize;
+    dx_ = m == 1 ? 0.0 : (xMax - xMin_) / static_cast<Real>(m - 1);
+
+    // linear binning of the weights 1, y, y^2
+
+    std::vector<Real> c0(m, 0.0), c1(m, 0.0), c2(m, 0.0);
+    for (Size i = 0; i < n; ++i) {
+        Real y = yBegin[i];
+        if (m == 1) {
+            c0[0] += 1.0;
+            c1[0] += y;
+            c2[0] += y * y;
+            continue;
+        }
+        Real p = std::min(std::max((xBegin[i] - xMin_) / dx_, 0.0), static_cast<Real>(m - 1));
+        Size j = std::min(static_cast<Size>(p), m - 2);
+        Real w = p - static_cast<Real>(j);
+        c0[j] += 1.0 - w;
+        c1[j] += (1.0 - w) * y;
+        c2[j] += (1.0 - w) * y * y;
+        c0[j + 1] += w;
+        c1[j + 1] += w * y;
+        c2[j + 1] += w * y * y;
+    }
+
+    // discrete convolution with the kernel, truncated at the kernel support
+
+    Size l = 0;
+    if (m > 1) {
+        Real tmp = std::ceil(kernelSupport / dx_);
+        l = tmp >= static_cast<Real>(m - 1) ? m - 1 : static_cast<Size>(tmp);
+    }
+    std::vector<Real> k(l + 1);
+    for (Size j = 0; j <= l; ++j)
+        k[j] = kernel(static_cast<Real>(j) * dx_);
+
+    s0_.resize(m, 0.0);
+    s1_.resize(m, 0.0);
+    s2_.resize(m, 0.0);
+    for (Size i = 0; i < m; ++i) {
+        Size jEnd = std::min(i + l, m - 1);
+        for (Size j = i > l ? i - l : 0; j <= jEnd; ++j) {
+            Real w = k[i > j ? i - j : j - i];
+            s0_[i] += w * c0[j];
+            s1_[i] += w * c1[j];
+            s2_[i] += w * c2[j];
+        }
+    }
+}
+
 } // namespace QuantExt
 
 #endif
@@ -0,0 +1,181 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/randomvariableregressioncache.hpp>
+
+#include <ql/math/matrixutilities/qrdecomposition.hpp>
+#include <ql/math/optimization/lmdif.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <tuple>
+
+namespace QuantExt {
+
+bool RandomVariableRegressionCache::Key::operator<(const Key& k) const {
+    return std::tie(samples, dim, polynomOrder, polynomType, hash) <
+           std::tie(k.samples, k.dim, k.polynomOrder, k.polynomType, k.hash);
+}
+
+void RandomVariableRegressionCache::enable(const Size maxSize) {
+    QL_REQUIRE(maxSize > 0, "RandomVariableRegressionCache::enable(): maxSize must be positive");
+    enabled_ = true;
+    maxSize_ = maxSize;
+    while (entries_.size() > maxSize_) {
+        entries_.erase(lru_.back());
+        lru_.pop_back();
+    }
+}
+
+void RandomVariableRegressionCache::disable() {
+    enabled_ = false;
+    clear();
+}
+
+void RandomVariableRegressionCache::clear() {
+    entries_.clear();
+    lru_.clear();
+    hits_ = misses_ = 0;
+}
+
+bool RandomVariableRegressionCache::matches(const Entry& e, const std::vector<const RandomVariable*>& regressor,
+                                            const Filter& filter) const {
+    if (!(e.filter == filter))
+        return false;
+    for (Size j = 0; j < regressor.size(); ++j) {
+        for (Size i = 0; i < regressor[j]->size(); ++i) {
+            if (e.regressor[j][i] != (*regressor[j])[i])
+                return false;
+        }
+    }
+    return true;
+}
+
+Array RandomVariableRegressionCache::regressionCoefficients(
+    const RandomVariable& r, const std::vector<const RandomVariable*>& regressor,
+    const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+    const Size polynomOrder, const QuantLib::LsmBasisSystem::PolynomialType polynomType, const Filter& filter) {
+
+    if (!enabled_)
+        return QuantExt::regressionCoefficients(r, regressor, basisFn, filter, RandomVariableRegressionMethod::QR);
+
+    Size n = r.size();
+    Size k = basisFn.size();
+
+    for (auto const reg : regressor) {
+        QL_REQUIRE(reg->size() == n, "RandomVariableRegressionCache::regressionCoefficients(): regressor size ("
+                                         << reg->size() << ") must match regressand size (" << n << ")");
+    }
+    QL_REQUIRE(filter.size() == 0 || filter.size() == n,
+               "RandomVariableRegressionCache::regressionCoefficients(): filter size ("
+                   << filter.size() << ") must match regressand size (" << n << ")");
+    QL_REQUIRE(n >= k, "RandomVariableRegressionCache::regressionCoefficients(): sample size ("
+                           << n << ") must be geq basis fns size (" << k << ")");
+
+    // build the key from the regressor values and the filter
+
+    std::size_t hash = 0;
+    for (auto const reg : regressor) {
+        for (Size i = 0; i < n; ++i)
+            boost::hash_combine(hash, (*reg)[i]);
+    }
+    if (filter.initialised()) {
+        for (Size i = 0; i < n; ++i)
+            boost::hash_combine(hash, filter[i]);
+    }
+
+    Key key{n, regressor.size(), polynomOrder, polynomType, hash};
+
+    auto e = entries_.find(key);
+
+    // on a hash collision we do not touch the cache, but compute the coefficients without it
+
+    if (e != entries_.end() && !matches(e->second, regressor, filter)) {
+        ++misses_;
+        return QuantExt::regressionCoefficients(r, regressor, basisFn, filter, RandomVariableRegressionMethod::QR);
+    }
+
+    if (e == entries_.end()) {
+
+        ++misses_;
+
+        // build the design matrix, this is done as in regressionCoefficients()
+
+        Matrix A(n, k);
+        for (Size j = 0; j < k; ++j) {
+            RandomVariable a = basisFn[j](regressor);
+            if (filter.initialised()) {
+                a = applyFilter(a, filter);
+            }
+            if (a.deterministic())
+                std::fill(A.column_begin(j), A.column_end(j), a[0]);
+            else
+                a.copyToMatrixCol(A, j);
+        }
+
+        // factorise the design matrix and store the factorisation
+
+        Matrix q, rr;
+        std::vector<Size> pivot = qrDecomposition(A, q, rr, true);
+
+        Entry entry;
+        entry.regressor.resize(regressor.size());
+        for (Size j = 0; j < regressor.size(); ++j) {
+            entry.regressor[j].resize(n);
+            for (Size i = 0; i < n; ++i)
+                entry.regressor[j][i] = (*regressor[j])[i];
+        }
+        entry.filter = filter;
+        entry.qT = transpose(q);
+        entry.rT = transpose(rr);
+        entry.ipvt = std::vector<int>(pivot.begin(), pivot.end());
+
+        if (entries_.size() >= maxSize_) {
+            entries_.erase(lru_.back());
+            lru_.pop_back();
+        }
+
+        lru_.push_front(key);
+        entry.lruPos = lru_.begin();
+        e = entries_.insert(std::make_pair(key, std::move(entry))).first;
+
+    } else {
+
+        ++hits_;
+        lru_.splice(lru_.begin(), lru_, e->second.lruPos);
+    }
+
+    // solve R P^T x = Q^T b, this is done as in QuantLib::qrSolve()
+
+    Array b(n);
+    RandomVariable rf = filter.initialised() ? applyFilter(r, filter) : r;
+    if (rf.deterministic())
+        std::fill(b.begin(), b.end(), rf[0]);
+    else
+        rf.copyToArray(b);
+
+    Array qtb = e->second.qT * b;
+    Matrix rT = e->second.rT; // qrsolv() overwrites the strict lower triangle
+    Array x(k), diag(k, 0.0), sdiag(k), wa(k);
+    MINPACK::qrsolv(static_cast<int>(k), rT.begin(), static_cast<int>(k), &e->second.ipvt[0], diag.begin(),
+                    qtb.begin(), x.begin(), sdiag.begin(), wa.begin());
+
+    return x;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,91 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/randomvariableregressioncache.hpp
+    \brief cache for factorised regression design matrices
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+
+#include <ql/patterns/singleton.hpp>
+
+#include <list>
+#include <map>
+
+namespace QuantExt {
+
+/*! Cache for the QR factorisation of regression design matrices. If the cache is enabled, regressions on identical
+    regressor data, basis system and filter reuse the factorisation A P = Q R, so that the coefficients for a new
+    regressand b only require the projection Q^T b and a triangular solve. The result is identical to the one of
+    regressionCoefficients() with RandomVariableRegressionMethod::QR.
+
+    Typical use is the calibration of amc engines that share the same calibration paths (e.g. several trades with the
+    same simulation grid) or several regression models on the same observation time of a single trade. Consumers
+    enable the cache for the scope of a portfolio run and clear it at the end. The number of cached factorisations
+    is bounded by maxSize, the least recently used one is evicted first. Since the class is a singleton, the cache is
+    local to a session in builds with QL_ENABLE_SESSIONS = ON, so no locking is required in multi-threaded runs. */
+class RandomVariableRegressionCache : public QuantLib::Singleton<RandomVariableRegressionCache> {
+public:
+    void enable(const Size maxSize = 100);
+    void disable();
+    bool enabled() const { return enabled_; }
+    void clear();
+
+    Size size() const { return entries_.size(); }
+    Size hits() const { return hits_; }
+    Size misses() const { return misses_; }
+
+    /*! Same as regressionCoefficients() with RandomVariableRegressionMethod::QR, if the cache is disabled the call is
+        forwarded to that function. The basis functions must be generated as multiPathBasisSystem(regressor.size(),
+        polynomOrder, polynomType), the latter two parameters are part of the cache key. */
+    Array regressionCoefficients(
+        const RandomVariable& r, const std::vector<const RandomVariable*>& regressor,
+        const std::vector<std::function<RandomVariable(const std::vector<const RandomVariable*>&)>>& basisFn,
+        const Size polynomOrder, const QuantLib::LsmBasisSystem::PolynomialType polynomType,
+        const Filter& filter = Filter());
+
+private:
+    struct Key {
+        Size samples, dim, polynomOrder;
+        QuantLib::LsmBasisSystem::PolynomialType polynomType;
+        std::size_t hash;
+        bool operator<(const Key& k) const;
+    };
+
+    struct Entry {
+        // regressor values and filter, to verify a hash hit
+        std::vector<std::vector<Real>> regressor;
+        Filter filter;
+        // the factorisation: qT = Q^T (k x n), rT = R^T (k x k), pivot vector
+        Matrix qT, rT;
+        std::vector<int> ipvt;
+        std::list<Key>::iterator lruPos;
+    };
+
+    // true if the entry was built from the given regressor and filter (i.e. we do not have a hash collision)
+    bool matches(const Entry& e, const std::vector<const RandomVariable*>& regressor, const Filter& filter) const;
+
+    bool enabled_ = false;
+    Size maxSize_ = 0, hits_ = 0, misses_ = 0;
+    std::map<Key, Entry> entries_;
+    std::list<Key> lru_;
+};
+
+} // namespace QuantExt
@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/affinestateevolution.hpp>
+
+#include <algorithm>
+#include <thread>
+
+using namespace QuantLib;
+
+namespace QuantExt {
+
+namespace {
+
+/* evolve the paths [offset, offset + n) given the variates z[i * m + k][p - offset] for step i, factor k, path p,
+   the state buffer x must have d rows of size >= n */
+void evolveBlock(const Size offset, const Size n, const Array& x0, const std::vector<Array>& a,
+                 const std::vector<Matrix>& B, const std::vector<Matrix>& D,
+                 const std::vector<std::vector<RandomVariable*>>& output, const std::vector<std::vector<Real>>& z,
+                 std::vector<std::vector<Real>>& x, std::vector<std::vector<Real>>& xNew) {
+
+    Size d = x0.size();
+    Size m = D.empty() ? 0 : D.front().columns();
+
+    for (Size j = 0; j < d; ++j)
+        std::fill(x[j].begin(), x[j].begin() + n, x0[j]);
+
+    for (Size i = 0; i < a.size(); ++i) {
+
+        // xNew = a_i + B_i x + D_i z_i, the innermost loops run over the paths
+
+        for (Size j = 0; j < d; ++j) {
+            Real* y = xNew[j].data();
+            std::fill(y, y + n, a[i][j]);
+            if (B.empty()) {
+                const Real* xj = x[j].data();
+                for (Size p = 0; p < n; ++p)
+                    y[p] += xj[p];
+            } else {
+                for (Size k = 0; k < d; ++k) {
+                    Real b = B[i][j][k];
+                    if (b == 0.0)
+                        continue;
+                    const Real* xk = x[k].data();
+                    for (Size p = 0; p < n; ++p)
+                        y[p] += b * xk[p];
+                }
+            }
+            for (Size k = 0; k < m; ++k) {
+                Real c = D[i][j][k];
+                if (c == 0.0)
+                    continue;
+                const Real* zk = z[i * m + k].data();
+                for (Size p = 0; p < n; ++p)
+                    y[p] += c * zk[p];
+            }
+        }
+
+        std::swap(x, xNew);
+
+        // store the result if required
+
+        if (output[i].empty())
+            continue;
+        for (Size j = 0; j < d; ++j) {
+            if (output[i][j] == nullptr)
+                continue;
+            std::copy(x[j].begin(), x[j].begin() + n, output[i][j]->data() + offset);
+        }
+    }
+}
+
+} // namespace
+
+void evolveAffineStateVectorised(const boost::shared_ptr<MultiPathVariateGeneratorBase>& gen, const Size nSamples,
+                                 const Array& x0, const std::vector<Array>& a, const std::vector<Matrix>& B,
+                                 const std::vector<Matrix>& D,
+                                 const std::vector<std::vector<RandomVariable*>>& output, const Size blockSize,
+                                 const Size nThreads) {
+
+    Size steps = a.size();
+    Size d = x0.size();
+
+    QL_REQUIRE(blockSize > 0, "evolveAffineStateVectorised(): blockSize must be positive");
+    QL_REQUIRE(nThreads > 0, "evolveAffineStateVectorised(): nThreads must be positive");
+    QL_REQUIRE(D.size() == steps, "evolveAffineStateVectorised(): D size (" << D.size() << ") does not match a size ("
+                                                                              << steps << ")");
+    QL_REQUIRE(B.empty() || B.size() == steps, "evolveAffineStateVectorised(): B size ("
+                                                   << B.size() << ") does not match a size (" << steps << ")");
+    QL_REQUIRE(output.size() == steps, "evolveAffineStateVectorised(): output size ("
+                                           << output.size() << ") does not match a size (" << steps << ")");
+
+    if (steps == 0 || nSamples == 0)
+        return;
+
+    Size m = D.front().columns();
+
+    for (Size i = 0; i < steps; ++i) {
+        QL_REQUIRE(a[i].size() == d, "evolveAffineStateVectorised(): a[" << i << "] has size " << a[i].size()
+                                                                         << ", expected " << d);
+        QL_REQUIRE(D[i].rows() == d && D[i].columns() == m, "evolveAffineStateVectorised(): D["
+                                                                << i << "] is " << D[i].rows() << "x"
+                                                                << D[i].columns() << ", expected " << d << "x" << m);
+        QL_REQUIRE(B.empty() || (B[i].rows() == d && B[i].columns() == d),
+                   "evolveAffineStateVectorised(): B[" << i << "] is " << B[i].rows() << "x" << B[i].columns()
+                                                       << ", expected " << d << "x" << d);
+        QL_REQUIRE(output[i].empty() || output[i].size() == d, "evolveAffineStateVectorised(): output["
+                                                                   << i << "] has size " << output[i].size()
+                                                                   << ", expected 0 or " << d);
+        for (auto r : output[i]) {
+            if (r != nullptr) {
+                QL_REQUIRE(r->size() == nSamples, "evolveAffineStateVectorised(): output rv has size "
+                                                      << r->size() << ", expected " << nSamples);
+                r->expand();
+            }
+        }
+    }
+
+    // per thread buffers for the variates and the states
+
+    std::vector<std::vector<std::vector<Real>>> z(
+        nThreads, std::vector<std::vector<Real>>(steps * m, std::vector<Real>(blockSize)));
+    std::vector<std::vector<std::vector<Real>>> x(nThreads,
+                                                  std::vector<std::vector<Real>>(d, std::vector<Real>(blockSize)));
+    std::vector<std::vector<std::vector<Real>>> xNew(x);
+
+    for (Size offset = 0; offset < nSamples; offset += nThreads * blockSize) {
+
+        // draw the variates for up to nThreads blocks sequentially
+
+        std::vector<Size> blockOffset, blockLength;
+        for (Size t = 0; t < nThreads && offset + t * blockSize < nSamples; ++t) {
+            Size o = offset + t * blockSize;
+            Size n = std::min(blockSize, nSamples - o);
+            for (Size p = 0; p < n; ++p) {
+                auto seq = gen->next();
+                for (Size i = 0; i < steps; ++i)
+                    for (Size k = 0; k < m; ++k)
+                        z[t][i * m + k][p] = seq.value[i][k];
+            }
+            blockOffset.push_back(o);
+            blockLength.push_back(n);
+        }
+
+        // evolve the blocks, in parallel if more than one thread is requested
+
+        if (blockOffset.size() == 1) {
+            evolveBlock(blockOffset[0], blockLength[0], x0, a, B, D, output, z[0], x[0], xNew[0]);
+        } else {
+            std::vector<std::thread> jobs;
+            for (Size t = 0; t < blockOffset.size(); ++t) {
+                jobs.emplace_back(evolveBlock, blockOffset[t], blockLength[t], std::cref(x0), std::cref(a),
+                                  std::cref(B), std::cref(D), std::cref(output), std::cref(z[t]), std::ref(x[t]),
+                                  std::ref(xNew[t]));
+            }
+            for (auto& j : jobs)
+                j.join();
+        }
+    }
+}
+
+} // namespace QuantExt
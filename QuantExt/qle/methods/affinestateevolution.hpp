@@ -0,0 +1,52 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file methods/affinestateevolution.hpp
+    \brief vectorised evolution of a process with affine conditional expectation and state independent diffusion
+    \ingroup models
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
+
+namespace QuantExt {
+
+/*! Evolves nSamples paths of a d-dimensional process given by
+
+    x_{i+1} = a_i + B_i x_i + D_i z_i,   i = 0, ..., n - 1
+
+    starting at x0, where z_i is the vector of m independent N(0,1) variates for step i drawn from gen. The dimensions
+    are a_i: d, B_i: d x d, D_i: d x m. If B is empty, B_i is assumed to be the identity matrix for all i.
+
+    The result is written to output, where output[i][j] holds component j of x_{i+1}. If output[i] is empty, the
+    states after step i are not stored. Null pointers in output[i] are allowed and skipped. Non-null random variables
+    must have size nSamples, they are expanded before they are written to.
+
+    All paths of a block of blockSize samples are evolved together step by step as a matrix times (factors x samples)
+    product. If nThreads > 1, the blocks are evolved in parallel. The variates are always drawn from gen in path order,
+    so that the result does not depend on blockSize or nThreads.
+*/
+void evolveAffineStateVectorised(const boost::shared_ptr<MultiPathVariateGeneratorBase>& gen, const Size nSamples,
+                                 const Array& x0, const std::vector<Array>& a, const std::vector<Matrix>& B,
+                                 const std::vector<Matrix>& D,
+                                 const std::vector<std::vector<RandomVariable*>>& output, const Size blockSize = 1024,
+                                 const Size nThreads = 1);
+
+} // namespace QuantExt
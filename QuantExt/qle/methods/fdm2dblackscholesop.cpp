@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/fdm2dblackscholesop.hpp>
+
+#include <ql/math/comparison.hpp>
+#include <ql/methods/finitedifferences/meshers/fdmmesher.hpp>
+#include <ql/methods/finitedifferences/operators/fdmlinearoplayout.hpp>
+#include <ql/methods/finitedifferences/operators/secondordermixedderivativeop.hpp>
+
+namespace QuantExt {
+
+Fdm2dBlackScholesOp::Fdm2dBlackScholesOp(const ext::shared_ptr<FdmMesher>& mesher,
+                                         const ext::shared_ptr<GeneralizedBlackScholesProcess>& p1,
+                                         const ext::shared_ptr<GeneralizedBlackScholesProcess>& p2,
+                                         const Real correlation, const Real strike1, const Real strike2,
+                                         const bool discounting, const bool ensureNonNegativeForwardVariance)
+    : mesher_(mesher), p1_(p1), p2_(p2), correlation_(correlation), strike1_(strike1), strike2_(strike2),
+      discounting_(discounting), ensureNonNegativeForwardVariance_(ensureNonNegativeForwardVariance),
+      opX_(mesher, p1, strike1, false, -Null<Real>(), 0, ext::shared_ptr<FdmQuantoHelper>(), false,
+           ensureNonNegativeForwardVariance),
+      opY_(mesher, p2, strike2, false, -Null<Real>(), 1, ext::shared_ptr<FdmQuantoHelper>(), false,
+           ensureNonNegativeForwardVariance),
+      corrMapTemplate_(SecondOrderMixedDerivativeOp(0, 1, mesher)), corrMapT_(corrMapTemplate_),
+      currentDiscountRate_(0.0) {
+    QL_REQUIRE(mesher_->layout()->dim().size() == 2,
+               "Fdm2dBlackScholesOp: mesher dimension (" << mesher_->layout()->dim().size() << ") must be 2");
+    QL_REQUIRE(correlation_ >= -1.0 && correlation_ <= 1.0,
+               "Fdm2dBlackScholesOp: correlation (" << correlation_ << ") must be in [-1,1]");
+}
+
+Real Fdm2dBlackScholesOp::forwardVariance(const ext::shared_ptr<GeneralizedBlackScholesProcess>& p,
+                                          const Real strike, const Time t1, const Time t2) const {
+    // this mirrors the computation in FdmBlackScholesOp
+    Real k1, k2;
+    if (strike == Null<Real>()) {
+        k1 = p->x0() * p->dividendYield()->discount(t1) / p->riskFreeRate()->discount(t1);
+        k2 = p->x0() * p->dividendYield()->discount(t2) / p->riskFreeRate()->discount(t2);
+    } else {
+        k1 = k2 = strike;
+    }
+    Real v = ((close_enough(t2, 0.0) ? 0.0 : p->blackVolatility()->blackVariance(t2, k2)) -
+              (close_enough(t1, 0.0) ? 0.0 : p->blackVolatility()->blackVariance(t1, k1))) /
+             (t2 - t1);
+    return ensureNonNegativeForwardVariance_ ? std::max(v, 0.0) : v;
+}
+
+void Fdm2dBlackScholesOp::setTime(Time t1, Time t2) {
+    opX_.setTime(t1, t2);
+    opY_.setTime(t1, t2);
+    Real v1 = std::max(forwardVariance(p1_, strike1_, t1, t2), 0.0);
+    Real v2 = std::max(forwardVariance(p2_, strike2_, t1, t2), 0.0);
+    corrMapT_ = corrMapTemplate_.mult(Array(mesher_->layout()->size(), correlation_ * std::sqrt(v1 * v2)));
+    currentDiscountRate_ = discounting_ ? p1_->riskFreeRate()->forwardRate(t1, t2, Continuous).rate() : 0.0;
+}
+
+Size Fdm2dBlackScholesOp::size() const { return 2u; }
+
+Array Fdm2dBlackScholesOp::apply(const Array& r) const { return opX_.apply(r) + opY_.apply(r) + apply_mixed(r); }
+
+Array Fdm2dBlackScholesOp::apply_mixed(const Array& r) const {
+    return corrMapT_.apply(r) - currentDiscountRate_ * r;
+}
+
+Array Fdm2dBlackScholesOp::apply_direction(Size direction, const Array& r) const {
+    if (direction == 0)
+        return opX_.apply(r);
+    else if (direction == 1)
+        return opY_.apply(r);
+    else
+        return Array(r.size(), 0.0);
+}
+
+Array Fdm2dBlackScholesOp::solve_splitting(Size direction, const Array& r, Real dt) const {
+    if (direction == 0)
+        return opX_.solve_splitting(0, r, dt);
+    else if (direction == 1)
+        return opY_.solve_splitting(1, r, dt);
+    else
+        return r;
+}
+
+Array Fdm2dBlackScholesOp::preconditioner(const Array& r, Real dt) const { return solve_splitting(0, r, dt); }
+
+#if !defined(QL_NO_UBLAS_SUPPORT)
+std::vector<QuantLib::SparseMatrix> Fdm2dBlackScholesOp::toMatrixDecomp() const {
+    QuantLib::SparseMatrix mixed = corrMapT_.toMatrix();
+    for (Size i = 0; i < mesher_->layout()->size(); ++i)
+        mixed(i, i) -= currentDiscountRate_;
+    std::vector<QuantLib::SparseMatrix> retVal = {opX_.toMatrixDecomp().front(), opY_.toMatrixDecomp().front(),
+                                                  mixed};
+    return retVal;
+}
+#endif
+
+} // namespace QuantExt
@@ -0,0 +1,76 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file fdm2dblackscholesop.hpp
+    \brief two dimensional black scholes operator, see the documentation for details
+*/
+
+#pragma once
+
+#include <qle/methods/fdmblackscholesop.hpp>
+
+#include <ql/methods/finitedifferences/operators/ninepointlinearop.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+/* Black Scholes linear operator for two underlyings on a two dimensional log-spot mesher. The operator is composed of
+   two one dimensional FdmBlackScholesOp instances in direction 0 and 1 and a mixed derivative term
+
+           rho * sigma1 * sigma2 * d^2/dx1dx2
+
+   The volatilities are read off at the atmf level (strike = null) or at the given strikes, exactly as in
+   FdmBlackScholesOp. The correlation rho is assumed to be constant. The discounting term -r dt, with r the
+   risk free rate of the first process, can be suppressed setting discounting = false. If
+   ensureNonNegativeForwardVariance is true, the forward variances from the input vol ts are floored at zero. */
+class Fdm2dBlackScholesOp : public FdmLinearOpComposite {
+public:
+    Fdm2dBlackScholesOp(const ext::shared_ptr<FdmMesher>& mesher,
+                        const ext::shared_ptr<GeneralizedBlackScholesProcess>& p1,
+                        const ext::shared_ptr<GeneralizedBlackScholesProcess>& p2, const Real correlation,
+                        const Real strike1 = Null<Real>(), const Real strike2 = Null<Real>(),
+                        const bool discounting = true, const bool ensureNonNegativeForwardVariance = false);
+
+    Size size() const override;
+    void setTime(Time t1, Time t2) override;
+
+    Array apply(const Array& r) const override;
+    Array apply_mixed(const Array& r) const override;
+    Array apply_direction(Size direction, const Array& r) const override;
+    Array solve_splitting(Size direction, const Array& r, Real s) const override;
+    Array preconditioner(const Array& r, Real s) const override;
+
+#if !defined(QL_NO_UBLAS_SUPPORT)
+    std::vector<QuantLib::SparseMatrix> toMatrixDecomp() const override;
+#endif
+private:
+    Real forwardVariance(const ext::shared_ptr<GeneralizedBlackScholesProcess>& p, const Real strike, const Time t1,
+                         const Time t2) const;
+
+    const ext::shared_ptr<FdmMesher> mesher_;
+    const ext::shared_ptr<GeneralizedBlackScholesProcess> p1_, p2_;
+    const Real correlation_, strike1_, strike2_;
+    const bool discounting_;
+    const bool ensureNonNegativeForwardVariance_;
+    FdmBlackScholesOp opX_, opY_;
+    const NinePointLinearOp corrMapTemplate_;
+    NinePointLinearOp corrMapT_;
+    Real currentDiscountRate_;
+};
+
+} // namespace QuantExt
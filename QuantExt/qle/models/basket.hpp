@@ -228,6 +228,8 @@ public:
     */
     //@{
     Real expectedTrancheLoss(const Date& d, Real recoveryRate = Null<Real>()) const;
+    //! expected tranche losses for several dates, computed in one pass if supported by the model
+    std::vector<Real> expectedTrancheLosses(const std::vector<Date>& dates, Real recoveryRate = Null<Real>()) const;
     /*! The lossFraction is the fraction of losses expressed in
         inception (no losses) tranche units (e.g. 'attach level'=0%,
         'detach level'=100%)
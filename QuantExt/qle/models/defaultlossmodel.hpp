@@ -71,6 +71,14 @@ protected:
     virtual Real expectedTrancheLoss(const Date& d, Real recoveryRate = Null<Real>()) const {
         QL_FAIL("expectedTrancheLoss Not implemented for this model.");
     }
+    /* Expected tranche losses for several dates, models can override this to compute all dates in one pass. */
+    virtual std::vector<Real> expectedTrancheLosses(const std::vector<Date>& dates,
+                                                    Real recoveryRate = Null<Real>()) const {
+        std::vector<Real> res;
+        for (auto const& d : dates)
+            res.push_back(expectedTrancheLoss(d, recoveryRate));
+        return res;
+    }
     /*! Probability of the tranche losing the same or more than the
         fractional amount given.
 
@@ -61,11 +61,16 @@ public:
 
     void update() const override;
 
+    /*! the number of calls to update(), clients caching values derived from the parameters can compare this to
+        detect a change of the parameters, e.g. after a recalibration */
+    QuantLib::Size updateCount() const { return updateCount_; }
+
 protected:
     QuantLib::Size n_, m_;
 
 private:
     const QuantLib::Handle<TS> termStructure_;
+    mutable QuantLib::Size updateCount_ = 0;
 };
 
 // implementation
@@ -84,7 +89,10 @@ template <class TS> QuantLib::Array HwParametrization<TS>::g(const QuantLib::Tim
     QL_FAIL("HwParametrization::g(t, T) not implemented");
 }
 
-template <class TS> void HwParametrization<TS>::update() const { Parametrization::update(); }
+template <class TS> void HwParametrization<TS>::update() const {
+    Parametrization::update();
+    ++updateCount_;
+}
 
 // typedef
 
@@ -0,0 +1,374 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/models/hwvectorised.hpp>
+
+#include <ql/indexes/indexmanager.hpp>
+
+namespace QuantExt {
+
+void HwVectorised::checkCache() const {
+    if (p_->updateCount() != cacheUpdateCount_ || bondTerms_.size() >= maxCacheSize) {
+        bondTerms_.clear();
+        cacheUpdateCount_ = p_->updateCount();
+    }
+}
+
+const HwVectorised::BondTerms& HwVectorised::bondTerms(const Time t, const Time T) const {
+    auto k = std::make_pair(t, T);
+    auto b = bondTerms_.find(k);
+    if (b != bondTerms_.end())
+        return b->second;
+    BondTerms terms;
+    terms.g = p_->g(t, T);
+    Matrix y = p_->y(t);
+    terms.gyg = 0.5 * DotProduct(terms.g, y * terms.g);
+    return bondTerms_.insert(std::make_pair(k, terms)).first->second;
+}
+
+RandomVariable HwVectorised::numeraire(const Time t, const std::vector<RandomVariable>& aux,
+                                       const Handle<YieldTermStructure>& discountCurve) const {
+    QL_REQUIRE(t >= 0.0, "t (" << t << ") >= 0 required in HwVectorised::numeraire");
+    QL_REQUIRE(!aux.empty(), "HwVectorised::numeraire(): aux state required");
+    Size n = aux.front().size();
+    RandomVariable sum(n, 0.0);
+    for (auto const& a : aux)
+        sum += a;
+    return exp(sum) /
+           RandomVariable(n, (discountCurve.empty() ? p_->termStructure()->discount(t) : discountCurve->discount(t)));
+}
+
+RandomVariable HwVectorised::discountBond(const Time t, const Time T, const std::vector<RandomVariable>& x,
+                                          const Handle<YieldTermStructure>& discountCurve) const {
+    QL_REQUIRE(x.size() == p_->n(),
+               "HwVectorised::discountBond(): state size (" << x.size() << ") does not match n (" << p_->n() << ")");
+    Size n = x.front().size();
+    if (QuantLib::close_enough(t, T))
+        return RandomVariable(n, 1.0);
+    QL_REQUIRE(T >= t && t >= 0.0, "T(" << T << ") >= t(" << t << ") >= 0 required in HwVectorised::discountBond");
+    checkCache();
+    const BondTerms& b = bondTerms(t, T);
+    RandomVariable gx(n, 0.0);
+    for (Size i = 0; i < x.size(); ++i)
+        gx += RandomVariable(n, b.g[i]) * x[i];
+    return RandomVariable(n,
+                          (discountCurve.empty() ? p_->termStructure()->discount(T) / p_->termStructure()->discount(t)
+                                                 : discountCurve->discount(T) / discountCurve->discount(t))) *
+           exp(-gx - RandomVariable(n, b.gyg));
+}
+
+RandomVariable HwVectorised::bondRatio(const Time t, const Time T1, const Time T2,
+                                       const std::vector<RandomVariable>& x,
+                                       const Handle<YieldTermStructure>& curve) const {
+    QL_REQUIRE(x.size() == p_->n(),
+               "HwVectorised::bondRatio(): state size (" << x.size() << ") does not match n (" << p_->n() << ")");
+    Size n = x.front().size();
+    QL_REQUIRE(T2 >= T1 && T1 >= t && t >= 0.0,
+               "T2(" << T2 << ") >= T1(" << T1 << ") >= t(" << t << ") >= 0 required in HwVectorised::bondRatio");
+    // the cache is not cleared between the two lookups, so that b1 stays valid while we look up b2
+    checkCache();
+    const BondTerms& b1 = bondTerms(t, T1);
+    const BondTerms& b2 = bondTerms(t, T2);
+    RandomVariable dgx(n, 0.0);
+    for (Size i = 0; i < x.size(); ++i)
+        dgx += RandomVariable(n, b1.g[i] - b2.g[i]) * x[i];
+    return RandomVariable(n, curve->discount(T1) / curve->discount(T2)) *
+           exp(-dgx - RandomVariable(n, b1.gyg - b2.gyg));
+}
+
+RandomVariable HwVectorised::fixing(const boost::shared_ptr<InterestRateIndex>& index, const Date& fixingDate,
+                                    const Time t, const std::vector<RandomVariable>& x) const {
+
+    QL_REQUIRE(!x.empty(), "HwVectorised::fixing(): empty state");
+
+    // handle case where fixing is deterministic
+
+    Date today = Settings::instance().evaluationDate();
+    if (fixingDate <= today)
+        return RandomVariable(x.front().size(), index->fixing(fixingDate));
+
+    // handle stochastic fixing
+
+    auto ibor = boost::dynamic_pointer_cast<IborIndex>(index);
+    QL_REQUIRE(ibor, "HwVectorised::fixing(): index ('" << index->name() << "') must be ibor index");
+    Date d1 = ibor->valueDate(fixingDate);
+    Date d2 = ibor->maturityDate(d1);
+    Time T1 = std::max(t, p_->termStructure()->timeFromReference(d1));
+    Time T2 = std::max(T1, p_->termStructure()->timeFromReference(d2));
+    const Handle<YieldTermStructure>& curve =
+        ibor->forwardingTermStructure().empty() ? p_->termStructure() : ibor->forwardingTermStructure();
+    Size n = x.front().size();
+    return (bondRatio(t, T1, T2, x, curve) - RandomVariable(n, 1.0)) /
+           RandomVariable(n, ibor->dayCounter().yearFraction(d1, d2));
+}
+
+RandomVariable HwVectorised::compoundedOnRate(const boost::shared_ptr<OvernightIndex>& index,
+                                              const std::vector<Date>& fixingDates,
+                                              const std::vector<Date>& valueDates, const std::vector<Real>& dt,
+                                              const Natural rateCutoff, const bool includeSpread, const Real spread,
+                                              const Real gearing, const Period lookback, Real cap, Real floor,
+                                              const bool localCapFloor, const bool nakedOption, const Time t,
+                                              const std::vector<RandomVariable>& x) const {
+
+    QL_REQUIRE(!x.empty(), "HwVectorised::compoundedOnRate(): empty state");
+
+    QL_REQUIRE(!includeSpread || QuantLib::close_enough(gearing, 1.0),
+               "HwVectorised::compoundedOnRate(): if include spread = true, only a gearing 1.0 is allowed - scale "
+               "the notional in this case instead.");
+
+    QL_REQUIRE(rateCutoff < dt.size(), "HwVectorised::compoundedOnRate(): rate cutoff ("
+                                           << rateCutoff << ") must be less than number of fixings in period ("
+                                           << dt.size() << ")");
+
+    // see LgmVectorised::compoundedOnRate() for the treatment of t > first value date
+
+    Size i = 0, n = dt.size(), samples = x.front().size();
+    Size nCutoff = n - rateCutoff;
+    Real compoundFactor = 1.0, compoundFactorWithoutSpread = 1.0;
+
+    Date today = Settings::instance().evaluationDate();
+
+    while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
+        Rate pastFixing = IndexManager::instance().getHistory(index->name())[fixingDates[std::min(i, nCutoff)]];
+        QL_REQUIRE(pastFixing != Null<Real>(), "HwVectorised::compoundedOnRate(): Missing "
+                                                   << index->name() << " fixing for "
+                                                   << fixingDates[std::min(i, nCutoff)]);
+        if (includeSpread) {
+            compoundFactorWithoutSpread *= (1.0 + pastFixing * dt[i]);
+            pastFixing += spread;
+        }
+        compoundFactor *= (1.0 + pastFixing * dt[i]);
+        ++i;
+    }
+
+    if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
+        Rate pastFixing = IndexManager::instance().getHistory(index->name())[fixingDates[std::min(i, nCutoff)]];
+        if (pastFixing != Null<Real>()) {
+            if (includeSpread) {
+                compoundFactorWithoutSpread *= (1.0 + pastFixing * dt[i]);
+                pastFixing += spread;
+            }
+            compoundFactor *= (1.0 + pastFixing * dt[i]);
+            ++i;
+        }
+    }
+
+    RandomVariable compoundFactorHw(samples, compoundFactor),
+        compoundFactorWithoutSpreadHw(samples, compoundFactorWithoutSpread);
+
+    if (i < n) {
+        Handle<YieldTermStructure> curve = index->forwardingTermStructure();
+        QL_REQUIRE(!curve.empty(),
+                   "HwVectorised::compoundedOnRate(): null term structure set to this instance of " << index->name());
+
+        DiscountFactor startDiscount = curve->discount(valueDates[i]);
+        DiscountFactor endDiscount = curve->discount(valueDates[std::max(nCutoff, i)]);
+
+        if (nCutoff < n) {
+            DiscountFactor discountCutoffDate =
+                curve->discount(valueDates[nCutoff] + 1) / curve->discount(valueDates[nCutoff]);
+            endDiscount *= std::pow(discountCutoffDate, valueDates[n] - valueDates[nCutoff]);
+        }
+
+        Real T1 = p_->termStructure()->timeFromReference(valueDates[i]);
+        Real T2 = p_->termStructure()->timeFromReference(valueDates[n]);
+
+        Real T1_hw = T1, T2_hw = T2;
+        if (t > T1) {
+            T1_hw += t - T1;
+            T2_hw += t - T1;
+        }
+
+        // the ratio of the discount factors estimated in the hw model, corrected to the actual curve portion
+
+        RandomVariable ratio = bondRatio(t, T1_hw, T2_hw, x, curve) *
+                               RandomVariable(samples, startDiscount / curve->discount(T1_hw) *
+                                                           curve->discount(T2_hw) / endDiscount);
+
+        compoundFactorHw *= ratio;
+
+        if (includeSpread) {
+            compoundFactorWithoutSpreadHw *= ratio;
+            Real tau =
+                index->dayCounter().yearFraction(valueDates[i], valueDates.back()) / (valueDates.back() - valueDates[i]);
+            compoundFactorHw *= RandomVariable(
+                samples, std::pow(1.0 + tau * spread, static_cast<int>(valueDates.back() - valueDates[i])));
+        }
+    }
+
+    Rate tau = index->dayCounter().yearFraction(valueDates.front(), valueDates.back());
+    RandomVariable rate = (compoundFactorHw - RandomVariable(samples, 1.0)) / RandomVariable(samples, tau);
+    RandomVariable swapletRate = RandomVariable(samples, gearing) * rate;
+    RandomVariable effectiveSpread, effectiveIndexFixing;
+    if (!includeSpread) {
+        swapletRate += RandomVariable(samples, spread);
+        effectiveSpread = RandomVariable(samples, spread);
+        effectiveIndexFixing = rate;
+    } else {
+        effectiveSpread = rate - (compoundFactorWithoutSpreadHw - RandomVariable(samples, 1.0)) /
+                                     RandomVariable(samples, tau);
+        effectiveIndexFixing = rate - effectiveSpread;
+    }
+
+    if (cap == Null<Real>() && floor == Null<Real>())
+        return swapletRate;
+
+    // handle cap / floor - we compute the intrinsic value only
+
+    if (gearing < 0.0) {
+        std::swap(cap, floor);
+    }
+
+    if (nakedOption)
+        swapletRate = RandomVariable(samples, 0.0);
+
+    RandomVariable floorletRate(samples, 0.0);
+    RandomVariable capletRate(samples, 0.0);
+
+    if (floor != Null<Real>()) {
+        // ignore localCapFloor, treat as global
+        RandomVariable effectiveStrike =
+            (RandomVariable(samples, floor) - effectiveSpread) / RandomVariable(samples, gearing);
+        floorletRate = RandomVariable(samples, gearing) *
+                       max(RandomVariable(samples, 0.0), effectiveStrike - effectiveIndexFixing);
+    }
+
+    if (cap != Null<Real>()) {
+        RandomVariable effectiveStrike =
+            (RandomVariable(samples, cap) - effectiveSpread) / RandomVariable(samples, gearing);
+        capletRate = RandomVariable(samples, gearing) *
+                     max(RandomVariable(samples, 0.0), effectiveIndexFixing - effectiveStrike);
+        if (nakedOption && floor == Null<Real>())
+            capletRate = -capletRate;
+    }
+
+    return swapletRate + floorletRate - capletRate;
+}
+
+RandomVariable HwVectorised::averagedOnRate(const boost::shared_ptr<OvernightIndex>& index,
+                                            const std::vector<Date>& fixingDates, const std::vector<Date>& valueDates,
+                                            const std::vector<Real>& dt, const Natural rateCutoff,
+                                            const bool includeSpread, const Real spread, const Real gearing,
+                                            const Period lookback, Real cap, Real floor, const bool localCapFloor,
+                                            const bool nakedOption, const Time t,
+                                            const std::vector<RandomVariable>& x) const {
+
+    QL_REQUIRE(!x.empty(), "HwVectorised::averagedOnRate(): empty state");
+
+    QL_REQUIRE(!includeSpread || QuantLib::close_enough(gearing, 1.0),
+               "HwVectorised::averageOnRate(): if include spread = true, only a gearing 1.0 is allowed - scale "
+               "the notional in this case instead.");
+
+    QL_REQUIRE(rateCutoff < dt.size(), "HwVectorised::averageOnRate(): rate cutoff ("
+                                           << rateCutoff << ") must be less than number of fixings in period ("
+                                           << dt.size() << ")");
+
+    // see LgmVectorised::compoundedOnRate() for the treatment of t > first value date
+
+    Size i = 0, n = dt.size(), samples = x.front().size();
+    Size nCutoff = n - rateCutoff;
+    Real accumulatedRate = 0.0;
+
+    Date today = Settings::instance().evaluationDate();
+
+    while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
+        Rate pastFixing = IndexManager::instance().getHistory(index->name())[fixingDates[std::min(i, nCutoff)]];
+        QL_REQUIRE(pastFixing != Null<Real>(), "HwVectorised::averageOnRate(): Missing "
+                                                   << index->name() << " fixing for "
+                                                   << fixingDates[std::min(i, nCutoff)]);
+        accumulatedRate += pastFixing * dt[i];
+        ++i;
+    }
+
+    if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
+        Rate pastFixing = IndexManager::instance().getHistory(index->name())[fixingDates[std::min(i, nCutoff)]];
+        if (pastFixing != Null<Real>()) {
+            accumulatedRate += pastFixing * dt[i];
+            ++i;
+        }
+    }
+
+    RandomVariable accumulatedRateHw(samples, accumulatedRate);
+
+    if (i < n) {
+        Handle<YieldTermStructure> curve = index->forwardingTermStructure();
+        QL_REQUIRE(!curve.empty(),
+                   "HwVectorised::averageOnRate(): null term structure set to this instance of " << index->name());
+
+        DiscountFactor startDiscount = curve->discount(valueDates[i]);
+        DiscountFactor endDiscount = curve->discount(valueDates[std::max(nCutoff, i)]);
+
+        if (nCutoff < n) {
+            DiscountFactor discountCutoffDate =
+                curve->discount(valueDates[nCutoff] + 1) / curve->discount(valueDates[nCutoff]);
+            endDiscount *= std::pow(discountCutoffDate, valueDates[n] - valueDates[nCutoff]);
+        }
+
+        Real T1 = p_->termStructure()->timeFromReference(valueDates[i]);
+        Real T2 = p_->termStructure()->timeFromReference(valueDates[n]);
+
+        Real T1_hw = T1, T2_hw = T2;
+        if (t > T1) {
+            T1_hw += t - T1;
+            T2_hw += t - T1;
+        }
+
+        accumulatedRateHw += log(bondRatio(t, T1_hw, T2_hw, x, curve) *
+                                 RandomVariable(samples, startDiscount / curve->discount(T1_hw) *
+                                                             curve->discount(T2_hw) / endDiscount));
+    }
+
+    Rate tau = index->dayCounter().yearFraction(valueDates.front(), valueDates.back());
+    RandomVariable rate =
+        RandomVariable(samples, gearing / tau) * accumulatedRateHw + RandomVariable(samples, spread);
+
+    if (cap == Null<Real>() && floor == Null<Real>())
+        return rate;
+
+    // handle cap / floor - we compute the intrinsic value only
+
+    if (gearing < 0.0) {
+        std::swap(cap, floor);
+    }
+
+    RandomVariable forwardRate = (rate - RandomVariable(samples, spread)) / RandomVariable(samples, gearing);
+    RandomVariable floorletRate(samples, 0.0);
+    RandomVariable capletRate(samples, 0.0);
+
+    if (nakedOption)
+        rate = RandomVariable(samples, 0.0);
+
+    if (floor != Null<Real>()) {
+        // ignore localCapFloor, treat as global
+        RandomVariable effectiveStrike = RandomVariable(samples, (floor - spread) / gearing);
+        floorletRate =
+            RandomVariable(samples, gearing) * max(RandomVariable(samples, 0.0), effectiveStrike - forwardRate);
+    }
+
+    if (cap != Null<Real>()) {
+        RandomVariable effectiveStrike = RandomVariable(samples, (cap - spread) / gearing);
+        capletRate =
+            RandomVariable(samples, gearing) * max(RandomVariable(samples, 0.0), forwardRate - effectiveStrike);
+        if (nakedOption && floor == Null<Real>())
+            capletRate = -capletRate;
+    }
+
+    return rate + floorletRate - capletRate;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,105 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file models/hwvectorised.hpp
+    \brief vectorised hull white n factor model calculations
+    \ingroup models
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/models/hwparametrization.hpp>
+
+#include <ql/indexes/iborindex.hpp>
+
+#include <map>
+
+namespace QuantExt {
+
+using namespace QuantLib;
+
+/*! Counterpart of LgmVectorised for the Hull White n factor model. The state x is given by the n factors, each as a
+    RandomVariable holding the values for all paths. The numeraire in the BA measure is computed from the aux state,
+    i.e. the integrals of the factors, see HwModel::numeraire().
+
+    The terms g(t,T) and g(t,T)^T y(t) g(t,T) are cached by (t,T), so that repeated evaluations on a fixed simulation
+    grid do not recompute them. The cache is cleared when the parametrization is updated (e.g. after a recalibration)
+    and when it reaches maxCacheSize entries. */
+class HwVectorised {
+public:
+    HwVectorised() = default;
+    HwVectorised(const boost::shared_ptr<IrHwParametrization>& p) : p_(p) {}
+
+    boost::shared_ptr<IrHwParametrization> parametrization() const { return p_; }
+
+    RandomVariable numeraire(const Time t, const std::vector<RandomVariable>& aux,
+                             const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const;
+
+    RandomVariable discountBond(const Time t, const Time T, const std::vector<RandomVariable>& x,
+                                const Handle<YieldTermStructure>& discountCurve = Handle<YieldTermStructure>()) const;
+
+    /* Handles IborIndex. Requires observation time t <= fixingDate */
+    RandomVariable fixing(const boost::shared_ptr<InterestRateIndex>& index, const Date& fixingDate, const Time t,
+                          const std::vector<RandomVariable>& x) const;
+
+    /* Exact if no cap/floors are present and t <= first value date.
+       Approximations are applied for t > first value date or when cap / floors are present. */
+    RandomVariable compoundedOnRate(const boost::shared_ptr<OvernightIndex>& index,
+                                    const std::vector<Date>& fixingDates, const std::vector<Date>& valueDates,
+                                    const std::vector<Real>& dt, const Natural rateCutoff, const bool includeSpread,
+                                    const Real spread, const Real gearing, const Period lookback, Real cap, Real floor,
+                                    const bool localCapFloor, const bool nakedOption, const Time t,
+                                    const std::vector<RandomVariable>& x) const;
+
+    /* Exact if no cap/floors are present and t <= first value date.
+       Approximations are applied for t > first value date or when cap / floors are present. */
+    RandomVariable averagedOnRate(const boost::shared_ptr<OvernightIndex>& index, const std::vector<Date>& fixingDates,
+                                  const std::vector<Date>& valueDates, const std::vector<Real>& dt,
+                                  const Natural rateCutoff, const bool includeSpread, const Real spread,
+                                  const Real gearing, const Period lookback, Real cap, Real floor,
+                                  const bool localCapFloor, const bool nakedOption, const Time t,
+                                  const std::vector<RandomVariable>& x) const;
+
+    void clearCache() const { bondTerms_.clear(); }
+
+    static constexpr Size maxCacheSize = 10000;
+
+private:
+    // g(t,T) and 0.5 * g(t,T)^T y(t) g(t,T)
+    struct BondTerms {
+        Array g;
+        Real gyg = 0.0;
+    };
+    /* clears the cache if the parametrization was updated or the cache is full, this must be called once before a
+       group of bondTerms() lookups, since bondTerms() itself never clears the cache and references returned by it
+       stay valid until the next call to checkCache() */
+    void checkCache() const;
+    const BondTerms& bondTerms(const Time t, const Time T) const;
+
+    /* ratio P(t,T1) / P(t,T2) of two zero bonds on the given curve, this is independent of the numeraire, the
+       displacement of T1, T2 for t > T1 is applied in compoundedOnRate() and averagedOnRate() */
+    RandomVariable bondRatio(const Time t, const Time T1, const Time T2, const std::vector<RandomVariable>& x,
+                             const Handle<YieldTermStructure>& curve) const;
+
+    boost::shared_ptr<IrHwParametrization> p_;
+    mutable std::map<std::pair<Time, Time>, BondTerms> bondTerms_;
+    mutable Size cacheUpdateCount_ = 0;
+};
+
+} // namespace QuantExt
@@ -55,6 +55,22 @@ LgmConvolutionSolver2::LgmConvolutionSolver2(const boost::shared_ptr<LinearGauss
             w_[i] = 0.0;
         }
     }
+
+    // state density on the grid for a rollback to t0 = 0, see rollback(), note that y_[i] * sigma / dx = y_[i] * nx
+
+    density_.resize(2 * mx_ + 1, 0.0);
+    for (int i = 0; i <= 2 * my_; i++) {
+        Real kp = y_[i] * static_cast<Real>(nx_) + mx_;
+        int kk = int(floor(kp));
+        if (kk < 0)
+            density_[0] += w_[i];
+        else if (kk + 1 > 2 * mx_)
+            density_[2 * mx_] += w_[i];
+        else {
+            density_[kk + 1] += w_[i] * (kp - kk);
+            density_[kk] += w_[i] * (1.0 + kk - kp);
+        }
+    }
 }
 
 RandomVariable LgmConvolutionSolver2::stateGrid(const Real t) const {
@@ -68,15 +84,46 @@ RandomVariable LgmConvolutionSolver2::stateGrid(const Real t) const {
     return x;
 }
 
+Real LgmConvolutionSolver2::rollbackToZero(const RandomVariable& v, const Real t) const {
+    if (QuantLib::close_enough(t, 0.0) || v.deterministic())
+        return v.at(0);
+    QL_REQUIRE(t > 0.0, "LgmConvolutionSolver2::rollbackToZero(): t (" << t << ") > 0 required.");
+    Real value = 0.0;
+    for (int k = 0; k <= 2 * mx_; k++)
+        value += density_[k] * v[k];
+    return value;
+}
+
 RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Real t1, const Real t0) const {
-    if (QuantLib::close_enough(t0, t1) || v.deterministic())
-        return v;
+    return rollback(std::vector<const RandomVariable*>{&v}, t1, t0).front();
+}
+
+std::vector<RandomVariable> LgmConvolutionSolver2::rollback(const std::vector<const RandomVariable*>& v,
+                                                            const Real t1, const Real t0) const {
+    std::vector<RandomVariable> result;
+    result.reserve(v.size());
+    for (auto const r : v)
+        result.push_back(*r);
+    if (QuantLib::close_enough(t0, t1))
+        return result;
+
+    // deterministic arrays are returned unchanged, the others are rolled back together
+    std::vector<Size> active;
+    for (Size j = 0; j < v.size(); ++j) {
+        if (!v[j]->deterministic())
+            active.push_back(j);
+    }
+    if (active.empty())
+        return result;
+
     QL_REQUIRE(t0 < t1, "LgmConvolutionSolver2::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
+
     Real sigma = std::sqrt(model_->parametrization()->zeta(t1));
     Real dx = sigma / static_cast<Real>(nx_);
+    std::vector<Real> sum(active.size());
     if (QuantLib::close_enough(t0, 0.0)) {
         // rollback from t1 to t0 = 0
-        Real value = 0.0;
+        std::fill(sum.begin(), sum.end(), 0.0);
         for (int i = 0; i <= 2 * my_; i++) {
             // Map y index to x index, not integer in general
             Real kp = y_[i] * sigma / dx + mx_;
@@ -84,18 +131,25 @@ RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Re
             int kk = int(floor(kp));
             // Get value at kp by linear interpolation on
             // kk <= kp <= kk + 1 with flat extrapolation
-            value +=
-                w_[i] *
-                (kk < 0 ? v[0] : (kk + 1 > 2 * mx_ ? v[2 * mx_] : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk]));
+            for (Size j = 0; j < active.size(); ++j) {
+                const RandomVariable& w = *v[active[j]];
+                sum[j] += w_[i] * (kk < 0 ? w[0]
+                                          : (kk + 1 > 2 * mx_ ? w[2 * mx_]
+                                                              : (kp - kk) * w[kk + 1] + (1.0 + kk - kp) * w[kk]));
+            }
         }
-        return RandomVariable(2 * mx_ + 1, value);
+        for (Size j = 0; j < active.size(); ++j)
+            result[active[j]] = RandomVariable(2 * mx_ + 1, sum[j]);
     } else {
-        RandomVariable value(2 * mx_ + 1, 0.0);
-        value.expand();
+        for (Size j = 0; j < active.size(); ++j) {
+            result[active[j]] = RandomVariable(2 * mx_ + 1, 0.0);
+            result[active[j]].expand();
+        }
         // rollback from t1 to t0 > 0
         Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
         Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
         for (int k = 0; k <= 2 * mx_; k++) {
+            std::fill(sum.begin(), sum.end(), 0.0);
             for (int i = 0; i <= 2 * my_; i++) {
                 // Map y index to x index, not integer in generalTo
                 Real kp = (dx2 * (k - mx_) + y_[i] * std) / dx + mx_;
@@ -103,14 +157,18 @@ RandomVariable LgmConvolutionSolver2::rollback(const RandomVariable& v, const Re
                 int kk = int(floor(kp));
                 // Get value at kp by linear interpolation on
                 // kk <= kp <= kk + 1 with flat extrapolation
-                value.set(k, value[k] + w_[i] * (kk < 0 ? v[0]
-                                                        : (kk + 1 > 2 * mx_
-                                                               ? v[2 * mx_]
-                                                               : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk])));
+                for (Size j = 0; j < active.size(); ++j) {
+                    const RandomVariable& w = *v[active[j]];
+                    sum[j] += w_[i] * (kk < 0 ? w[0]
+                                              : (kk + 1 > 2 * mx_ ? w[2 * mx_]
+                                                                  : (kp - kk) * w[kk + 1] + (1.0 + kk - kp) * w[kk]));
+                }
             }
+            for (Size j = 0; j < active.size(); ++j)
+                result[active[j]].set(k, sum[j]);
         }
-        return value;
     }
+    return result;
 }
 
 } // namespace QuantExt
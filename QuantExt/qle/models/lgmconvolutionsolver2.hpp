@@ -48,6 +48,18 @@ public:
     /* roll back an deflated NPV array from t1 to t0 */
     RandomVariable rollback(const RandomVariable& v, const Real t1, const Real t0) const;
 
+    /* roll back several deflated NPV arrays from t1 to t0 in one pass over the convolution kernel, the result is
+       identical to calling rollback() on each array */
+    std::vector<RandomVariable> rollback(const std::vector<const RandomVariable*>& v, const Real t1,
+                                         const Real t0) const;
+
+    /* weights d (state prices) such that rollback(v, t, 0) = sum_k d_k v[k] for t > 0, since the state grid scales
+       with the model standard deviation, the weights do not depend on t and are computed once */
+    const std::vector<Real>& stateDensity() const { return density_; }
+
+    /* same as rollback(v, t, 0.0).at(0), computed as the inner product of v with the state density */
+    Real rollbackToZero(const RandomVariable& v, const Real t) const;
+
     /* the underlying model */
     const boost::shared_ptr<LinearGaussMarkovModel>& model() const { return model_; }
 
@@ -55,7 +67,7 @@ private:
     boost::shared_ptr<LinearGaussMarkovModel> model_;
     int mx_, my_, nx_;
     Real h_;
-    std::vector<Real> y_, w_;
+    std::vector<Real> y_, w_, density_;
 };
 
 } // namespace QuantExt
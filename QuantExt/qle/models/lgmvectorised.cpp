@@ -95,15 +95,7 @@ RandomVariable LgmVectorised::fixing(const boost::shared_ptr<InterestRateIndex>&
 
         // Ibor Index
 
-        Date d1 = ibor->valueDate(fixingDate);
-        Date d2 = ibor->maturityDate(d1);
-        Time T1 = std::max(t, p_->termStructure()->timeFromReference(d1));
-        Time T2 = std::max(T1, p_->termStructure()->timeFromReference(d2));
-        Time dt = ibor->dayCounter().yearFraction(d1, d2);
-        // reducedDiscountBond is faster to compute, there we use this here instead of discountBond
-        RandomVariable disc1 = reducedDiscountBond(t, T1, x, ibor->forwardingTermStructure());
-        RandomVariable disc2 = reducedDiscountBond(t, T2, x, ibor->forwardingTermStructure());
-        return (disc1 / disc2 - RandomVariable(x.size(), 1.0)) / RandomVariable(x.size(), dt);
+        return fixing(iborFixingTerms(ibor, fixingDate, t), x);
     } else if (auto swap = boost::dynamic_pointer_cast<SwapIndex>(index)) {
 
         // Swap Index
@@ -186,6 +178,31 @@ RandomVariable LgmVectorised::fixing(const boost::shared_ptr<InterestRateIndex>&
     }
 }
 
+LgmVectorised::IborFixingTerms LgmVectorised::iborFixingTerms(const boost::shared_ptr<IborIndex>& index,
+                                                              const Date& fixingDate, const Time t) const {
+    Date d1 = index->valueDate(fixingDate);
+    Date d2 = index->maturityDate(d1);
+    Time T1 = std::max(t, p_->termStructure()->timeFromReference(d1));
+    Time T2 = std::max(T1, p_->termStructure()->timeFromReference(d2));
+    // this is the ratio of the reduced discount bonds P(t,T1) / P(t,T2), see reducedDiscountBond()
+    const Handle<YieldTermStructure>& curve =
+        index->forwardingTermStructure().empty() ? p_->termStructure() : index->forwardingTermStructure();
+    Real H1 = p_->H(T1), H2 = p_->H(T2);
+    IborFixingTerms terms;
+    terms.disc = curve->discount(T1) / curve->discount(T2);
+    terms.dH = H1 - H2;
+    terms.dHH = 0.5 * p_->zeta(t) * (H1 * H1 - H2 * H2);
+    terms.dt = index->dayCounter().yearFraction(d1, d2);
+    return terms;
+}
+
+RandomVariable LgmVectorised::fixing(const IborFixingTerms& terms, const RandomVariable& x) const {
+    Size n = x.size();
+    return (RandomVariable(n, terms.disc) * exp(RandomVariable(n, -terms.dH) * x - RandomVariable(n, terms.dHH)) -
+            RandomVariable(n, 1.0)) /
+           RandomVariable(n, terms.dt);
+}
+
 RandomVariable LgmVectorised::compoundedOnRate(const boost::shared_ptr<OvernightIndex>& index,
                                                const std::vector<Date>& fixingDates,
                                                const std::vector<Date>& valueDates, const std::vector<Real>& dt,
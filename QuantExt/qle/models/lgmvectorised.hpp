@@ -58,6 +58,20 @@ public:
     RandomVariable fixing(const boost::shared_ptr<InterestRateIndex>& index, const Date& fixingDate, const Time t,
                           const RandomVariable& x) const;
 
+    /* Deterministic terms of a stochastic ibor fixing observed at t, the fixing is given by
+       (disc * exp(-dH * x - dHH) - 1) / dt. Precomputing the terms once allows to evaluate the same fixing
+       repeatedly on different paths with a single exp() and without date and curve calculations. */
+    struct IborFixingTerms {
+        Real disc = 1.0, dH = 0.0, dHH = 0.0, dt = 1.0;
+    };
+
+    /* Requires fixingDate > today and observation time t <= fixingDate */
+    IborFixingTerms iborFixingTerms(const boost::shared_ptr<IborIndex>& index, const Date& fixingDate,
+                                    const Time t) const;
+
+    /* Evaluate an ibor fixing from precomputed terms */
+    RandomVariable fixing(const IborFixingTerms& terms, const RandomVariable& x) const;
+
     /* Exact if no cap/floors are present and t <= first value date.
        Approximations are applied for t > first value date or when cap / floors are present. */
     RandomVariable compoundedOnRate(const boost::shared_ptr<OvernightIndex>& index,
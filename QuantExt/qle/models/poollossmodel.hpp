@@ -24,8 +24,11 @@
 #include <qle/models/extendedconstantlosslatentmodel.hpp>
 #include <qle/models/defaultlossmodel.hpp>
 #include <qle/models/hullwhitebucketing.hpp>
+#include <exception>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <thread>
 
 // clang-format off
 namespace QuantExt {
@@ -46,10 +49,19 @@ public:
         QuantLib::Real min = -5.0,
         QuantLib::Size nSteps = 50,
         bool useQuadrature = false,
-        bool useStochasticRecovery = false);
+        bool useStochasticRecovery = false,
+        QuantLib::Size nThreads = 1);
 
     QuantLib::Real expectedTrancheLoss(const QuantLib::Date& d, Real recoveryRate = Null<Real>()) const override;
 
+    /*! The loss distributions for all dates are computed in one pass over the common factor, the factor points
+        are processed on nThreads threads. The distributions are cached per date set and recovery rate as long as
+        the basket state (remaining notionals, marginal default probabilities, recoveries, recovery probabilities
+        and grids, factor weights) does not change. The cache holds at most 16 entries and is cleared on a model
+        reset. */
+    std::vector<QuantLib::Real> expectedTrancheLosses(const std::vector<QuantLib::Date>& dates,
+                                                      Real recoveryRate = Null<Real>()) const override;
+
     QuantLib::Real percentile(const QuantLib::Date& d, QuantLib::Real percentile) const override;
 
     QuantLib::Real expectedShortfall(const QuantLib::Date& d, QuantLib::Probability percentile) const override;
@@ -67,6 +79,7 @@ private:
     QuantLib::Size nSteps_;
     bool useQuadrature_;
     bool useStochasticRecovery_;
+    QuantLib::Size nThreads_;
 
     QuantLib::Real delta_;
     mutable QuantLib::Real attach_;
@@ -84,19 +97,35 @@ private:
     mutable std::vector<std::vector<QuantLib::Real>> c_;
     // LGD by entity and (stochastic) recovery rate dimension 
     mutable std::vector<std::vector<QuantLib::Real>> lgdVV_;
-    // conditional probability of default with recovery rate, same dimension as lgdVV_
-    mutable std::vector<std::vector<QuantLib::Real>> cprVV_;
-    
+
+    // cached loss distributions by date set and recovery rate, together with the basket state they were built for
+    struct CachedLossDistribs {
+        std::vector<QuantLib::Real> state;
+        std::vector<QuantLib::Distribution> dists;
+    };
+    mutable std::map<std::pair<std::vector<QuantLib::Date>, QuantLib::Real>, CachedLossDistribs> cache_;
+    static constexpr QuantLib::Size maxCacheSize_ = 16;
+
     QuantLib::Distribution lossDistrib(const QuantLib::Date& d, Real recoveryRate = Null<Real>()) const;
+    std::vector<QuantLib::Distribution> lossDistribs(const std::vector<QuantLib::Date>& dates,
+                                                     Real recoveryRate = Null<Real>()) const;
+    // the inputs the loss distributions depend on, used to validate the cache
+    std::vector<QuantLib::Real> basketState(const std::vector<QuantLib::Date>& dates) const;
     // update lgdVV_
     void updateLGDs(Real recoveryRate = Null<Real>()) const;
     // update q_and c_
     void updateThresholds(QuantLib::Date d, Real recoveryRate = Null<Real>()) const;
-    // update cprVV_
-    std::vector<Real> updateCPRs(std::vector<QuantLib::Real> factor, Real recoveryRate = Null<Real>()) const;
+    /* conditional probability of default with recovery rate cprVV (same dimension as lgdVV_) for thresholds c,
+       returns the conditional default probabilities by entity */
+    std::vector<Real> updateCPRs(const std::vector<std::vector<QuantLib::Real>>& c,
+                                 const std::vector<QuantLib::Real>& factor, Real recoveryRate,
+                                 std::vector<std::vector<QuantLib::Real>>& cprVV) const;
 
     void resetModel() override;
 
+    // expected tranche loss from a loss distribution
+    QuantLib::Real expectedTrancheLoss(QuantLib::Distribution dist) const;
+
     // for checking consistency between Distribution and Arrays
     QuantLib::Real expectedTrancheLoss1(const QuantLib::Date& d, Distribution& dist) const;
     QuantLib::Real expectedTrancheLoss2(const QuantLib::Date& d, const Array& p, const Array& A) const;
@@ -144,7 +173,8 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
     QuantLib::Real min,
     QuantLib::Size nSteps,
     bool useQuadrature,
-    bool useStochasticRecovery)
+    bool useStochasticRecovery,
+    QuantLib::Size nThreads)
     : homogeneous_(homogeneous),
       copula_(copula),
       nBuckets_(nBuckets),
@@ -153,6 +183,7 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
       nSteps_(nSteps),
       useQuadrature_(useQuadrature),
       useStochasticRecovery_(useStochasticRecovery),
+      nThreads_(std::max<QuantLib::Size>(nThreads, 1)),
       delta_((max - min) / nSteps),
       attach_(0.0),
       detach_(0.0),
@@ -165,8 +196,20 @@ PoolLossModel<CopulaPolicy>::PoolLossModel(
 
 template <class CopulaPolicy>
 QuantLib::Real PoolLossModel<CopulaPolicy>::expectedTrancheLoss(const QuantLib::Date& d, Real recoveryRate) const {
+    return expectedTrancheLoss(lossDistrib(d, recoveryRate));
+}
 
-    QuantLib::Distribution dist = lossDistrib(d, recoveryRate);
+template <class CopulaPolicy>
+std::vector<QuantLib::Real>
+PoolLossModel<CopulaPolicy>::expectedTrancheLosses(const std::vector<QuantLib::Date>& dates, Real recoveryRate) const {
+    std::vector<QuantLib::Real> res;
+    for (auto const& dist : lossDistribs(dates, recoveryRate))
+        res.push_back(expectedTrancheLoss(dist));
+    return res;
+}
+
+template <class CopulaPolicy>
+QuantLib::Real PoolLossModel<CopulaPolicy>::expectedTrancheLoss(QuantLib::Distribution dist) const {
 
     // RL: dist.trancheExpectedValue() using x = dist.average(i)
     // FIXME: some remaining inaccuracy in dist.cumulativeDensity(detachAmount_)
@@ -354,36 +397,39 @@ std::vector<std::vector<Real>> PoolLossModel<CopulaPolicy>::marginalProbabilitie
 }
 
 template <class CopulaPolicy>
-std::vector<Real> PoolLossModel<CopulaPolicy>::updateCPRs(std::vector<QuantLib::Real> factor, Real recoveryRate) const {
-    cprVV_.clear();
+std::vector<Real> PoolLossModel<CopulaPolicy>::updateCPRs(const std::vector<std::vector<QuantLib::Real>>& c,
+                                                          const std::vector<QuantLib::Real>& factor,
+                                                          Real recoveryRate,
+                                                          std::vector<std::vector<QuantLib::Real>>& cprVV) const {
+    cprVV.clear();
 
     Real tiny = 1.0e-10;
     if (useStochasticRecovery_ && recoveryRate == Null<Real>()) {
-        cprVV_.resize(notionals_.size(), std::vector<Real>());
-        for (Size i = 0; i < c_.size(); ++i) {
-            cprVV_[i].resize(c_[i].size() - 1, 0.0);
-            Real pd = copula_->conditionalDefaultProbabilityInvP(c_[i][0], i, factor);
+        cprVV.resize(notionals_.size(), std::vector<Real>());
+        for (Size i = 0; i < c.size(); ++i) {
+            cprVV[i].resize(c[i].size() - 1, 0.0);
+            Real pd = copula_->conditionalDefaultProbabilityInvP(c[i][0], i, factor);
             Real sum = 0.0;
-            for (Size j = 1; j < c_[i].size(); ++j) {
+            for (Size j = 1; j < c[i].size(); ++j) {
                 // probability of recovery j conditional on default of i
-                cprVV_[i][j-1] = copula_->conditionalDefaultProbabilityInvP(c_[i][j-1], i, factor)
-                    - copula_->conditionalDefaultProbabilityInvP(c_[i][j], i, factor);
-                sum += cprVV_[i][j-1];
+                cprVV[i][j-1] = copula_->conditionalDefaultProbabilityInvP(c[i][j-1], i, factor)
+                    - copula_->conditionalDefaultProbabilityInvP(c[i][j], i, factor);
+                sum += cprVV[i][j-1];
             }
             QL_REQUIRE(fabs(sum - pd) < tiny, "probability check failed for factor0 " << factor[0]);
         }
     }
     else {
-        cprVV_.resize(notionals_.size(), std::vector<Real>(1, 0));
-        for (Size i = 0; i < c_.size(); ++i) {
-            cprVV_[i][0] = copula_->conditionalDefaultProbabilityInvP(c_[i][0], i, factor);
+        cprVV.resize(notionals_.size(), std::vector<Real>(1, 0));
+        for (Size i = 0; i < c.size(); ++i) {
+            cprVV[i][0] = copula_->conditionalDefaultProbabilityInvP(c[i][0], i, factor);
         }
     }
     
     // Vector of default probabilities conditional on the common market factor M: P(\tau_i < t | M = m).
     std::vector<Real> probs;
-    for (Size i = 0; i < c_.size(); i++)
-        probs.push_back(copula_->conditionalDefaultProbabilityInvP(c_[i][0], i, factor));
+    for (Size i = 0; i < c.size(); i++)
+        probs.push_back(copula_->conditionalDefaultProbabilityInvP(c[i][0], i, factor));
 
     return probs;
 }
@@ -398,10 +444,46 @@ void PoolLossModel<CopulaPolicy>::resetModel() {
     attachAmount_ = basket_->remainingAttachmentAmount();
     detachAmount_ = basket_->remainingDetachmentAmount();
     copula_->resetBasket(basket_.currentLink());
+    cache_.clear();
+}
+
+template <class CopulaPolicy>
+std::vector<QuantLib::Real> PoolLossModel<CopulaPolicy>::basketState(const std::vector<QuantLib::Date>& dates) const {
+    std::vector<QuantLib::Real> state(notionals_);
+    state.push_back(attachAmount_);
+    state.push_back(detachAmount_);
+    for (auto const& d : dates) {
+        std::vector<QuantLib::Real> prob = basket_->remainingProbabilities(d);
+        state.insert(state.end(), prob.begin(), prob.end());
+    }
+    for (auto const& w : copula_->factorWeights())
+        state.insert(state.end(), w.begin(), w.end());
+    state.insert(state.end(), copula_->recoveries().begin(), copula_->recoveries().end());
+    // the stochastic recovery thresholds and lgds depend on the recovery probabilities and grids
+    if (useStochasticRecovery_) {
+        for (auto const& r : copula_->recoveryProbabilities())
+            state.insert(state.end(), r.begin(), r.end());
+        for (auto const& r : copula_->recoveryRateGrids())
+            state.insert(state.end(), r.begin(), r.end());
+    }
+    return state;
 }
     
 template <class CopulaPolicy>
 QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::Date& d, Real recoveryRate) const {
+    return lossDistribs(std::vector<QuantLib::Date>(1, d), recoveryRate).front();
+}
+
+template <class CopulaPolicy>
+std::vector<QuantLib::Distribution> PoolLossModel<CopulaPolicy>::lossDistribs(const std::vector<QuantLib::Date>& dates,
+                                                                              Real recoveryRate) const {
+
+    // Return cached distributions if the basket state did not change
+    auto key = std::make_pair(dates, recoveryRate);
+    std::vector<QuantLib::Real> state = basketState(dates);
+    auto cached = cache_.find(key);
+    if (cached != cache_.end() && cached->second.state == state)
+        return cached->second.dists;
 
     bool check = false;
     
@@ -411,22 +493,10 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
     // Update the LGD vector, could be moved to resetModel() if we can disregard the zeroRecovery flag
     updateLGDs(recoveryRate);
 
-    // Update probabilities qij and thresholds cij, needs to stay here because date dependent
-    updateThresholds(d, recoveryRate);
-
-    // Init bucketing class
-    HullWhiteBucketing hwb(minimum, maximum, nBuckets_);
-
-    // Container for the final (unconditional) loss distribution up to date d.
-    Array p(hwb.buckets()-1, 0.0), A(hwb.buckets()-1, 0.0);
-    QuantLib::Distribution dist(nBuckets_, minimum, maximum);
-    
-    // Use the relevant loss bucketing algorithm
-    boost::shared_ptr<QuantLib::LossDist> bucketing;
-    if (homogeneous_)
-        bucketing = boost::make_shared<QuantLib::LossDistHomogeneous>(nBuckets_, maximum);
-    else
-        bucketing = boost::make_shared<QuantLib::LossDistBucketing>(nBuckets_, maximum);
+    // Containers for the final (unconditional) loss distributions up to each date.
+    std::vector<QuantLib::Distribution> dists(dates.size(), QuantLib::Distribution(nBuckets_, minimum, maximum));
+    Size hwBuckets = HullWhiteBucketing(minimum, maximum, nBuckets_).buckets();
+    std::vector<Array> p(dates.size(), Array(hwBuckets - 1, 0.0)), A(dates.size(), Array(hwBuckets - 1, 0.0));
 
     // Is the ql bucketing used?
     bool useQlBucketing = false;
@@ -436,90 +506,172 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
 
         // FIXME: Ensure quadrature works with stochastic recovery
 
-        QuantLib::GaussHermiteIntegration Integrator(nSteps_);
-        // Marginal probabilities for each remaining entity in basket, P(\tau_i < t).
-        std::vector<QuantLib::Real> prob = basket_->remainingProbabilities(d);
-        LossModelConditionalDist<CopulaPolicy> lmcd(copula_, bucketing, prob, lgd_);
-
-        for (QuantLib::Size j = 0; j < nBuckets_; j++) {
-            std::function<QuantLib::Real(QuantLib::Real)> densityFunc = std::bind(
-                &LossModelConditionalDist<CopulaPolicy>::conditionalDensity, &lmcd, std::placeholders::_1, j);
-            std::function<QuantLib::Real(QuantLib::Real)> averageFunc = std::bind(
-                &LossModelConditionalDist<CopulaPolicy>::conditionalAverage, &lmcd, std::placeholders::_1, j);
-            dist.addDensity(j, Integrator(densityFunc));
-            dist.addAverage(j, Integrator(averageFunc));
+        for (Size i = 0; i < dates.size(); ++i) {
+            // Use the relevant loss bucketing algorithm
+            boost::shared_ptr<QuantLib::LossDist> bucketing;
+            if (homogeneous_)
+                bucketing = boost::make_shared<QuantLib::LossDistHomogeneous>(nBuckets_, maximum);
+            else
+                bucketing = boost::make_shared<QuantLib::LossDistBucketing>(nBuckets_, maximum);
+
+            QuantLib::GaussHermiteIntegration Integrator(nSteps_);
+            // Marginal probabilities for each remaining entity in basket, P(\tau_i < t).
+            std::vector<QuantLib::Real> prob = basket_->remainingProbabilities(dates[i]);
+            LossModelConditionalDist<CopulaPolicy> lmcd(copula_, bucketing, prob, lgd_);
+
+            for (QuantLib::Size j = 0; j < nBuckets_; j++) {
+                std::function<QuantLib::Real(QuantLib::Real)> densityFunc = std::bind(
+                    &LossModelConditionalDist<CopulaPolicy>::conditionalDensity, &lmcd, std::placeholders::_1, j);
+                std::function<QuantLib::Real(QuantLib::Real)> averageFunc = std::bind(
+                    &LossModelConditionalDist<CopulaPolicy>::conditionalAverage, &lmcd, std::placeholders::_1, j);
+                dists[i].addDensity(j, Integrator(densityFunc));
+                dists[i].addAverage(j, Integrator(averageFunc));
+            }
         }
 
         useQlBucketing = true;
 
     } else {
 
-        std::vector<QuantLib::Real> factor{ min_ + delta_ / 2.0 };      
+        // Update probabilities qij and thresholds cij for all dates, this requires the basket and is therefore
+        // done before the factor points are processed in parallel.
+        std::vector<std::vector<std::vector<QuantLib::Real>>> c(dates.size());
+        for (Size i = 0; i < dates.size(); ++i) {
+            updateThresholds(dates[i], recoveryRate);
+            c[i] = c_;
+        }
 
+        // Values of the common factor in [min,max] region.
+        std::vector<QuantLib::Real> factors(nSteps_);
+        QuantLib::Real f = min_ + delta_ / 2.0;
         for (QuantLib::Size k = 0; k < nSteps_; k++) {
-            
-            std::vector<Real> cpr = updateCPRs(factor, recoveryRate);
-
-            // Loss distribution up to date d conditional on common factor M = m.
-            Distribution conditionalDist;
-            if (useStochasticRecovery_) {
-                // HW bucketing with multi-state extension for stochastic recovery
-                // With stochastic recovery the portfolios is in general not homogeneous any more, so that
-                // bucketing is the only choice. We could use this call in all cases (including deterministic
-                // recovery, homogeneous pool), but this can cause small regression errors (using bucketing
-                // instead of homogeneoius pool algorithm) and calculation time increase (QuantLib::LossDist's
-                // bucketing is faster).
-                hwb.computeMultiState(cprVV_.begin(), cprVV_.end(), lgdVV_.begin());                
+            factors[k] = f;
+            f += delta_;
+        }
+
+        // If possible we use the homogeneous algorithm in QuantLib::LossDist, see below.
+        useQlBucketing = !useStochasticRecovery_ && homogeneous_;
+
+        // Loss distributions by factor point and date conditional on common factor M = m, and factor densities.
+        // They are summed up below in the order of the factor points, so that the result does not depend on the
+        // number of threads.
+        Size condBuckets = useQlBucketing ? nBuckets_ : hwBuckets - 1;
+        std::vector<std::vector<Array>> condP(nSteps_, std::vector<Array>(dates.size(), Array(condBuckets))),
+            condA(nSteps_, std::vector<Array>(dates.size(), Array(condBuckets)));
+        std::vector<QuantLib::Real> densitydm(nSteps_);
+
+        Size nThreads = std::min(nThreads_, nSteps_);
+
+        auto runFactorPoints = [&](const Size t) {
+            // bucketing algorithms are not thread safe, so we use one instance per thread
+            HullWhiteBucketing hwb(minimum, maximum, nBuckets_);
+            boost::shared_ptr<QuantLib::LossDist> bucketing;
+            if (homogeneous_)
+                bucketing = boost::make_shared<QuantLib::LossDistHomogeneous>(nBuckets_, maximum);
+            else
+                bucketing = boost::make_shared<QuantLib::LossDistBucketing>(nBuckets_, maximum);
+            std::vector<std::vector<QuantLib::Real>> cprVV;
+
+            for (QuantLib::Size k = t; k < nSteps_; k += nThreads) {
+
+                std::vector<QuantLib::Real> factor{factors[k]};
+                densitydm[k] = delta_ * copula_->density(factor);
+
+                for (Size i = 0; i < dates.size(); ++i) {
+
+                    std::vector<Real> cpr = updateCPRs(c[i], factor, recoveryRate, cprVV);
+
+                    if (useStochasticRecovery_) {
+                        // HW bucketing with multi-state extension for stochastic recovery
+                        // With stochastic recovery the portfolios is in general not homogeneous any more, so that
+                        // bucketing is the only choice. We could use this call in all cases (including deterministic
+                        // recovery, homogeneous pool), but this can cause small regression errors (using bucketing
+                        // instead of homogeneoius pool algorithm) and calculation time increase (QuantLib::LossDist's
+                        // bucketing is faster).
+                        hwb.computeMultiState(cprVV.begin(), cprVV.end(), lgdVV_.begin());
+                    } else if (homogeneous_) {
+                        // Original QuantLib::LossDist (homogeneous), works with deterministic recovery only.
+                        // If possible we use the homogeneous algorithm in QuantLib::LossDist. This also avoids small
+                        // regression errors from switching to any of the bucketing algorithms in the homogeneous
+                        // case.
+                        Distribution conditionalDist = (*bucketing)(lgd_, cpr);
+                        for (Size j = 0; j < nBuckets_; j++) {
+                            condP[k][i][j] = conditionalDist.density(j);
+                            condA[k][i][j] = conditionalDist.average(j);
+                        }
+                        continue;
+                    } else {
+                        // We could use hwb.computeMultiState here as well, yields the same result,
+                        // but compute is slightly faster than computeMultiState.
+                        hwb.compute(cpr.begin(), cpr.end(), lgd_.begin());
+                    }
+
+                    // Bucket 0 contains losses up to lowerBound, and bucket 1 from [lowerBound, lowerBound + dx),
+                    // together both buckets contains (-inf, lowerBound + dx)
+                    // Since we dont have any negative losses in a CDO its [0, dx)
+                    double p0 = (hwb.probability()[0] + hwb.probability()[1]);
+                    double A0 = 0;
+                    if (!QuantLib::close_enough(p0, 0.0)) {
+                        A0 = (hwb.averageLoss()[0] * hwb.probability()[0] +
+                              hwb.averageLoss()[1] * hwb.probability()[1]) /
+                             p0;
+                    }
+                    condP[k][i][0] = p0;
+                    condA[k][i][0] = A0;
+                    for (Size j = 2; j < hwb.buckets(); j++) {
+                        condP[k][i][j - 1] = hwb.probability()[j];
+                        condA[k][i][j - 1] = hwb.averageLoss()[j];
+                    }
+                }
             }
-            else if (homogeneous_) {
-                // Original QuantLib::LossDist (homogeneous), works with deterministic recovery only.
-                // If possible we use the homogeneous algorithm in QuantLib::LossDist. This also avoids small
-                // regression errors from switching to any of the bucketing algorithms in the homogeneous case. 
-                conditionalDist = (*bucketing)(lgd_, cpr);
-                useQlBucketing = true;
+        };
+
+        if (nThreads == 1) {
+            runFactorPoints(0);
+        } else {
+            std::vector<std::exception_ptr> errors(nThreads);
+            std::vector<std::thread> jobs;
+            for (Size t = 0; t < nThreads; ++t) {
+                jobs.emplace_back([&runFactorPoints, &errors, t]() {
+                    try {
+                        runFactorPoints(t);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
             }
-            else {
-                // We could use hwb.computeMultiState here as well, yields the same result,
-                // but compute is slightly faster than computeMultiState.
-                hwb.compute(cpr.begin(), cpr.end(), lgd_.begin());                
+            for (auto& j : jobs)
+                j.join();
+            for (auto const& e : errors) {
+                if (e)
+                    std::rethrow_exception(e);
             }
+        }
 
-            // Update final distribution with contribution from common factor M = m.
-            Real densitydm = delta_ * copula_->density(factor);
-
-            if (useQlBucketing) {
-                for (Size j = 0; j < nBuckets_; j++) {
-                    dist.addDensity(j, conditionalDist.density(j) * densitydm);
-                    dist.addAverage(j, conditionalDist.average(j) * densitydm);
-                }
-            }
-            else {
-                // Bucket 0 contains losses up to lowerBound, and bucket 1 from [lowerBound, lowerBound + dx),
-                // together both buckets contains (-inf, lowerBound + dx)
-                // Since we dont have any negative losses in a CDO its [0, dx)
-                double p0 = (hwb.probability()[0] + hwb.probability()[1]);
-                double A0 = 0;
-                if (!QuantLib::close_enough(p0, 0.0)) {
-                    A0 = (hwb.averageLoss()[0] * hwb.probability()[0] + hwb.averageLoss()[1] * hwb.probability()[1]) / p0; 
-                }
-                p[0] += p0 * densitydm;
-                A[0] += A0 * densitydm;
-                 
-                for (Size j = 2; j < hwb.buckets(); j++) {
-                    p[j-1] += hwb.probability()[j] * densitydm;
-                    A[j-1] += hwb.averageLoss()[j] * densitydm;
+        // Update final distributions with contribution from common factor M = m.
+        for (QuantLib::Size k = 0; k < nSteps_; k++) {
+            for (Size i = 0; i < dates.size(); ++i) {
+                if (useQlBucketing) {
+                    for (Size j = 0; j < nBuckets_; j++) {
+                        dists[i].addDensity(j, condP[k][i][j] * densitydm[k]);
+                        dists[i].addAverage(j, condA[k][i][j] * densitydm[k]);
+                    }
+                } else {
+                    for (Size j = 0; j < condBuckets; j++) {
+                        p[i][j] += condP[k][i][j] * densitydm[k];
+                        A[i][j] += condA[k][i][j] * densitydm[k];
+                    }
                 }
             }
-            
-            // Move to next value of common factor in [min,max] region.
-            factor[0] += delta_;
         }
 
         if (!useQlBucketing) {
             // Copy results to distribution, skip the right-most bucket (maximum, infty)
-            for (Size j = 0; j < nBuckets_; j++) {
-                dist.addDensity(j, p[j] / dist.dx(j));
-                dist.addAverage(j, A[j]);
+            for (Size i = 0; i < dates.size(); ++i) {
+                for (Size j = 0; j < nBuckets_; j++) {
+                    dists[i].addDensity(j, p[i][j] / dists[i].dx(j));
+                    dists[i].addAverage(j, A[i][j]);
+                }
             }
         }
     }
@@ -528,13 +680,20 @@ QuantLib::Distribution PoolLossModel<CopulaPolicy>::lossDistrib(const QuantLib::
         // This checks the consistency between the Distribution object and the "raw" p and A vectors
         // by way of expectedTrancheLoss calculations.
         // Can be deactivated because of its performance impact.
-        Real etl1 = expectedTrancheLoss1(d, dist);
-        Real etl2 = expectedTrancheLoss2(d, p, A);
-        Real tiny = 1e-3;
-        QL_REQUIRE(fabs((etl1 - etl2)/etl2) < tiny, "expected tranche loss failed, " << etl1 << " vs " << etl2);
+        for (Size i = 0; i < dates.size(); ++i) {
+            Real etl1 = expectedTrancheLoss1(dates[i], dists[i]);
+            Real etl2 = expectedTrancheLoss2(dates[i], p[i], A[i]);
+            Real tiny = 1e-3;
+            QL_REQUIRE(fabs((etl1 - etl2)/etl2) < tiny, "expected tranche loss failed, " << etl1 << " vs " << etl2);
+        }
     }
 
-    return dist;
+    // bound the cache, percentile and expected shortfall calls add one entry per date
+    if (cache_.size() >= maxCacheSize_)
+        cache_.clear();
+    cache_[key] = CachedLossDistribs{state, dists};
+
+    return dists;
 }
 
 template <class CopulaPolicy>
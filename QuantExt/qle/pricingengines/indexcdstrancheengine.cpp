@@ -87,6 +87,18 @@ void IndexCdsTrancheEngine::calculate() const {
     results_.protectionValue = 0.0;
     Real inceptionTrancheNotional = arguments_.basket->trancheNotional();
 
+    // Expected losses on the tranche up to the end of each future coupon period, computed in one pass.
+    vector<Date> etlDates;
+    for (const auto& cf : arguments_.normalizedLeg) {
+        if (cf->hasOccurred(today))
+            continue;
+        boost::shared_ptr<Coupon> coupon = boost::dynamic_pointer_cast<Coupon>(cf);
+        QL_REQUIRE(coupon, "IndexCdsTrancheEngine expects leg to have Coupon cashflow type.");
+        etlDates.push_back(coupon->accrualEndDate());
+    }
+    vector<Real> futureEtls = basket->expectedTrancheLosses(etlDates, arguments_.recoveryRate);
+    Size etlIndex = 0;
+
     // Value the premium and protection leg.
     for (Size i = 0; i < arguments_.normalizedLeg.size(); i++) {
 
@@ -107,7 +119,9 @@ void IndexCdsTrancheEngine::calculate() const {
         Date defaultDate = startDate + (endDate - startDate) / 2;
 
         // Expected loss on the tranche up to the end of the current period.
-        Real etl = basket->expectedTrancheLoss(endDate, arguments_.recoveryRate);
+        QL_REQUIRE(etlIndex < futureEtls.size() && etlDates[etlIndex] == endDate,
+                   "IndexCdsTrancheEngine: internal error, expected tranche loss for " << endDate << " not found.");
+        Real etl = futureEtls[etlIndex++];
 
         // Update protection leg value
         results_.protectionValue += discountCurve_->discount(defaultDate) * (etl - etls.back());
@@ -25,6 +25,7 @@
 #include <qle/cashflows/overnightindexedcoupon.hpp>
 #include <qle/cashflows/subperiodscoupon.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
+#include <qle/math/randomvariableregressioncache.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
 #include <qle/processes/irlgm1fstateprocess.hpp>
 
@@ -40,6 +41,17 @@
 
 namespace QuantExt {
 
+namespace {
+// copy the hw factor states referenced in a cashflow info to the input format of HwVectorised
+std::vector<RandomVariable> hwState(const std::vector<const RandomVariable*>& state) {
+    std::vector<RandomVariable> result;
+    result.reserve(state.size());
+    for (auto const s : state)
+        result.push_back(*s);
+    return result;
+}
+} // namespace
+
 McMultiLegBaseEngine::McMultiLegBaseEngine(
     const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
     const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
@@ -64,7 +76,20 @@ McMultiLegBaseEngine::McMultiLegBaseEngine(
 }
 
 Real McMultiLegBaseEngine::time(const Date& d) const {
-    return model_->irlgm1f(0)->termStructure()->timeFromReference(d);
+    return model_->irModel(0)->termStructure()->timeFromReference(d);
+}
+
+bool McMultiLegBaseEngine::isHwModel() const {
+    return model_->modelType(CrossAssetModel::AssetType::IR, 0) == CrossAssetModel::ModelType::HW;
+}
+
+std::vector<Size> McMultiLegBaseEngine::irStateIndices(const Size ccyIdx) const {
+    if (!isHwModel())
+        return {model_->pIdx(CrossAssetModel::AssetType::IR, ccyIdx)};
+    std::vector<Size> result;
+    for (Size k = 0; k < model_->irModel(ccyIdx)->n(); ++k)
+        result.push_back(model_->pIdx(CrossAssetModel::AssetType::IR, ccyIdx, k));
+    return result;
 }
 
 McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boost::shared_ptr<CashFlow> flow,
@@ -238,9 +263,14 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
             ibor->fixingDate() <= today_ ? (ibor->rate() - ibor->spread()) / ibor->gearing() : Null<Real>();
         Size indexCcyIdx = model_->ccyIndex(ibor->index()->currency());
         Real simTime = time(ibor->fixingDate());
+        LgmVectorised::IborFixingTerms fixingTerms;
         if (ibor->fixingDate() > today_) {
             info.simulationTimes.push_back(simTime);
-            info.modelIndices.push_back({model_->pIdx(CrossAssetModel::AssetType::IR, indexCcyIdx)});
+            info.modelIndices.push_back(irStateIndices(indexCcyIdx));
+            // the deterministic part of the fixing is computed once here, not on each evaluation of the amount
+            if (!isHwModel())
+                fixingTerms =
+                    lgmVectorised_[indexCcyIdx].iborFixingTerms(ibor->iborIndex(), ibor->fixingDate(), simTime);
         }
 
         if (fxLinkedSimTime != Null<Real>()) {
@@ -248,13 +278,18 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
             info.modelIndices.push_back(fxLinkedModelIndices);
         } 
 
-        info.amountCalculator = [this, indexCcyIdx, ibor, simTime, fixedRate, isFxLinked, fxLinkedForeignNominal,
-                                 fxLinkedSourceCcyIdx, fxLinkedTargetCcyIdx, fxLinkedFixedFxRate, isCapFloored,
-                                 isNakedOption, effFloor, effCap, isFxIndexed](const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
-            RandomVariable fixing = fixedRate != Null<Real>()
-                                        ? RandomVariable(n, fixedRate)
-                                        : lgmVectorised_[indexCcyIdx].fixing(ibor->index(), ibor->fixingDate(), simTime,
-                                                                             *states.at(0).at(0));
+        info.amountCalculator = [this, indexCcyIdx, ibor, simTime, fixingTerms, fixedRate, isFxLinked,
+                                 fxLinkedForeignNominal, fxLinkedSourceCcyIdx, fxLinkedTargetCcyIdx,
+                                 fxLinkedFixedFxRate, isCapFloored, isNakedOption, effFloor, effCap,
+                                 isFxIndexed](const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
+            RandomVariable fixing;
+            if (fixedRate != Null<Real>())
+                fixing = RandomVariable(n, fixedRate);
+            else if (isHwModel())
+                fixing = hwVectorised_[indexCcyIdx].fixing(ibor->iborIndex(), ibor->fixingDate(), simTime,
+                                                           hwState(states.at(0)));
+            else
+                fixing = lgmVectorised_[indexCcyIdx].fixing(fixingTerms, *states.at(0).at(0));
             RandomVariable fxFixing(n, 1.0);
             if (isFxLinked || isFxIndexed) {
                 if (fxLinkedFixedFxRate != Null<Real>()) {
@@ -296,6 +331,8 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
     }
 
     if (auto cms = boost::dynamic_pointer_cast<CmsCoupon>(flow)) {
+        QL_REQUIRE(!isHwModel(), "McMultiLegBaseEngine::createCashflowInfo(): cms coupon (leg "
+                                     << legNo << ", cashflow " << cfNo << ") is not supported for HW models");
         Real fixedRate = cms->fixingDate() <= today_ ? (cms->rate() - cms->spread()) / cms->gearing() : Null<Real>();
         Size indexCcyIdx = model_->ccyIndex(cms->index()->currency());
         Real simTime = time(cms->fixingDate());
@@ -362,7 +399,7 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         Real simTime = std::max(0.0, time(on->valueDates().front()));
         Size indexCcyIdx = model_->ccyIndex(on->index()->currency());
         info.simulationTimes.push_back(simTime);
-        info.modelIndices.push_back({model_->pIdx(CrossAssetModel::AssetType::IR, indexCcyIdx)});
+        info.modelIndices.push_back(irStateIndices(indexCcyIdx));
 
         if (fxLinkedSimTime != Null<Real>()) {
             info.simulationTimes.push_back(fxLinkedSimTime);
@@ -372,10 +409,16 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         info.amountCalculator = [this, indexCcyIdx, on, simTime, isFxLinked, fxLinkedForeignNominal,
                                  fxLinkedSourceCcyIdx, fxLinkedTargetCcyIdx, fxLinkedFixedFxRate, isFxIndexed](
                                     const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
-            RandomVariable effectiveRate = lgmVectorised_[indexCcyIdx].compoundedOnRate(
-                on->overnightIndex(), on->fixingDates(), on->valueDates(), on->dt(), on->rateCutoff(),
-                on->includeSpread(), on->spread(), on->gearing(), on->lookback(), Null<Real>(), Null<Real>(), false,
-                false, simTime, *states.at(0).at(0));
+            RandomVariable effectiveRate =
+                isHwModel()
+                    ? hwVectorised_[indexCcyIdx].compoundedOnRate(
+                          on->overnightIndex(), on->fixingDates(), on->valueDates(), on->dt(), on->rateCutoff(),
+                          on->includeSpread(), on->spread(), on->gearing(), on->lookback(), Null<Real>(), Null<Real>(),
+                          false, false, simTime, hwState(states.at(0)))
+                    : lgmVectorised_[indexCcyIdx].compoundedOnRate(
+                          on->overnightIndex(), on->fixingDates(), on->valueDates(), on->dt(), on->rateCutoff(),
+                          on->includeSpread(), on->spread(), on->gearing(), on->lookback(), Null<Real>(), Null<Real>(),
+                          false, false, simTime, *states.at(0).at(0));
             RandomVariable fxFixing(n, 1.0);
             if (isFxLinked || isFxIndexed) {
                 if (fxLinkedFixedFxRate != Null<Real>()) {
@@ -402,7 +445,7 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         Real simTime = std::max(0.0, time(cfon->underlying()->valueDates().front()));
         Size indexCcyIdx = model_->ccyIndex(cfon->underlying()->index()->currency());
         info.simulationTimes.push_back(simTime);
-        info.modelIndices.push_back({model_->pIdx(CrossAssetModel::AssetType::IR, indexCcyIdx)});
+        info.modelIndices.push_back(irStateIndices(indexCcyIdx));
 
         if (fxLinkedSimTime != Null<Real>()) {
             info.simulationTimes.push_back(fxLinkedSimTime);
@@ -412,12 +455,22 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         info.amountCalculator = [this, indexCcyIdx, cfon, simTime, isFxLinked, fxLinkedForeignNominal,
                                  fxLinkedSourceCcyIdx, fxLinkedTargetCcyIdx, fxLinkedFixedFxRate, isFxIndexed](
                                     const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
-            RandomVariable effectiveRate = lgmVectorised_[indexCcyIdx].compoundedOnRate(
-                cfon->underlying()->overnightIndex(), cfon->underlying()->fixingDates(),
-                cfon->underlying()->valueDates(), cfon->underlying()->dt(), cfon->underlying()->rateCutoff(),
-                cfon->underlying()->includeSpread(), cfon->underlying()->spread(), cfon->underlying()->gearing(),
-                cfon->underlying()->lookback(), cfon->cap(), cfon->floor(), cfon->localCapFloor(), cfon->nakedOption(),
-                simTime, *states.at(0).at(0));
+            RandomVariable effectiveRate =
+                isHwModel()
+                    ? hwVectorised_[indexCcyIdx].compoundedOnRate(
+                          cfon->underlying()->overnightIndex(), cfon->underlying()->fixingDates(),
+                          cfon->underlying()->valueDates(), cfon->underlying()->dt(),
+                          cfon->underlying()->rateCutoff(), cfon->underlying()->includeSpread(),
+                          cfon->underlying()->spread(), cfon->underlying()->gearing(), cfon->underlying()->lookback(),
+                          cfon->cap(), cfon->floor(), cfon->localCapFloor(), cfon->nakedOption(), simTime,
+                          hwState(states.at(0)))
+                    : lgmVectorised_[indexCcyIdx].compoundedOnRate(
+                          cfon->underlying()->overnightIndex(), cfon->underlying()->fixingDates(),
+                          cfon->underlying()->valueDates(), cfon->underlying()->dt(),
+                          cfon->underlying()->rateCutoff(), cfon->underlying()->includeSpread(),
+                          cfon->underlying()->spread(), cfon->underlying()->gearing(), cfon->underlying()->lookback(),
+                          cfon->cap(), cfon->floor(), cfon->localCapFloor(), cfon->nakedOption(), simTime,
+                          *states.at(0).at(0));
             RandomVariable fxFixing(n, 1.0);
             if (isFxLinked || isFxIndexed) {
                 if (fxLinkedFixedFxRate != Null<Real>()) {
@@ -443,7 +496,7 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         Real simTime = std::max(0.0, time(av->valueDates().front()));
         Size indexCcyIdx = model_->ccyIndex(av->index()->currency());
         info.simulationTimes.push_back(simTime);
-        info.modelIndices.push_back({model_->pIdx(CrossAssetModel::AssetType::IR, indexCcyIdx)});
+        info.modelIndices.push_back(irStateIndices(indexCcyIdx));
 
         if (fxLinkedSimTime != Null<Real>()) {
             info.simulationTimes.push_back(fxLinkedSimTime);
@@ -453,10 +506,18 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         info.amountCalculator = [this, indexCcyIdx, av, simTime, isFxLinked, fxLinkedForeignNominal,
                                  fxLinkedSourceCcyIdx, fxLinkedTargetCcyIdx, fxLinkedFixedFxRate, isFxIndexed](
                                     const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
-            RandomVariable effectiveRate = lgmVectorised_[indexCcyIdx].averagedOnRate(
-                av->overnightIndex(), av->fixingDates(), av->valueDates(), av->dt(), av->rateCutoff(), false,
-                av->spread(), av->gearing(), av->lookback(), Null<Real>(), Null<Real>(), false, false, simTime,
-                *states.at(0).at(0));
+            RandomVariable effectiveRate =
+                isHwModel()
+                    ? hwVectorised_[indexCcyIdx].averagedOnRate(av->overnightIndex(), av->fixingDates(),
+                                                                av->valueDates(), av->dt(), av->rateCutoff(), false,
+                                                                av->spread(), av->gearing(), av->lookback(),
+                                                                Null<Real>(), Null<Real>(), false, false, simTime,
+                                                                hwState(states.at(0)))
+                    : lgmVectorised_[indexCcyIdx].averagedOnRate(av->overnightIndex(), av->fixingDates(),
+                                                                 av->valueDates(), av->dt(), av->rateCutoff(), false,
+                                                                 av->spread(), av->gearing(), av->lookback(),
+                                                                 Null<Real>(), Null<Real>(), false, false, simTime,
+                                                                 *states.at(0).at(0));
             RandomVariable fxFixing(n, 1.0);
             if (isFxLinked || isFxIndexed) {
                 if (fxLinkedFixedFxRate != Null<Real>()) {
@@ -482,7 +543,7 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         Real simTime = std::max(0.0, time(cfav->underlying()->valueDates().front()));
         Size indexCcyIdx = model_->ccyIndex(cfav->underlying()->index()->currency());
         info.simulationTimes.push_back(simTime);
-        info.modelIndices.push_back({model_->pIdx(CrossAssetModel::AssetType::IR, indexCcyIdx)});
+        info.modelIndices.push_back(irStateIndices(indexCcyIdx));
 
         if (fxLinkedSimTime != Null<Real>()) {
             info.simulationTimes.push_back(fxLinkedSimTime);
@@ -492,12 +553,20 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         info.amountCalculator = [this, indexCcyIdx, cfav, simTime, isFxLinked, fxLinkedForeignNominal,
                                  fxLinkedSourceCcyIdx, fxLinkedTargetCcyIdx, fxLinkedFixedFxRate, isFxIndexed](
                                     const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
-            RandomVariable effectiveRate = lgmVectorised_[indexCcyIdx].averagedOnRate(
-                cfav->underlying()->overnightIndex(), cfav->underlying()->fixingDates(),
-                cfav->underlying()->valueDates(), cfav->underlying()->dt(), cfav->underlying()->rateCutoff(),
-                cfav->includeSpread(), cfav->underlying()->spread(), cfav->underlying()->gearing(),
-                cfav->underlying()->lookback(), cfav->cap(), cfav->floor(), cfav->localCapFloor(), cfav->nakedOption(),
-                simTime, *states.at(0).at(0));
+            RandomVariable effectiveRate =
+                isHwModel()
+                    ? hwVectorised_[indexCcyIdx].averagedOnRate(
+                          cfav->underlying()->overnightIndex(), cfav->underlying()->fixingDates(),
+                          cfav->underlying()->valueDates(), cfav->underlying()->dt(),
+                          cfav->underlying()->rateCutoff(), cfav->includeSpread(), cfav->underlying()->spread(),
+                          cfav->underlying()->gearing(), cfav->underlying()->lookback(), cfav->cap(), cfav->floor(),
+                          cfav->localCapFloor(), cfav->nakedOption(), simTime, hwState(states.at(0)))
+                    : lgmVectorised_[indexCcyIdx].averagedOnRate(
+                          cfav->underlying()->overnightIndex(), cfav->underlying()->fixingDates(),
+                          cfav->underlying()->valueDates(), cfav->underlying()->dt(),
+                          cfav->underlying()->rateCutoff(), cfav->includeSpread(), cfav->underlying()->spread(),
+                          cfav->underlying()->gearing(), cfav->underlying()->lookback(), cfav->cap(), cfav->floor(),
+                          cfav->localCapFloor(), cfav->nakedOption(), simTime, *states.at(0).at(0));
             RandomVariable fxFixing(n, 1.0);
             if (isFxLinked || isFxIndexed) {
                 if (fxLinkedFixedFxRate != Null<Real>()) {
@@ -520,6 +589,8 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
     }
 
     if (auto bma = boost::dynamic_pointer_cast<AverageBMACoupon>(flow)) {
+        QL_REQUIRE(!isHwModel(), "McMultiLegBaseEngine::createCashflowInfo(): bma coupon (leg "
+                                     << legNo << ", cashflow " << cfNo << ") is not supported for HW models");
         Real simTime = std::max(0.0, time(bma->fixingDates().front()));
         Size indexCcyIdx = model_->ccyIndex(bma->index()->currency());
         info.simulationTimes.push_back(simTime);
@@ -558,6 +629,8 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
     }
 
     if (auto cfbma = boost::dynamic_pointer_cast<CappedFlooredAverageBMACoupon>(flow)) {
+        QL_REQUIRE(!isHwModel(), "McMultiLegBaseEngine::createCashflowInfo(): bma coupon (leg "
+                                     << legNo << ", cashflow " << cfNo << ") is not supported for HW models");
         Real simTime = std::max(0.0, time(cfbma->underlying()->fixingDates().front()));
         Size indexCcyIdx = model_->ccyIndex(cfbma->underlying()->index()->currency());
         info.simulationTimes.push_back(simTime);
@@ -598,6 +671,8 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
     }
 
     if (auto sub = boost::dynamic_pointer_cast<SubPeriodsCoupon1>(flow)) {
+        QL_REQUIRE(!isHwModel(), "McMultiLegBaseEngine::createCashflowInfo(): sub periods coupon (leg "
+                                     << legNo << ", cashflow " << cfNo << ") is not supported for HW models");
         Real simTime = std::max(0.0, time(sub->fixingDates().front()));
         Size indexCcyIdx = model_->ccyIndex(sub->index()->currency());
         info.simulationTimes.push_back(simTime);
@@ -648,15 +723,14 @@ Size McMultiLegBaseEngine::timeIndex(const Time t, const std::set<Real>& times)
 
 RandomVariable McMultiLegBaseEngine::cashflowPathValue(const CashflowInfo& cf,
                                                        const std::vector<std::vector<RandomVariable>>& pathValues,
-                                                       const std::set<Real>& simulationTimes) const {
+                                                       const std::set<Real>& simulationTimes,
+                                                       const std::vector<RandomVariable>& initialValues,
+                                                       std::map<std::pair<Size, Size>, RandomVariable>& deflators)
+    const {
 
     Size n = pathValues[0][0].size();
     auto simTimesPayIdx = timeIndex(cf.payTime, simulationTimes);
 
-    std::vector<RandomVariable> initialValues(model_->stateProcess()->initialValues().size());
-    for (Size i = 0; i < model_->stateProcess()->initialValues().size(); ++i)
-        initialValues[i] = RandomVariable(n, model_->stateProcess()->initialValues()[i]);
-
     std::vector<std::vector<const RandomVariable*>> states(cf.simulationTimes.size());
     for (Size i = 0; i < cf.simulationTimes.size(); ++i) {
         std::vector<const RandomVariable*> tmp(cf.modelIndices[i].size());
@@ -673,16 +747,32 @@ RandomVariable McMultiLegBaseEngine::cashflowPathValue(const CashflowInfo& cf,
         states[i] = tmp;
     }
 
-    auto amount = cf.amountCalculator(n, states) /
+    // the deflator (fx conversion to base ccy / numeraire) is shared by all cashflows with the same pay time and ccy
+
+    auto deflator = deflators.find(std::make_pair(simTimesPayIdx, cf.payCcyIndex));
+    if (deflator == deflators.end()) {
+        RandomVariable tmp;
+        if (isHwModel()) {
+            // the hw numeraire is a function of the aux states, which follow the n factor states
+            Size nFactors = model_->irModel(0)->n();
+            std::vector<RandomVariable> aux;
+            for (Size k = 0; k < model_->irModel(0)->n_aux(); ++k)
+                aux.push_back(
+                    pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::IR, 0, nFactors + k)]);
+            tmp = RandomVariable(n, 1.0) / hwVectorised_[0].numeraire(cf.payTime, aux, discountCurves_[0]);
+        } else {
+            tmp = RandomVariable(n, 1.0) /
                   lgmVectorised_[0].numeraire(
                       cf.payTime, pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::IR, 0)],
                       discountCurves_[0]);
-
-    if (cf.payCcyIndex > 0) {
-        amount *= exp(pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::FX, cf.payCcyIndex - 1)]);
+        }
+        if (cf.payCcyIndex > 0) {
+            tmp *= exp(pathValues[simTimesPayIdx][model_->pIdx(CrossAssetModel::AssetType::FX, cf.payCcyIndex - 1)]);
+        }
+        deflator = deflators.insert(std::make_pair(std::make_pair(simTimesPayIdx, cf.payCcyIndex), tmp)).first;
     }
 
-    return amount * RandomVariable(n, cf.payer);
+    return cf.amountCalculator(n, states) * deflator->second * RandomVariable(n, cf.payer);
 }
 
 void McMultiLegBaseEngine::calculate() const {
@@ -700,11 +790,20 @@ void McMultiLegBaseEngine::calculate() const {
 
     // set today's date
 
-    today_ = model_->irlgm1f(0)->termStructure()->referenceDate();
+    today_ = model_->irModel(0)->termStructure()->referenceDate();
 
-    // set up lgm vectorized instances for each currency
+    // set up lgm or hw vectorized instances for each currency
 
-    if (lgmVectorised_.empty()) {
+    if (isHwModel()) {
+        QL_REQUIRE(model_->irModel(0)->n_aux() > 0,
+                   "McMultiLegBaseEngine::calculate(): HW model requires the BA measure, the numeraire is computed "
+                   "from the aux states.");
+        if (hwVectorised_.empty()) {
+            for (Size i = 0; i < model_->components(CrossAssetModel::AssetType::IR); ++i) {
+                hwVectorised_.push_back(HwVectorised(model_->irhw(i)));
+            }
+        }
+    } else if (lgmVectorised_.empty()) {
         for (Size i = 0; i < model_->components(CrossAssetModel::AssetType::IR); ++i) {
             lgmVectorised_.push_back(LgmVectorised(model_->irlgm1f(i)));
         }
@@ -795,7 +894,7 @@ void McMultiLegBaseEngine::calculate() const {
     TimeGrid timeGrid(simulationTimes.begin(), simulationTimes.end());
 
     boost::shared_ptr<StochasticProcess> process = model_->stateProcess();
-    if (model_->dimension() == 1) {
+    if (model_->dimension() == 1 && !isHwModel()) {
         // use lgm process if possible for better performance
         auto tmp = boost::make_shared<IrLgm1fStateProcess>(model_->irlgm1f(0));
         tmp->resetCache(timeGrid.size() - 1);
@@ -837,6 +936,14 @@ void McMultiLegBaseEngine::calculate() const {
 
     std::vector<RandomVariable> amountCache(cashflowInfo.size());
 
+    // initial model states and cache for the cashflow deflators, shared by all cashflow path value calculations
+
+    std::vector<RandomVariable> initialValues(model_->stateProcess()->initialValues().size());
+    for (Size i = 0; i < initialValues.size(); ++i)
+        initialValues[i] = RandomVariable(calibrationSamples_, model_->stateProcess()->initialValues()[i]);
+
+    std::map<std::pair<Size, Size>, RandomVariable> deflators;
+
     Size counter = exerciseXvaTimes.size() - 1;
 
     for (auto t = exerciseXvaTimes.rbegin(); t != exerciseXvaTimes.rend(); ++t) {
@@ -851,12 +958,14 @@ void McMultiLegBaseEngine::calculate() const {
 
             if (cfStatus[i] == CfStatus::open) {
                 if (cashflowInfo[i].exIntoCriterionTime > *t) {
-                    auto tmp = cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+                    auto tmp =
+                        cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes, initialValues, deflators);
                     pathValueUndDirty += tmp;
                     pathValueUndExInto += tmp;
                     cfStatus[i] = CfStatus::done;
                 } else if (cashflowInfo[i].payTime > *t) {
-                    auto tmp = cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+                    auto tmp =
+                        cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes, initialValues, deflators);
                     pathValueUndDirty += tmp;
                     amountCache[i] = tmp;
                     cfStatus[i] = CfStatus::cached;
@@ -920,15 +1029,17 @@ void McMultiLegBaseEngine::calculate() const {
 
     for (Size i = 0; i < cashflowInfo.size(); ++i) {
         if (cfStatus[i] == CfStatus::open)
-            pathValueUndDirty += cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes);
+            pathValueUndDirty +=
+                cashflowPathValue(cashflowInfo[i], pathValues, simulationTimes, initialValues, deflators);
     }
 
     // set the result value (= underlying value if no exercise is given, otherwise option value)
 
-    resultUnderlyingNpv_ = expectation(pathValueUndDirty).at(0) * model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
-    resultValue_ = exercise_ == nullptr
-                       ? resultUnderlyingNpv_
-                       : expectation(pathValueOption).at(0) * model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
+    Real initialNumeraire = isHwModel() ? model_->numeraire(0, 0.0, Array(model_->irModel(0)->n(), 0.0),
+                                                            discountCurves_[0], Array(model_->irModel(0)->n_aux(), 0.0))
+                                        : model_->numeraire(0, 0.0, 0.0, discountCurves_[0]);
+    resultUnderlyingNpv_ = expectation(pathValueUndDirty).at(0) * initialNumeraire;
+    resultValue_ = exercise_ == nullptr ? resultUnderlyingNpv_ : expectation(pathValueOption).at(0) * initialNumeraire;
 
     McEngineStats::instance().calc_timer.stop();
 
@@ -937,7 +1048,7 @@ void McMultiLegBaseEngine::calculate() const {
     amcCalculator_ = boost::make_shared<MultiLegBaseAmcCalculator>(
         externalModelIndices_, optionSettlement_, exerciseXvaTimes, exerciseTimes, xvaTimes, regModelUndDirty,
         regModelUndExInto, regModelContinuationValue, regModelOption, resultValue_,
-        model_->stateProcess()->initialValues(), model_->irlgm1f(0)->currency());
+        model_->stateProcess()->initialValues(), model_->ir(0)->currency());
 }
 
 boost::shared_ptr<AmcCalculator> McMultiLegBaseEngine::amcCalculator() const { return amcCalculator_; }
@@ -1158,10 +1269,10 @@ void McMultiLegBaseEngine::RegressionModel::train(const Size polynomOrder,
 
         basisFns_ = multiPathBasisSystem(regressor.size(), polynomOrder, polynomType, Null<Size>());
 
-        // compute the regression coefficients
+        // compute the regression coefficients, reusing a cached factorisation of the design matrix if available
 
-        regressionCoeffs_ =
-            regressionCoefficients(regressand, regressor, basisFns_, filter, RandomVariableRegressionMethod::QR);
+        regressionCoeffs_ = RandomVariableRegressionCache::instance().regressionCoefficients(
+            regressand, regressor, basisFns_, polynomOrder, polynomType, filter);
 
     } else {
 
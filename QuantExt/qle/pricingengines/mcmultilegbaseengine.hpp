@@ -26,6 +26,7 @@
 #include <qle/instruments/multilegoption.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/models/crossassetmodel.hpp>
+#include <qle/models/hwvectorised.hpp>
 #include <qle/models/lgmvectorised.hpp>
 #include <qle/pricingengines/amccalculator.hpp>
 
@@ -63,6 +64,8 @@ protected:
         Current limitations:
         - the parameter minimalObsDate is ignored, the corresponding optimization is not implemented yet
         - pricingSamples are ignored, the npv from the training phase is used alway
+        - for HW based cross asset models the BA measure is required and cms, bma and sub periods coupons are not
+          supported
     */
     McMultiLegBaseEngine(
         const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
@@ -183,6 +186,12 @@ private:
     // convert a date to a time w.r.t. the valuation date
     Real time(const Date& d) const;
 
+    // true if the ir components of the model are HW models, otherwise they are LGM1F models
+    bool isHwModel() const;
+
+    // the model indices of the ir state of a ccy, i.e. the lgm state or the hw factors (without the aux states)
+    std::vector<Size> irStateIndices(const Size ccyIdx) const;
+
     // create the info for a given flow
     CashflowInfo createCashflowInfo(boost::shared_ptr<CashFlow> flow, const Currency& payCcy, Real payer, Size legNo,
                                     Size cfNo) const;
@@ -190,15 +199,21 @@ private:
     // get the index of a time in the given simulation times set
     Size timeIndex(const Time t, const std::set<Real>& simulationTimes) const;
 
-    // compute a cashflow path value (in model base ccy)
+    /* compute a cashflow path value (in model base ccy), initialValues are the model states at t = 0, deflators is
+       a cache for the deflators keyed by pay time index and pay ccy index, populated on the fly */
     RandomVariable cashflowPathValue(const CashflowInfo& cf, const std::vector<std::vector<RandomVariable>>& pathValues,
-                                     const std::set<Real>& simulationTimes) const;
+                                     const std::set<Real>& simulationTimes,
+                                     const std::vector<RandomVariable>& initialValues,
+                                     std::map<std::pair<Size, Size>, RandomVariable>& deflators) const;
 
     // valuation date
     mutable Date today_;
 
     // lgm vectorised instances for each ccy
     mutable std::vector<LgmVectorised> lgmVectorised_;
+
+    // hw vectorised instances for each ccy, used instead of the lgm vectorised instances for HW models
+    mutable std::vector<HwVectorised> hwVectorised_;
 };
 
 } // namespace QuantExt
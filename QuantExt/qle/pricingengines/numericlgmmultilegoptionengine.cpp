@@ -244,6 +244,16 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
         }
     }
 
+    /* Map (cf leg, cf number) => option date on which the cashflow enters the exercise into npv, cashflows that are
+       not relevant for any option date are mapped to the null date. */
+
+    std::map<std::pair<Size, Size>, Date> exerciseBucket;
+
+    for (auto const& d : optionDates) {
+        for (auto const& cf : d.second)
+            exerciseBucket[cf] = d.first;
+    }
+
     /* map a actual simulation date => set of (cf leg, cf number) */
 
     std::map<Date, std::set<std::pair<Size, Size>>> cashflowDates;
@@ -285,8 +295,10 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
     RandomVariable optionNpv(gridSize(), 0.0);
     // cashflow npvs that are part of the latest exercise into option
     RandomVariable underlyingNpv1(gridSize(), 0.0);
-    // cashflow npvs that are estimated, but not yet part of the latest exercise into option
-    std::map<std::pair<Size, Size>, RandomVariable> underlyingNpv2;
+    /* cashflow npvs that are estimated, but not yet part of the latest exercise into option, aggregated by the option
+       date on which they enter the exercise into npv (see exerciseBucket), so that we only roll back one array per
+       bucket and not one per cashflow */
+    std::map<Date, RandomVariable> underlyingNpv2;
 
     for (auto it = simulationDates.rbegin(); it != simulationDates.rend(); ++it) {
 
@@ -306,11 +318,13 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
             for (auto const& cf : cashflow->second) {
                 auto tmp = getUnderlyingCashflowPv(lgm, t_from, state, discountCurve_, legs_[cf.first][cf.second]) *
                            RandomVariable(gridSize(), payer_[cf.first]);
-                auto it = underlyingNpv2.find(cf);
+                auto b = exerciseBucket.find(cf);
+                Date bucket = b == exerciseBucket.end() ? Date() : b->second;
+                auto it = underlyingNpv2.find(bucket);
                 if (it != underlyingNpv2.end())
                     it->second += tmp;
                 else
-                    underlyingNpv2[cf] = tmp;
+                    underlyingNpv2[bucket] = tmp;
             }
         }
 
@@ -320,9 +334,10 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
 
             // transfer relevant cashflow amounts to exercise into npv
 
-            for (auto const& cf : option->second) {
-                underlyingNpv1 += underlyingNpv2[cf];
-                underlyingNpv2.erase(cf);
+            auto b = underlyingNpv2.find(option->first);
+            if (b != underlyingNpv2.end()) {
+                underlyingNpv1 += b->second;
+                underlyingNpv2.erase(b);
             }
 
             // update the option value (exercise value including rebate vs. continuation value)
@@ -334,11 +349,15 @@ void NumericLgmMultiLegOptionEngineBase::calculate() const {
         // rollback
 
         if (t_from != t_to) {
-            underlyingNpv1 = rollback(underlyingNpv1, t_from, t_to);
-            for (auto& c : underlyingNpv2) {
-                c.second = rollback(c.second, t_from, t_to);
-            }
-            optionNpv = rollback(optionNpv, t_from, t_to);
+            std::vector<const RandomVariable*> v{&underlyingNpv1, &optionNpv};
+            for (auto const& c : underlyingNpv2)
+                v.push_back(&c.second);
+            auto r = rollback(v, t_from, t_to);
+            underlyingNpv1 = std::move(r[0]);
+            optionNpv = std::move(r[1]);
+            Size j = 2;
+            for (auto& c : underlyingNpv2)
+                c.second = std::move(r[j++]);
         }
     }
 
@@ -90,6 +90,12 @@ void CrossAssetStateProcess::resetCache(const Size timeSteps) const {
     updateSqrtCorrelation();
 }
 
+std::pair<Array, Matrix> CrossAssetStateProcess::affineExpectation(Time t0, Time dt) const {
+    auto tmp = boost::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_);
+    QL_REQUIRE(tmp, "CrossAssetStateProcess::affineExpectation(): requires exact discretization");
+    return tmp->affineExpectation(*this, t0, dt);
+}
+
 void CrossAssetStateProcess::updateSqrtCorrelation() const {
     if (model_->discretization() != CrossAssetModel::Discretization::Euler)
         return;
@@ -641,6 +647,26 @@ Matrix CrossAssetStateProcess::ExactDiscretization::covariance(const StochasticP
     }
 }
 
+std::pair<Array, Matrix>
+CrossAssetStateProcess::ExactDiscretization::affineExpectation(const StochasticProcess& p, Time t0, Time dt) const {
+    // driftImpl1 is state independent, driftImpl2 is linear in the state, so we can read off the columns of B
+    // by evaluating driftImpl2 on the unit vectors
+    Size n = model_->dimension();
+    Array x0(n, 0.0);
+    Array a = driftImpl1(p, t0, x0, dt);
+    Array b0 = driftImpl2(p, t0, x0, dt);
+    a += b0;
+    Matrix B(n, n);
+    for (Size k = 0; k < n; ++k) {
+        x0[k] = 1.0;
+        Array bk = driftImpl2(p, t0, x0, dt);
+        for (Size j = 0; j < n; ++j)
+            B[j][k] = bk[j] - b0[j];
+        x0[k] = 0.0;
+    }
+    return std::make_pair(a, B);
+}
+
 Array CrossAssetStateProcess::ExactDiscretization::driftImpl1(const StochasticProcess&, Time t0, const Array&,
                                                               Time dt) const {
     Size n = model_->components(CrossAssetModel::AssetType::IR);
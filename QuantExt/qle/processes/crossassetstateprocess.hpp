@@ -54,6 +54,10 @@ public:
     // enables and resets the cache, once enabled the simulated times must stay the stame
     void resetCache(const Size timeSteps) const;
 
+    /* for the exact discretization the conditional expectation E( x(t0 + dt) | x(t0) = x0 ) is affine in x0, i.e. of
+       the form a + B x0, this method returns (a, B); it throws if the exact discretization is not used */
+    std::pair<Array, Matrix> affineExpectation(Time t0, Time dt) const;
+
 protected:
     virtual Matrix diffusionOnCorrelatedBrownians(Time t, const Array& x) const;
     virtual Matrix diffusionOnCorrelatedBrowniansImpl(Time t, const Array& x) const;
@@ -74,6 +78,7 @@ protected:
         virtual Matrix diffusion(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix covariance(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         void resetCache(const Size timeSteps) const;
+        std::pair<Array, Matrix> affineExpectation(const StochasticProcess&, Time t0, Time dt) const;
 
     protected:
         virtual Array driftImpl1(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
@@ -123,7 +123,21 @@ BlackVolatilitySurfaceDelta::BlackVolatilitySurfaceDelta(
     registerWith(foreignTS_);
 }
 
+void BlackVolatilitySurfaceDelta::update() {
+    cachedSmiles_.clear();
+    BlackVolatilityTermStructure::update();
+}
+
 boost::shared_ptr<FxSmileSection> BlackVolatilitySurfaceDelta::blackVolSmile(Time t) const {
+    auto s = cachedSmiles_.find(t);
+    if (s != cachedSmiles_.end())
+        return s->second;
+    auto smile = buildSmile(t);
+    cachedSmiles_[t] = smile;
+    return smile;
+}
+
+boost::shared_ptr<FxSmileSection> BlackVolatilitySurfaceDelta::buildSmile(Time t) const {
 
     Real spot = spot_->value();
     DiscountFactor dDiscount = domesticTS_->discount(t);
@@ -233,4 +247,34 @@ Volatility BlackVolatilitySurfaceDelta::blackVolImpl(Time t, Real strike) const
     return blackVolSmile(tme)->volatility(strike);
 }
 
+std::vector<Volatility> BlackVolatilitySurfaceDelta::blackVols(Time t, const std::vector<Real>& strikes,
+                                                               bool extrapolate) const {
+    checkRange(t, extrapolate);
+    Time tme = t <= times_.back() ? t : times_.back();
+    boost::shared_ptr<FxSmileSection> smile;
+    std::vector<Volatility> result(strikes.size());
+    for (Size i = 0; i < strikes.size(); ++i) {
+        Real strike = strikes[i];
+        checkStrike(strike, extrapolate);
+        // same treatment of strike == 0 as in blackVolImpl()
+        if (strike == 0 || strike == Null<Real>()) {
+            if (hasAtm_) {
+                result[i] = interpolators_[putDeltas_.size()]->blackVol(tme, Null<Real>(), true);
+                continue;
+            }
+            strike = forward(tme);
+        }
+        if (smile == nullptr)
+            smile = blackVolSmile(tme);
+        result[i] = smile->volatility(strike);
+    }
+    return result;
+}
+
+std::vector<Volatility> BlackVolatilitySurfaceDelta::blackVols(const Date& d, const std::vector<Real>& strikes,
+                                                               bool extrapolate) const {
+    checkRange(d, extrapolate);
+    return blackVols(timeFromReference(d), strikes, extrapolate);
+}
+
 } // namespace QuantExt
@@ -35,6 +35,8 @@
 #include <ql/time/daycounter.hpp>
 #include <qle/termstructures/fxsmilesection.hpp>
 
+#include <map>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -122,12 +124,24 @@ public:
     /*! Note the smile does not observe the spot or YTS handles, it will
      *  not update when they change.
      *
-     *  This is not really FX specific
+     *  This is not really FX specific. The smiles are cached by time, the cache is cleared
+     *  when the surface is notified of a change in the spot or the curves.
      */
     boost::shared_ptr<FxSmileSection> blackVolSmile(Time t) const;
 
     boost::shared_ptr<FxSmileSection> blackVolSmile(const QuantLib::Date& d) const;
 
+    /*! Return the vols for several strikes at time t, this is equivalent to calling blackVol(t, strike, extrapolate)
+        for each strike, but the smile at t is only looked up once */
+    std::vector<Volatility> blackVols(Time t, const std::vector<Real>& strikes, bool extrapolate = false) const;
+    std::vector<Volatility> blackVols(const QuantLib::Date& d, const std::vector<Real>& strikes,
+                                      bool extrapolate = false) const;
+
+    //! \name Observer interface
+    //@{
+    void update() override;
+    //@}
+
 protected:
     virtual Volatility blackVolImpl(Time t, Real strike) const override;
 
@@ -157,8 +171,14 @@ private:
 
     Real switchTime_;
 
+    // smiles by time, built on demand and cleared when the spot or one of the curves changes
+    mutable std::map<Time, boost::shared_ptr<FxSmileSection>> cachedSmiles_;
+
     // calculate forward for time $t$
     Real forward(Time t) const;
+
+    // build the smile for time $t$
+    boost::shared_ptr<FxSmileSection> buildSmile(Time t) const;
 };
 
 // inline definitions
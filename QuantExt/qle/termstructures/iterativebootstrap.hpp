@@ -24,6 +24,7 @@
 #define quantext_iterative_bootstrap_hpp
 
 #include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/math/matrixutilities/qrdecomposition.hpp>
 #include <ql/math/solvers1d/brent.hpp>
 #include <ql/math/solvers1d/finitedifferencenewtonsafe.hpp>
 #include <ql/termstructures/bootstraperror.hpp>
@@ -73,6 +74,12 @@ QuantLib::Real dontThrowFallback(const QuantLib::BootstrapError<Curve>& error, Q
       \c accuracy specified in the \c Curve which is useful in some situations e.g. cubic spline and optionlet
       stripping. If the \c globalAccuracy is set less than the \c accuracy in the \c Curve, the \c accuracy in the
       \c Curve is used instead.
+    - addition of a \c globalNewton parameter. If the bootstrap requires several iterations over all pillars (e.g. for
+      global interpolation schemes), the result of the first iteration is used as a guess for a Newton solver on all
+      pillars simultaneously instead of repeating the pillar by pillar bootstrap. The Jacobian of the helper quote
+      errors w.r.t. the curve values is computed by finite differences once and then maintained by Broyden updates,
+      it is only recomputed if a step based on the updated Jacobian fails. If the Newton solver does not converge,
+      the iterative bootstrap is continued from the result of the first iteration.
 */
 template <class Curve> class IterativeBootstrap {
     typedef typename Curve::traits_type Traits;
@@ -91,17 +98,21 @@ public:
         \param minFactor      Factor for min value retry on each iteration if there is a failure.
         \param dontThrowSteps If \p dontThrow is \c true, this gives the number of steps to use when searching
                               for a fallback curve pillar value that gives the minimum bootstrap helper error.
+        \param globalNewton   If set to \c true, a Newton solver on all pillars is used after the first iteration
+                              if the bootstrap requires more than one iteration.
     */
     IterativeBootstrap(QuantLib::Real accuracy = QuantLib::Null<QuantLib::Real>(),
                        QuantLib::Real globalAccuracy = QuantLib::Null<QuantLib::Real>(), bool dontThrow = false,
                        QuantLib::Size maxAttempts = 1, QuantLib::Real maxFactor = 2.0, QuantLib::Real minFactor = 2.0,
-                       QuantLib::Size dontThrowSteps = 10);
+                       QuantLib::Size dontThrowSteps = 10, bool globalNewton = false);
 
     void setup(Curve* ts);
     void calculate() const;
 
 private:
     void initialize() const;
+    QuantLib::Array helperErrors() const;
+    bool solveGlobalNewton(QuantLib::Real accuracy, QuantLib::Real globalAccuracy) const;
     Curve* ts_;
     QuantLib::Size n_;
     QuantLib::Brent firstSolver_;
@@ -117,15 +128,18 @@ private:
     QuantLib::Real maxFactor_;
     QuantLib::Real minFactor_;
     QuantLib::Size dontThrowSteps_;
+    bool globalNewton_;
 };
 
 template <class Curve>
 IterativeBootstrap<Curve>::IterativeBootstrap(QuantLib::Real accuracy, QuantLib::Real globalAccuracy, bool dontThrow,
                                               QuantLib::Size maxAttempts, QuantLib::Real maxFactor,
-                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps)
+                                              QuantLib::Real minFactor, QuantLib::Size dontThrowSteps,
+                                              bool globalNewton)
     : ts_(0), n_(0), initialized_(false), validCurve_(false), loopRequired_(Interpolator::global),
       firstAliveHelper_(0), alive_(0), accuracy_(accuracy), globalAccuracy_(globalAccuracy), dontThrow_(dontThrow),
-      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps) {}
+      maxAttempts_(maxAttempts), maxFactor_(maxFactor), minFactor_(minFactor), dontThrowSteps_(dontThrowSteps),
+      globalNewton_(globalNewton) {}
 
 template <class Curve> void IterativeBootstrap<Curve>::setup(Curve* ts) {
     ts_ = ts;
@@ -346,6 +360,10 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
         if (change <= globalAccuracy || change <= accuracy)
             break;
 
+        // solve for all pillars simultaneously, using the result of the first iteration as a guess
+        if (globalNewton_ && iteration == 0 && solveGlobalNewton(accuracy, globalAccuracy))
+            break;
+
         // If we hit the max number of iterations and dontThrow is true, just use what we have
         if (iteration == maxIterations) {
             if (dontThrow_) {
@@ -363,6 +381,104 @@ template <class Curve> void IterativeBootstrap<Curve>::calculate() const {
     validCurve_ = true;
 }
 
+template <class Curve> QuantLib::Array IterativeBootstrap<Curve>::helperErrors() const {
+    QuantLib::Array result(alive_);
+    for (QuantLib::Size i = 0; i < alive_; ++i)
+        result[i] = ts_->instruments_[firstAliveHelper_ + i]->quoteError();
+    return result;
+}
+
+template <class Curve>
+bool IterativeBootstrap<Curve>::solveGlobalNewton(QuantLib::Real accuracy, QuantLib::Real globalAccuracy) const {
+
+    // all curve updates go through Traits::updateGuess() as in BootstrapError, so that e.g. data[0] is kept in sync
+    // with data[1] for zero yield and forward rate traits
+
+    std::vector<QuantLib::Real>& data = ts_->data_;
+    const std::vector<QuantLib::Real> initialData = data;
+    QuantLib::Real tolerance = std::max(globalAccuracy, accuracy);
+
+    try {
+        QuantLib::Array f = helperErrors();
+        QuantLib::Matrix jacobian(alive_, alive_);
+        bool recompute = true, freshJacobian = false;
+        for (QuantLib::Size iteration = 0; iteration < Traits::maxIterations(); ++iteration) {
+
+            // Jacobian of the helper errors w.r.t. the curve values at the pillars, by forward differences, this is
+            // only done in the first iteration and if a step based on the Broyden update of the Jacobian fails
+            if (recompute) {
+                for (QuantLib::Size j = 1; j <= alive_; ++j) {
+                    QuantLib::Real x = data[j];
+                    QuantLib::Real h = 1.0E-6 * std::max(1.0, std::fabs(x));
+                    Traits::updateGuess(data, x + h, j);
+                    ts_->interpolation_.update();
+                    QuantLib::Array fh = helperErrors();
+                    for (QuantLib::Size i = 0; i < alive_; ++i)
+                        jacobian[i][j - 1] = (fh[i] - f[i]) / h;
+                    Traits::updateGuess(data, x, j);
+                }
+                ts_->interpolation_.update();
+                recompute = false;
+                freshJacobian = true;
+            }
+
+            QuantLib::Array dx = QuantLib::qrSolve(jacobian, -f);
+
+            // damped update, we accept a step if it reduces the helper errors
+            const std::vector<QuantLib::Real> previousData = data;
+            QuantLib::Real previousNorm = QuantLib::Norm2(f);
+            QuantLib::Real lambda = 1.0, change = 0.0;
+            QuantLib::Array fNew;
+            bool accepted = false;
+            for (QuantLib::Size k = 0; k < 10 && !accepted; ++k, lambda *= 0.5) {
+                change = 0.0;
+                for (QuantLib::Size j = 1; j <= alive_; ++j) {
+                    Traits::updateGuess(data, previousData[j] + lambda * dx[j - 1], j);
+                    change = std::max(change, std::fabs(lambda * dx[j - 1]));
+                }
+                ts_->interpolation_.update();
+                try {
+                    fNew = helperErrors();
+                    QuantLib::Real norm = QuantLib::Norm2(fNew);
+                    accepted = std::isfinite(norm) && (norm < previousNorm || change <= tolerance);
+                } catch (...) {
+                }
+            }
+
+            if (!accepted) {
+                data = previousData;
+                ts_->interpolation_.update();
+                // give up if the step was based on a finite difference Jacobian, otherwise retry with one
+                if (freshJacobian)
+                    break;
+                recompute = true;
+                continue;
+            }
+
+            if (change <= tolerance)
+                return true;
+
+            // Broyden update of the Jacobian: J += (y - J s) s^T / (s^T s) with s = step, y = change in errors
+            QuantLib::Array step(alive_);
+            for (QuantLib::Size j = 0; j < alive_; ++j)
+                step[j] = data[j + 1] - previousData[j + 1];
+            QuantLib::Array r = fNew - f - jacobian * step;
+            QuantLib::Real ss = QuantLib::DotProduct(step, step);
+            for (QuantLib::Size i = 0; i < alive_; ++i)
+                for (QuantLib::Size j = 0; j < alive_; ++j)
+                    jacobian[i][j] += r[i] * step[j] / ss;
+            f = fNew;
+            freshJacobian = false;
+        }
+    } catch (...) {
+    }
+
+    // no convergence, restore the data from the first iteration
+    data = initialData;
+    ts_->interpolation_.update();
+    return false;
+}
+
 } // namespace QuantExt
 
 #endif
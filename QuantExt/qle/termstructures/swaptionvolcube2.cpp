@@ -65,6 +65,7 @@ SwaptionVolCube2::SwaptionVolCube2(const Handle<SwaptionVolatilityStructure>& at
 void SwaptionVolCube2::performCalculations() const {
 
     SwaptionVolatilityCube::performCalculations();
+    smileSectionCache_.clear();
     //! set volSpreadsMatrix_ by volSpreads_ quotes
     for (Size i = 0; i < nStrikes_; i++)
         for (Size j = 0; j < nOptionTenors_; j++)
@@ -101,6 +102,24 @@ boost::shared_ptr<SmileSection> SwaptionVolCube2::smileSectionImpl(Time optionTi
 boost::shared_ptr<SmileSection> SwaptionVolCube2::smileSectionImpl(const Date& optionDate,
                                                                    const Period& swapTenor) const {
     calculate();
+    auto key = std::make_tuple(optionDate, swapTenor.length(), static_cast<Integer>(swapTenor.units()));
+    auto s = smileSectionCache_.find(key);
+    if (s != smileSectionCache_.end())
+        return s->second;
+    return smileSectionCache_[key] = buildSmileSection(optionDate, swapTenor);
+}
+
+std::vector<Volatility> SwaptionVolCube2::volatilities(const Date& optionDate, const Period& swapTenor,
+                                                       const std::vector<Rate>& strikes) const {
+    boost::shared_ptr<SmileSection> section = smileSectionImpl(optionDate, swapTenor);
+    std::vector<Volatility> result(strikes.size());
+    for (Size i = 0; i < strikes.size(); ++i)
+        result[i] = section->volatility(strikes[i]);
+    return result;
+}
+
+boost::shared_ptr<SmileSection> SwaptionVolCube2::buildSmileSection(const Date& optionDate,
+                                                                    const Period& swapTenor) const {
     Rate atmForward = atmStrike(optionDate, swapTenor);
     Volatility referenceVol = volsAreSpreads_ ? atmVol_->volatility(optionDate, swapTenor, atmForward) : 0.0;
     Time optionTime = std::max(1E-6, timeFromReference(optionDate));
@@ -44,6 +44,9 @@
 #include <ql/math/interpolations/interpolation2d.hpp>
 #include <ql/termstructures/volatility/swaption/swaptionvolcube.hpp>
 
+#include <map>
+#include <tuple>
+
 namespace QuantExt {
 using namespace QuantLib;
 
@@ -63,6 +66,12 @@ public:
 
         If flatExtrapolation is true the implied volatility is
         extrapolated flat in strike direction.
+
+        The smile sections (including the atm forward and shift) are
+        cached per option date and swap tenor, the cache is cleared
+        when the cube is recalculated, i.e. after a notification from
+        the atm vol structure, the vol spread quotes, the swap indices
+        or the evaluation date.
   */
     /*! in case volsAreSpreads is false the given volSpreads are interpreted as absolute vols,
       in this case the volSpreads inspectors also return absolute vols */
@@ -83,10 +92,17 @@ public:
     boost::shared_ptr<SmileSection> smileSectionImpl(const Date& optionDate, const Period& swapTenor) const override;
     boost::shared_ptr<SmileSection> smileSectionImpl(Time optionTime, Time swapLength) const override;
     //@}
+    //! volatilities for several strikes, using a single (cached) smile section
+    std::vector<Volatility> volatilities(const Date& optionDate, const Period& swapTenor,
+                                         const std::vector<Rate>& strikes) const;
+
 private:
+    boost::shared_ptr<SmileSection> buildSmileSection(const Date& optionDate, const Period& swapTenor) const;
     const bool flatExtrapolation_, volsAreSpreads_;
     mutable std::vector<Interpolation2D> volSpreadsInterpolator_;
     mutable std::vector<Matrix> volSpreadsMatrix_;
+    // key is option date, swap tenor length and units (periods are not always comparable, so we do not use them)
+    mutable std::map<std::tuple<Date, Integer, Integer>, boost::shared_ptr<SmileSection>> smileSectionCache_;
 };
 
 } // namespace QuantExt
@@ -71,6 +71,53 @@ BOOST_AUTO_TEST_CASE(testBlackVolSurfaceDeltaConstantVol) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testBlackVolSurfaceDeltaSmileCache) {
+
+    BOOST_TEST_MESSAGE("Testing QuantExt::BlackVolatilitySurfaceDelta smile cache and batched vols...");
+
+    Date refDate(1, Jan, 2010);
+    Settings::instance().evaluationDate() = refDate;
+
+    vector<Date> dates = { Date(1, Jan, 2011), Date(1, Jan, 2012) };
+    vector<Real> putDeltas = { -0.25 };
+    vector<Real> callDeltas = { 0.25 };
+    Matrix blackVolMatrix(2, 3);
+    blackVolMatrix[0][0] = 0.12;
+    blackVolMatrix[0][1] = 0.10;
+    blackVolMatrix[0][2] = 0.11;
+    blackVolMatrix[1][0] = 0.13;
+    blackVolMatrix[1][1] = 0.11;
+    blackVolMatrix[1][2] = 0.12;
+
+    auto spotQuote = boost::make_shared<SimpleQuote>(1.0);
+    Handle<Quote> spot(spotQuote);
+    Handle<YieldTermStructure> dts(boost::make_shared<FlatForward>(0, TARGET(), 0.011, ActualActual(ActualActual::ISDA)));
+    Handle<YieldTermStructure> fts(boost::make_shared<FlatForward>(0, TARGET(), 0.012, ActualActual(ActualActual::ISDA)));
+
+    BlackVolatilitySurfaceDelta surface(refDate, dates, putDeltas, callDeltas, true, blackVolMatrix,
+                                        ActualActual(ActualActual::ISDA), TARGET(), spot, dts, fts);
+
+    vector<Real> strikes;
+    for (Real k = 0.5; k < 2.0; k += 0.05)
+        strikes.push_back(k);
+    strikes.push_back(0.0);
+
+    for (Real s : { 1.0, 1.2 }) {
+        spotQuote->setValue(s);
+        // a surface without cached smiles serves as reference
+        BlackVolatilitySurfaceDelta reference(refDate, dates, putDeltas, callDeltas, true, blackVolMatrix,
+                                              ActualActual(ActualActual::ISDA), TARGET(), spot, dts, fts);
+        for (Time t : { 0.25, 0.5, 1.0, 1.5, 2.0, 2.5 }) {
+            vector<Volatility> vols = surface.blackVols(t, strikes, true);
+            BOOST_REQUIRE_EQUAL(vols.size(), strikes.size());
+            for (Size i = 0; i < strikes.size(); ++i) {
+                BOOST_CHECK_EQUAL(vols[i], surface.blackVol(t, strikes[i], true));
+                BOOST_CHECK_EQUAL(vols[i], reference.blackVol(t, strikes[i], true));
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testInterpolatedSmileSectionConstruction) {
 
     BOOST_TEST_MESSAGE("Testing QuantExt::InterpolatedSmileSection...");
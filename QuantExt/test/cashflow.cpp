@@ -20,14 +20,23 @@
 #include <boost/make_shared.hpp>
 #include <boost/test/unit_test.hpp>
 #include <ql/currencies/all.hpp>
+#include <ql/indexes/ibor/eonia.hpp>
+#include <ql/indexes/ibor/estr.hpp>
+#include <ql/indexes/ibor/sonia.hpp>
 #include <ql/indexes/indexmanager.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
 #include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <qle/cashflows/averageonindexedcoupon.hpp>
+#include <qle/cashflows/averageonindexedcouponpricer.hpp>
 #include <qle/cashflows/equitycoupon.hpp>
 #include <qle/cashflows/equitycouponpricer.hpp>
 #include <qle/cashflows/fxlinkedcashflow.hpp>
+#include <qle/cashflows/overnightindexedcoupon.hpp>
+#include <qle/cashflows/overnightpastfixingscache.hpp>
+#include <qle/indexes/fallbackovernightindex.hpp>
 
 using namespace QuantLib;
 using namespace QuantExt;
@@ -197,6 +206,184 @@ BOOST_AUTO_TEST_CASE(testEquityCoupon) {
     BOOST_CHECK_CLOSE(eq5.amount(), expectedAmount, 1e-10);
 }
 
+BOOST_AUTO_TEST_CASE(testOvernightPastFixingsCache) {
+
+    BOOST_TEST_MESSAGE("Testing invalidation of the overnight past fixings cache...");
+
+    Date d(15, January, 2024);
+    auto index = boost::make_shared<Estr>();
+    OvernightPastFixingsCache cache(index->name());
+    Size i = 0;
+    Real v1 = 0.0, v2 = 0.0;
+
+    // nothing cached yet
+    BOOST_CHECK(!cache.get(d, i, v1, v2));
+
+    // date roll forward keeps the cache
+    cache.set(d, 3, 1.01, 1.02);
+    BOOST_CHECK(cache.get(d + 1, i, v1, v2));
+    BOOST_CHECK_EQUAL(i, 3U);
+    BOOST_CHECK_EQUAL(v1, 1.01);
+    BOOST_CHECK_EQUAL(v2, 1.02);
+
+    // date roll backward discards the cache
+    cache.set(d, 3, 1.01, 1.02);
+    BOOST_CHECK(!cache.get(d - 1, i, v1, v2));
+    BOOST_CHECK(!cache.get(d, i, v1, v2));
+
+    // fixing change on the same date discards the cache
+    cache.set(d, 3, 1.01, 1.02);
+    index->addFixing(Date(10, January, 2024), 0.04);
+    BOOST_CHECK(!cache.get(d, i, v1, v2));
+
+    // past fixing correction followed by a date roll forward discards the cache
+    cache.set(d, 3, 1.01, 1.02);
+    index->addFixing(Date(10, January, 2024), 0.041, true);
+    BOOST_CHECK(!cache.get(d + 1, i, v1, v2));
+
+    // unless the fixings are declared as forward updates, then only a same date call discards the cache
+    cache.set(d, 3, 1.01, 1.02);
+    {
+        OvernightPastFixingsCache::ForwardFixingUpdates forwardUpdates;
+        index->addFixing(Date(16, January, 2024), 0.042);
+    }
+    BOOST_CHECK(cache.get(d + 1, i, v1, v2));
+    cache.set(d, 3, 1.01, 1.02);
+    {
+        OvernightPastFixingsCache::ForwardFixingUpdates forwardUpdates;
+        index->addFixing(Date(16, January, 2024), 0.043, true);
+    }
+    BOOST_CHECK(!cache.get(d, i, v1, v2));
+
+    // the flag is reset when the guard goes out of scope
+    cache.set(d, 3, 1.01, 1.02);
+    index->addFixing(Date(16, January, 2024), 0.044, true);
+    BOOST_CHECK(!cache.get(d + 1, i, v1, v2));
+}
+
+BOOST_AUTO_TEST_CASE(testOvernightPastFixingsCacheFallbackIndex) {
+
+    BOOST_TEST_MESSAGE("Testing invalidation of the overnight past fixings cache for a fallback index...");
+
+    Date d(15, January, 2024);
+    auto original = boost::make_shared<Eonia>();
+    auto rfr = boost::make_shared<Estr>();
+    auto fallback = boost::make_shared<FallbackOvernightIndex>(original, rfr, 0.00085, Date(1, January, 2024),
+                                                               Handle<YieldTermStructure>());
+    OvernightPastFixingsCache cache(fallback);
+    Size i = 0;
+    Real v1 = 0.0, v2 = 0.0;
+
+    // a change in the rfr index fixings discards the cache
+    cache.set(d, 3, 1.01, 1.02);
+    rfr->addFixing(Date(10, January, 2024), 0.04);
+    BOOST_CHECK(!cache.get(d + 1, i, v1, v2));
+
+    // as does a change in the original index fixings
+    cache.set(d, 3, 1.01, 1.02);
+    original->addFixing(Date(20, December, 2023), 0.039);
+    BOOST_CHECK(!cache.get(d + 1, i, v1, v2));
+
+    // a change in an unrelated index keeps the cache
+    cache.set(d, 3, 1.01, 1.02);
+    boost::make_shared<Sonia>()->addFixing(Date(10, January, 2024), 0.05);
+    BOOST_CHECK(cache.get(d + 1, i, v1, v2));
+}
+
+BOOST_AUTO_TEST_CASE(testAverageONIndexedCouponPastFixingCorrection) {
+
+    BOOST_TEST_MESSAGE("Testing averaged overnight coupon rate (Takada) after a past fixing correction...");
+
+    Date start(15, January, 2024), end(15, April, 2024), switchDate(1, February, 2024);
+    Settings::instance().evaluationDate() = start;
+
+    Handle<YieldTermStructure> curve(boost::make_shared<FlatForward>(0, TARGET(), 0.03, Actual365Fixed()));
+    auto original = boost::make_shared<Eonia>(curve);
+    auto rfr = boost::make_shared<Estr>(curve);
+    auto fallback = boost::make_shared<FallbackOvernightIndex>(original, rfr, 0.00085, switchDate, curve);
+
+    for (Date d = start - 5; d < start + 60; ++d) {
+        if (d < switchDate && original->isValidFixingDate(d))
+            original->addFixing(d, 0.034);
+        if (rfr->isValidFixingDate(d))
+            rfr->addFixing(d, 0.035);
+    }
+
+    // a plain index and a fallback index, for the latter the past fixings after the switch date are rfr fixings
+    for (auto const& index : std::vector<boost::shared_ptr<OvernightIndex>>{rfr, fallback}) {
+        BOOST_TEST_MESSAGE("index " << index->name() << (index == fallback ? " (fallback)" : ""));
+        auto rate = [&start, &end, &index]() {
+            AverageONIndexedCoupon coupon(end, 1.0, start, end, index);
+            coupon.setPricer(boost::make_shared<AverageONIndexedCouponPricer>(AverageONIndexedCouponPricer::Takada));
+            return coupon.rate();
+        };
+        AverageONIndexedCoupon coupon(end, 1.0, start, end, index);
+        coupon.setPricer(boost::make_shared<AverageONIndexedCouponPricer>(AverageONIndexedCouponPricer::Takada));
+
+        Settings::instance().evaluationDate() = Date(12, February, 2024);
+        Real rate0 = coupon.rate();
+        BOOST_CHECK_SMALL(rate0 - rate(), 1E-15);
+
+        // correct a rfr fixing after the switch date that is part of the cached accumulation and roll forward
+        rfr->addFixing(Date(6, February, 2024), 0.045, true);
+        Settings::instance().evaluationDate() = Date(19, February, 2024);
+        Real rate1 = coupon.rate();
+        Real expected = rate();
+        BOOST_TEST_MESSAGE("rate before correction " << rate0 << ", after correction " << rate1 << ", expected "
+                                                     << expected);
+        BOOST_CHECK_SMALL(rate1 - expected, 1E-15);
+
+        // roll the date forward without a change in the fixings, the cached accumulation is used
+        Settings::instance().evaluationDate() = Date(26, February, 2024);
+        BOOST_CHECK_SMALL(coupon.rate() - rate(), 1E-15);
+
+        // roll the date backward
+        Settings::instance().evaluationDate() = Date(22, January, 2024);
+        BOOST_CHECK_SMALL(coupon.rate() - rate(), 1E-15);
+
+        rfr->addFixing(Date(6, February, 2024), 0.035, true);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testOvernightIndexedCouponPastFixingCorrection) {
+
+    BOOST_TEST_MESSAGE("Testing overnight indexed coupon rate after a past fixing correction and a date roll...");
+
+    Date start(15, January, 2024), end(15, April, 2024);
+    Settings::instance().evaluationDate() = start;
+
+    Handle<YieldTermStructure> curve(boost::make_shared<FlatForward>(0, TARGET(), 0.03, Actual365Fixed()));
+    auto index = boost::make_shared<Estr>(curve);
+
+    for (Date d = start - 5; d < start + 30; ++d) {
+        if (index->isValidFixingDate(d))
+            index->addFixing(d, 0.035);
+    }
+
+    OvernightIndexedCoupon coupon(end, 1.0, start, end, index);
+
+    Settings::instance().evaluationDate() = Date(1, February, 2024);
+    Real rate0 = coupon.rate();
+    BOOST_CHECK_SMALL(rate0 - OvernightIndexedCoupon(end, 1.0, start, end, index).rate(), 1E-15);
+
+    // correct a fixing that is part of the cached accumulation and roll the date forward
+    index->addFixing(Date(17, January, 2024), 0.045, true);
+    Settings::instance().evaluationDate() = Date(8, February, 2024);
+    Real rate1 = coupon.rate();
+    Real expected = OvernightIndexedCoupon(end, 1.0, start, end, index).rate();
+    BOOST_TEST_MESSAGE("rate before correction " << rate0 << ", after correction " << rate1 << ", expected "
+                                                 << expected);
+    BOOST_CHECK_SMALL(rate1 - expected, 1E-15);
+
+    // roll the date forward without a change in the fixings, the cached accumulation is used
+    Settings::instance().evaluationDate() = Date(12, February, 2024);
+    BOOST_CHECK_SMALL(coupon.rate() - OvernightIndexedCoupon(end, 1.0, start, end, index).rate(), 1E-15);
+
+    // roll the date backward
+    Settings::instance().evaluationDate() = Date(25, January, 2024);
+    BOOST_CHECK_SMALL(coupon.rate() - OvernightIndexedCoupon(end, 1.0, start, end, index).rate(), 1E-15);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
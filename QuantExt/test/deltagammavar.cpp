@@ -222,6 +222,35 @@ BOOST_AUTO_TEST_CASE(testCase001) {
     BOOST_CHECK_CLOSE(var, var_mc, 0.5);
 }
 
+BOOST_AUTO_TEST_CASE(testMcDiagonal) {
+    BOOST_TEST_MESSAGE("Testing delta gamma var mc in eigenbasis of gamma...");
+    std::vector<double> d1{691.043, 8.62406, 9706.97, 0, 0};
+    std::vector<double> d2 = {-13.9605, 0, 0, 0, 0, 0, -0.174223, 0, 0, 0, 0, 0, -196.1,
+                              0,        0, 0, 0, 0, 0, 0,         0, 0, 0, 0, 0};
+    std::vector<double> d3 = {96.3436,   -0.828459, -6.59142,  0.583848, -0.0639266, -0.828459, 97.7309,
+                              12.4906,   -2.03511,  -0.504752, -6.59142, 12.4906,    95.12,     0.800706,
+                              0.443861,  0.583848,  -2.03511,  0.800706, 2.71239,    0.288881,  -0.0639266,
+                              -0.504752, 0.443861,  0.288881,  1.42701};
+    Array delta(d1.begin(), d1.end());
+    Matrix gamma(5, 5, d2.begin(), d2.end());
+    Matrix omega(5, 5, d3.begin(), d3.end());
+    std::vector<Real> quantiles{0.9, 0.95, 0.99};
+    auto mc = deltaGammaVarMc<PseudoRandom>(omega, delta, gamma, quantiles, 1000000, 42);
+    auto mcDiag1 = deltaGammaVarMcDiagonal(omega, delta, gamma, quantiles, 1000000, 42);
+    auto mcDiag4 = deltaGammaVarMcDiagonal(omega, delta, gamma, quantiles, 1000000, 42, NoCovarianceSalvage(), 4);
+    for (Size i = 0; i < quantiles.size(); ++i) {
+        Real sd = deltaGammaVarSaddlepoint(omega, delta, gamma, quantiles[i]);
+        BOOST_TEST_MESSAGE("p = " << quantiles[i] << ": sd = " << sd << ", mc = " << mc[i]
+                                  << ", mcDiag = " << mcDiag1[i]);
+        BOOST_CHECK_CLOSE(sd, mcDiag1[i], 0.5);
+        BOOST_CHECK_CLOSE(mc[i], mcDiag1[i], 0.5);
+        // the result must not depend on the number of threads
+        BOOST_CHECK_EQUAL(mcDiag1[i], mcDiag4[i]);
+    }
+    // zero sensitivities
+    BOOST_CHECK_EQUAL(deltaGammaVarMcDiagonal(omega, Array(5, 0.0), Matrix(5, 5, 0.0), 0.99, 1000, 42), 0.0);
+}
+
 BOOST_AUTO_TEST_CASE(testCase002) {
     // failed as of 05-Sep-2018
     BOOST_TEST_MESSAGE("Running regression test case 002...");
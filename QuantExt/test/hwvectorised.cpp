@@ -0,0 +1,263 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/models/hwconstantparametrization.hpp>
+#include <qle/models/hwmodel.hpp>
+#include <qle/models/hwvectorised.hpp>
+#include <qle/models/irlgm1fpiecewiseconstanthullwhiteadaptor.hpp>
+#include <qle/models/lgmvectorised.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/indexes/ibor/estr.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/schedule.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using namespace QuantExt;
+
+namespace {
+
+// one factor hw parametrization with parameters that can be changed after construction
+class MutableHwParametrization : public IrHwParametrization {
+public:
+    MutableHwParametrization(const Handle<YieldTermStructure>& ts, const Real sigma, const Real kappa)
+        : IrHwParametrization(1, 1, EURCurrency(), ts), sigma_(sigma), kappa_(kappa) {}
+    Matrix sigma_x(const Time) const override { return Matrix(1, 1, sigma_); }
+    Array kappa(const Time) const override { return Array(1, kappa_); }
+    Matrix y(const Time t) const override {
+        return Matrix(1, 1, sigma_ * sigma_ * (1.0 - std::exp(-2.0 * kappa_ * t)) / (2.0 * kappa_));
+    }
+    Array g(const Time t, const Time T) const override {
+        return Array(1, (1.0 - std::exp(-kappa_ * (T - t))) / kappa_);
+    }
+    Real sigma_, kappa_;
+};
+
+// n path values per factor
+std::vector<RandomVariable> states(const Size n, const Real scale) {
+    std::vector<RandomVariable> x(n, RandomVariable(5));
+    for (Size i = 0; i < n; ++i)
+        for (Size k = 0; k < 5; ++k)
+            x[i].set(k, scale * (static_cast<Real>(k) - 2.0 + 0.3 * static_cast<Real>(i)));
+    return x;
+}
+
+Array pathState(const std::vector<RandomVariable>& x, const Size k) {
+    Array result(x.size());
+    for (Size i = 0; i < x.size(); ++i)
+        result[i] = x[i][k];
+    return result;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HwVectorisedTest)
+
+BOOST_AUTO_TEST_CASE(testDiscountBondNumeraireFixingVsHwModel) {
+
+    BOOST_TEST_MESSAGE("Testing HwVectorised discount bond, numeraire and fixing against HwModel for n = 2...");
+
+    Date refDate(15, March, 2023);
+    Settings::instance().evaluationDate() = refDate;
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(refDate, 0.03, Actual365Fixed()));
+    Handle<YieldTermStructure> discountCurve(boost::make_shared<FlatForward>(refDate, 0.025, Actual365Fixed()));
+
+    Matrix sigma(2, 2);
+    sigma[0][0] = 0.008;
+    sigma[0][1] = 0.002;
+    sigma[1][0] = -0.003;
+    sigma[1][1] = 0.006;
+    Array kappa(2);
+    kappa[0] = 0.01;
+    kappa[1] = 0.3;
+
+    auto p = boost::make_shared<IrHwConstantParametrization>(EURCurrency(), yts, sigma, kappa);
+    HwModel model(p);
+    HwVectorised hw(p);
+
+    auto index = boost::make_shared<Euribor6M>(yts);
+
+    std::vector<RandomVariable> x = states(2, 0.01), aux = states(2, 0.05);
+
+    for (Time t : {0.0, 0.5, 2.0, 7.5}) {
+        RandomVariable num = hw.numeraire(t, aux);
+        RandomVariable numDisc = hw.numeraire(t, aux, discountCurve);
+        for (Size k = 0; k < 5; ++k) {
+            BOOST_CHECK_CLOSE(num[k], model.numeraire(t, pathState(x, k), Handle<YieldTermStructure>(),
+                                                      pathState(aux, k)),
+                              1E-12);
+            BOOST_CHECK_CLOSE(numDisc[k], model.numeraire(t, pathState(x, k), discountCurve, pathState(aux, k)),
+                              1E-12);
+        }
+        for (Time T : {t, t + 0.25, t + 3.0, t + 20.0}) {
+            RandomVariable bond = hw.discountBond(t, T, x);
+            RandomVariable bondDisc = hw.discountBond(t, T, x, discountCurve);
+            for (Size k = 0; k < 5; ++k) {
+                BOOST_CHECK_CLOSE(bond[k], model.discountBond(t, T, pathState(x, k)), 1E-12);
+                BOOST_CHECK_CLOSE(bondDisc[k], model.discountBond(t, T, pathState(x, k), discountCurve), 1E-12);
+            }
+        }
+        Date obsDate = refDate + static_cast<Integer>(t * 365.0 + 0.5);
+        for (Date fixingDate : {obsDate + 1, obsDate + 100, obsDate + 1000}) {
+            fixingDate = index->fixingCalendar().adjust(fixingDate);
+            RandomVariable fix = hw.fixing(index, fixingDate, t, x);
+            Date d1 = index->valueDate(fixingDate), d2 = index->maturityDate(d1);
+            Time T1 = std::max(t, yts->timeFromReference(d1)), T2 = std::max(T1, yts->timeFromReference(d2));
+            for (Size k = 0; k < 5; ++k) {
+                Real expected = (model.discountBond(t, T1, pathState(x, k)) /
+                                     model.discountBond(t, T2, pathState(x, k)) -
+                                 1.0) /
+                                index->dayCounter().yearFraction(d1, d2);
+                BOOST_CHECK_CLOSE(fix[k], expected, 1E-10);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testOnRatesVsLgmVectorised) {
+
+    BOOST_TEST_MESSAGE("Testing HwVectorised compounded and averaged on rates against LgmVectorised for an "
+                       "equivalent one factor model...");
+
+    Date refDate(15, March, 2023);
+    Settings::instance().evaluationDate() = refDate;
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(refDate, 0.03, Actual365Fixed()));
+    Real sigma = 0.01, kappa = 0.02;
+
+    auto hwp = boost::make_shared<IrHwConstantParametrization>(EURCurrency(), yts, Matrix(1, 1, sigma),
+                                                               Array(1, kappa));
+    auto lgmp = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, Array(),
+                                                                             Array(1, sigma), Array(), Array(1, kappa));
+    HwVectorised hw(hwp);
+    LgmVectorised lgm(lgmp);
+
+    auto index = boost::make_shared<Estr>(yts);
+
+    Date start(15, June, 2024), end(16, September, 2024);
+    Schedule schedule(start, end, 1 * Days, index->fixingCalendar(), Following, Following, DateGeneration::Forward,
+                      false);
+    std::vector<Date> valueDates = schedule.dates(), fixingDates(valueDates.begin(), valueDates.end() - 1);
+    std::vector<Real> dt;
+    for (Size i = 0; i + 1 < valueDates.size(); ++i)
+        dt.push_back(index->dayCounter().yearFraction(valueDates[i], valueDates[i + 1]));
+
+    /* the hw state x and the lgm state z are related by x = H'(t) (z + zeta(t) H(t)), where H'(t) = exp(-kappa t),
+       the bond prices in both models then coincide */
+    for (Time t : {0.0, 0.5, 1.2, 1.4}) {
+        RandomVariable z = states(1, 0.01).front();
+        RandomVariable x = RandomVariable(5, lgmp->Hprime(t)) *
+                           (z + RandomVariable(5, lgmp->zeta(t) * lgmp->H(t)));
+        for (bool includeSpread : {false, true}) {
+            RandomVariable hwComp =
+                hw.compoundedOnRate(index, fixingDates, valueDates, dt, 0, includeSpread, 0.001, 1.0, 0 * Days,
+                                    Null<Real>(), Null<Real>(), false, false, t, {x});
+            RandomVariable lgmComp =
+                lgm.compoundedOnRate(index, fixingDates, valueDates, dt, 0, includeSpread, 0.001, 1.0, 0 * Days,
+                                     Null<Real>(), Null<Real>(), false, false, t, z);
+            RandomVariable hwAvg = hw.averagedOnRate(index, fixingDates, valueDates, dt, 0, includeSpread, 0.001,
+                                                     1.0, 0 * Days, Null<Real>(), Null<Real>(), false, false, t, {x});
+            RandomVariable lgmAvg = lgm.averagedOnRate(index, fixingDates, valueDates, dt, 0, includeSpread, 0.001,
+                                                       1.0, 0 * Days, Null<Real>(), Null<Real>(), false, false, t, z);
+            for (Size k = 0; k < 5; ++k) {
+                BOOST_CHECK_SMALL(hwComp[k] - lgmComp[k], 1E-12);
+                BOOST_CHECK_SMALL(hwAvg[k] - lgmAvg[k], 1E-12);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCacheInvalidationOnUpdate) {
+
+    BOOST_TEST_MESSAGE("Testing HwVectorised cache invalidation on a parametrization update...");
+
+    Date refDate(15, March, 2023);
+    Settings::instance().evaluationDate() = refDate;
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(refDate, 0.03, Actual365Fixed()));
+    auto p = boost::make_shared<MutableHwParametrization>(yts, 0.01, 0.02);
+    HwModel model(p);
+    HwVectorised hw(p);
+
+    std::vector<RandomVariable> x = states(1, 0.01);
+    RandomVariable bond = hw.discountBond(1.0, 5.0, x);
+    for (Size k = 0; k < 5; ++k)
+        BOOST_CHECK_CLOSE(bond[k], model.discountBond(1.0, 5.0, pathState(x, k)), 1E-12);
+
+    // simulate a recalibration
+    p->sigma_ = 0.02;
+    p->kappa_ = 0.05;
+    model.update();
+
+    bond = hw.discountBond(1.0, 5.0, x);
+    for (Size k = 0; k < 5; ++k)
+        BOOST_CHECK_CLOSE(bond[k], model.discountBond(1.0, 5.0, pathState(x, k)), 1E-12);
+}
+
+BOOST_AUTO_TEST_CASE(testFixingWithFullCache) {
+
+    BOOST_TEST_MESSAGE("Testing HwVectorised fixing when the cache reaches its maximum size between two lookups...");
+
+    Date refDate(15, March, 2023);
+    Settings::instance().evaluationDate() = refDate;
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(refDate, 0.03, Actual365Fixed()));
+    auto p = boost::make_shared<IrHwConstantParametrization>(EURCurrency(), yts, Matrix(1, 1, 0.01), Array(1, 0.02));
+    HwModel model(p);
+    HwVectorised hw(p);
+
+    auto index = boost::make_shared<Euribor6M>(yts);
+    std::vector<RandomVariable> x = states(1, 0.01);
+
+    /* fill the cache up to one entry below its maximum size, so that the lookup of the first bond in the fixing
+       fills the cache and the lookup of the second bond would clear it, if the cache was checked on each lookup */
+    for (Size i = 0; i < HwVectorised::maxCacheSize - 1; ++i)
+        hw.discountBond(0.5, 1.0 + static_cast<Real>(i) * 1E-3, x);
+
+    Date fixingDate = index->fixingCalendar().adjust(refDate + 400);
+    RandomVariable fix = hw.fixing(index, fixingDate, 0.5, x);
+    Date d1 = index->valueDate(fixingDate), d2 = index->maturityDate(d1);
+    Time T1 = yts->timeFromReference(d1), T2 = yts->timeFromReference(d2);
+    for (Size k = 0; k < 5; ++k) {
+        Real expected =
+            (model.discountBond(0.5, T1, pathState(x, k)) / model.discountBond(0.5, T2, pathState(x, k)) - 1.0) /
+            index->dayCounter().yearFraction(d1, d2);
+        BOOST_CHECK_CLOSE(fix[k], expected, 1E-10);
+    }
+
+    // the next evaluation clears the full cache and still yields the same fixing
+    RandomVariable fix2 = hw.fixing(index, fixingDate, 0.5, x);
+    for (Size k = 0; k < 5; ++k)
+        BOOST_CHECK_CLOSE(fix2[k], fix[k], 1E-12);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
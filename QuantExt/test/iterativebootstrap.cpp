@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/termstructures/iterativebootstrap.hpp>
+
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/math/interpolations/cubicinterpolation.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/piecewiseyieldcurve.hpp>
+#include <ql/termstructures/yield/ratehelpers.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+#include <ql/time/daycounters/thirty360.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+
+namespace {
+
+std::vector<boost::shared_ptr<RateHelper>> buildHelpers() {
+    std::vector<boost::shared_ptr<RateHelper>> helpers;
+    std::vector<std::pair<Period, Real>> deposits = {{3 * Months, 0.0310}, {6 * Months, 0.0325}};
+    std::vector<std::pair<Period, Real>> swaps = {{1 * Years, 0.0340},  {2 * Years, 0.0362},  {3 * Years, 0.0371},
+                                                  {5 * Years, 0.0388},  {7 * Years, 0.0395},  {10 * Years, 0.0410},
+                                                  {15 * Years, 0.0418}, {20 * Years, 0.0415}, {30 * Years, 0.0402}};
+    for (auto const& d : deposits)
+        helpers.push_back(boost::make_shared<DepositRateHelper>(
+            Handle<Quote>(boost::make_shared<SimpleQuote>(d.second)), d.first, 2, TARGET(), ModifiedFollowing, false,
+            Actual360()));
+    auto index = boost::make_shared<Euribor6M>();
+    for (auto const& s : swaps)
+        helpers.push_back(boost::make_shared<SwapRateHelper>(Handle<Quote>(boost::make_shared<SimpleQuote>(s.second)),
+                                                             s.first, TARGET(), Annual, Unadjusted,
+                                                             Thirty360(Thirty360::BondBasis), index));
+    return helpers;
+}
+
+template <class Traits> void checkGlobalNewton(const std::string& label) {
+
+    BOOST_TEST_MESSAGE("Testing global newton vs iterative bootstrap for " << label << " traits...");
+
+    SavedSettings backup;
+    Date refDate(15, March, 2023);
+    Settings::instance().evaluationDate() = refDate;
+
+    typedef PiecewiseYieldCurve<Traits, Cubic, QuantExt::IterativeBootstrap> Curve;
+
+    auto curveIterative = boost::make_shared<Curve>(
+        refDate, buildHelpers(), Actual365Fixed(), Cubic(),
+        QuantExt::IterativeBootstrap<Curve>(1.0E-12, Null<Real>(), false, 5, 2.0, 2.0, 10, false));
+
+    std::vector<boost::shared_ptr<RateHelper>> helpersNewton = buildHelpers();
+    auto curveNewton = boost::make_shared<Curve>(
+        refDate, helpersNewton, Actual365Fixed(), Cubic(),
+        QuantExt::IterativeBootstrap<Curve>(1.0E-12, Null<Real>(), false, 5, 2.0, 2.0, 10, true));
+
+    // the front end checks that data[0] is kept in sync with data[1] for zero yield and forward rate traits
+    for (Real t : {0.0, 0.001, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0, 20.0, 30.0}) {
+        BOOST_CHECK_SMALL(curveIterative->discount(t) - curveNewton->discount(t), 1.0E-10);
+        BOOST_CHECK_SMALL(curveIterative->zeroRate(t, Continuous).rate() -
+                              curveNewton->zeroRate(t, Continuous).rate(),
+                          1.0E-9);
+    }
+
+    for (auto const& h : helpersNewton)
+        BOOST_CHECK_SMALL(h->quoteError(), 1.0E-10);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(IterativeBootstrapTest)
+
+BOOST_AUTO_TEST_CASE(testGlobalNewtonZeroYield) { checkGlobalNewton<ZeroYield>("ZeroYield"); }
+
+BOOST_AUTO_TEST_CASE(testGlobalNewtonDiscount) { checkGlobalNewton<Discount>("Discount"); }
+
+BOOST_AUTO_TEST_CASE(testGlobalNewtonForwardRate) { checkGlobalNewton<ForwardRate>("ForwardRate"); }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
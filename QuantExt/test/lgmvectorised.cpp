@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/models/irlgm1fconstantparametrization.hpp>
+#include <qle/models/lgmvectorised.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/indexes/ibor/euribor.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LgmVectorisedTest)
+
+BOOST_AUTO_TEST_CASE(testIborFixingTermsVsReducedDiscountBonds) {
+
+    BOOST_TEST_MESSAGE("Testing LgmVectorised ibor fixing from precomputed terms against reduced discount bonds...");
+
+    Date refDate(15, March, 2023);
+    Settings::instance().evaluationDate() = refDate;
+
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(refDate, 0.02, Actual365Fixed()));
+    Handle<YieldTermStructure> fwdCurve(boost::make_shared<FlatForward>(refDate, 0.03, Actual365Fixed()));
+
+    auto p = boost::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts, 0.01, 0.02);
+    LgmVectorised lgm(p);
+
+    RandomVariable x(5);
+    for (Size k = 0; k < 5; ++k)
+        x.set(k, 0.02 * (static_cast<Real>(k) - 2.0));
+
+    // index with its own forwarding curve and index without, the latter is projected on the model curve
+    for (auto const& index : {boost::make_shared<Euribor6M>(fwdCurve), boost::make_shared<Euribor6M>()}) {
+        Handle<YieldTermStructure> curve = index->forwardingTermStructure().empty() ? yts
+                                                                                    : index->forwardingTermStructure();
+        for (Time t : {0.0, 0.5, 2.0, 7.5}) {
+            Date obsDate = refDate + static_cast<Integer>(t * 365.0 + 0.5);
+            for (Date fixingDate : {obsDate + 1, obsDate + 100, obsDate + 1000}) {
+                fixingDate = index->fixingCalendar().adjust(fixingDate);
+                RandomVariable fixTerms = lgm.fixing(lgm.iborFixingTerms(index, fixingDate, t), x);
+                RandomVariable fix = lgm.fixing(index, fixingDate, t, x);
+                // uncached reference: ratio of reduced discount bonds on the forwarding curve
+                Date d1 = index->valueDate(fixingDate), d2 = index->maturityDate(d1);
+                Time T1 = std::max(t, yts->timeFromReference(d1)), T2 = std::max(T1, yts->timeFromReference(d2));
+                RandomVariable expected =
+                    (lgm.reducedDiscountBond(t, T1, x, curve) / lgm.reducedDiscountBond(t, T2, x, curve) -
+                     RandomVariable(5, 1.0)) /
+                    RandomVariable(5, index->dayCounter().yearFraction(d1, d2));
+                for (Size k = 0; k < 5; ++k) {
+                    BOOST_CHECK_CLOSE(fixTerms[k], expected[k], 1E-10);
+                    BOOST_CHECK_CLOSE(fix[k], expected[k], 1E-10);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -24,14 +24,20 @@
 
 #include <qle/models/crossassetmodel.hpp>
 #include <qle/models/fxbsconstantparametrization.hpp>
+#include <qle/models/hwconstantparametrization.hpp>
 #include <qle/pricingengines/analyticcclgmfxoptionengine.hpp>
 #include <qle/pricingengines/numericlgmmultilegoptionengine.hpp>
 
+#include <ql/cashflows/capflooredcoupon.hpp>
+#include <ql/cashflows/cashflows.hpp>
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
 #include <ql/cashflows/simplecashflow.hpp>
 #include <ql/currencies/america.hpp>
 #include <ql/currencies/europe.hpp>
 #include <ql/indexes/ibor/euribor.hpp>
 #include <ql/instruments/swaption.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/quotes/simplequote.hpp>
 #include <ql/termstructures/yield/flatforward.hpp>
@@ -91,6 +97,161 @@ struct BermudanTestData : public qle::test::TopLevelFixture {
     Array stepTimes_a, sigmas_a, kappas_a;
     Real reversion;
 }; // BermudanTestData
+
+/* Reference implementation of the convolution rollback of a single array, this is the kernel of LgmConvolutionSolver2
+   from before several arrays were rolled back in one pass, the weights are set up in the same way */
+class ReferenceConvolution {
+public:
+    ReferenceConvolution(const boost::shared_ptr<LinearGaussMarkovModel>& model, const Real sy, const Size ny,
+                         const Real sx, const Size nx)
+        : model_(model), nx_(static_cast<int>(nx)) {
+        mx_ = static_cast<int>(floor(sx * static_cast<Real>(nx)) + 0.5);
+        my_ = static_cast<int>(floor(sy * static_cast<Real>(ny)) + 0.5);
+        Real h = 1.0 / static_cast<Real>(ny);
+        CumulativeNormalDistribution N;
+        NormalDistribution G;
+        y_.resize(2 * my_ + 1);
+        w_.resize(2 * my_ + 1);
+        for (int i = 0; i <= 2 * my_; i++) {
+            y_[i] = h * (i - my_);
+            if (i == 0 || i == 2 * my_)
+                w_[i] = (1. + y_[0] / h) * N(y_[0] + h) - y_[0] / h * N(y_[0]) + (G(y_[0] + h) - G(y_[0])) / h;
+            else
+                w_[i] = (1. + y_[i] / h) * N(y_[i] + h) - 2. * y_[i] / h * N(y_[i]) -
+                        (1. - y_[i] / h) * N(y_[i] - h) + (G(y_[i] + h) - 2. * G(y_[i]) + G(y_[i] - h)) / h;
+            w_[i] = std::max(w_[i], 0.0);
+        }
+    }
+
+    RandomVariable rollback(const RandomVariable& v, const Real t1, const Real t0) const {
+        if (QuantLib::close_enough(t0, t1) || v.deterministic())
+            return v;
+        Real sigma = std::sqrt(model_->parametrization()->zeta(t1));
+        Real dx = sigma / static_cast<Real>(nx_);
+        if (QuantLib::close_enough(t0, 0.0)) {
+            Real value = 0.0;
+            for (int i = 0; i <= 2 * my_; i++) {
+                Real kp = y_[i] * sigma / dx + mx_;
+                int kk = int(floor(kp));
+                value += w_[i] * (kk < 0 ? v[0]
+                                         : (kk + 1 > 2 * mx_ ? v[2 * mx_]
+                                                             : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk]));
+            }
+            return RandomVariable(2 * mx_ + 1, value);
+        }
+        RandomVariable value(2 * mx_ + 1, 0.0);
+        value.expand();
+        Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
+        Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
+        for (int k = 0; k <= 2 * mx_; k++) {
+            for (int i = 0; i <= 2 * my_; i++) {
+                Real kp = (dx2 * (k - mx_) + y_[i] * std) / dx + mx_;
+                int kk = int(floor(kp));
+                value.set(k, value[k] + w_[i] * (kk < 0 ? v[0]
+                                                        : (kk + 1 > 2 * mx_
+                                                               ? v[2 * mx_]
+                                                               : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk])));
+            }
+        }
+        return value;
+    }
+
+private:
+    boost::shared_ptr<LinearGaussMarkovModel> model_;
+    int mx_, my_, nx_;
+    std::vector<Real> y_, w_;
+};
+
+Real maxAbsDiff(const RandomVariable& x, const RandomVariable& y) {
+    BOOST_REQUIRE_EQUAL(x.size(), y.size());
+    Real result = 0.0;
+    for (Size i = 0; i < x.size(); ++i)
+        result = std::max(result, std::abs(x[i] - y[i]));
+    return result;
+}
+
+/* Value a multi leg option with fixed and capped / floored ibor coupons by backward induction on the convolution grid.
+   Each estimated cashflow is rolled back as a separate array until it enters the exercise into npv on its option date,
+   this is the scheme of the numeric lgm engine before cashflows were aggregated per exercise bucket. Returns the option
+   and the underlying npv. */
+std::pair<Real, Real> perCashflowRollbackNpv(const boost::shared_ptr<LinearGaussMarkovModel>& model,
+                                             const LgmConvolutionSolver2& solver, const ReferenceConvolution& conv,
+                                             const std::vector<Leg>& legs, const std::vector<Real>& payer,
+                                             const std::vector<Date>& exerciseDates) {
+    auto ts = model->parametrization()->termStructure();
+    LgmVectorised lgm(model->parametrization());
+    Size n = solver.gridSize();
+
+    // option date on which a cashflow enters the exercise into npv and the date on which we estimate its amount
+    std::map<std::pair<Size, Size>, Date> bucket, estimation;
+    std::set<Date> dates(exerciseDates.begin(), exerciseDates.end());
+    dates.insert(ts->referenceDate());
+    for (Size i = 0; i < legs.size(); ++i) {
+        for (Size j = 0; j < legs[i].size(); ++j) {
+            auto cpn = boost::dynamic_pointer_cast<Coupon>(legs[i][j]);
+            BOOST_REQUIRE(cpn);
+            Date b;
+            for (auto const& e : exerciseDates) {
+                if (e <= cpn->accrualStartDate())
+                    b = e;
+            }
+            BOOST_REQUIRE(b != Date());
+            Date e = b;
+            if (auto cf = boost::dynamic_pointer_cast<CappedFlooredCoupon>(cpn))
+                e = std::max(b, cf->underlying()->fixingDate());
+            bucket[std::make_pair(i, j)] = b;
+            estimation[std::make_pair(i, j)] = e;
+            dates.insert(e);
+        }
+    }
+
+    RandomVariable optionNpv(n, 0.0), underlyingNpv1(n, 0.0);
+    std::map<std::pair<Size, Size>, RandomVariable> underlyingNpv2;
+    for (auto d = dates.rbegin(); d != dates.rend(); ++d) {
+        Real t = ts->timeFromReference(*d);
+        RandomVariable x = solver.stateGrid(t);
+        for (auto const& e : estimation) {
+            if (e.second != *d)
+                continue;
+            auto c = legs[e.first.first][e.first.second];
+            RandomVariable amount;
+            if (auto cf = boost::dynamic_pointer_cast<CappedFlooredCoupon>(c)) {
+                auto ibor = boost::dynamic_pointer_cast<IborCoupon>(cf->underlying());
+                BOOST_REQUIRE(ibor);
+                RandomVariable rate = RandomVariable(n, ibor->gearing()) *
+                                          lgm.fixing(ibor->index(), ibor->fixingDate(), t, x) +
+                                      RandomVariable(n, ibor->spread());
+                if (cf->cap() != Null<Real>())
+                    rate = min(RandomVariable(n, cf->cap()), rate);
+                if (cf->floor() != Null<Real>())
+                    rate = max(RandomVariable(n, cf->floor()), rate);
+                amount = rate * RandomVariable(n, ibor->accrualPeriod() * ibor->nominal());
+            } else {
+                amount = RandomVariable(n, c->amount());
+            }
+            underlyingNpv2[e.first] = amount * lgm.reducedDiscountBond(t, ts->timeFromReference(c->date()), x) *
+                                      RandomVariable(n, payer[e.first.first]);
+        }
+        if (std::find(exerciseDates.begin(), exerciseDates.end(), *d) != exerciseDates.end()) {
+            for (auto const& b : bucket) {
+                if (b.second == *d) {
+                    underlyingNpv1 += underlyingNpv2.at(b.first);
+                    underlyingNpv2.erase(b.first);
+                }
+            }
+            optionNpv = max(optionNpv, underlyingNpv1);
+        }
+        if (std::next(d) != dates.rend()) {
+            Real t0 = ts->timeFromReference(*std::next(d));
+            underlyingNpv1 = conv.rollback(underlyingNpv1, t, t0);
+            optionNpv = conv.rollback(optionNpv, t, t0);
+            for (auto& c : underlyingNpv2)
+                c.second = conv.rollback(c.second, t, t0);
+        }
+    }
+    BOOST_REQUIRE(underlyingNpv2.empty());
+    return std::make_pair(optionNpv.at(0), underlyingNpv1.at(0));
+}
 } // namespace
 
 BOOST_FIXTURE_TEST_SUITE(OreAmcTestSuite, qle::test::TopLevelFixture)
@@ -137,6 +298,145 @@ BOOST_FIXTURE_TEST_CASE(testBermudanSwaption, BermudanTestData) {
 
 } // testBermudanSwaption
 
+BOOST_FIXTURE_TEST_CASE(testBermudanSwaptionHw, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of bermudan swaption as multi leg option in a HW model vs numeric swaption "
+                       "engine in the equivalent LGM model");
+
+    auto multiLegOption = boost::make_shared<MultiLegOption>(
+        std::vector<Leg>{underlying->leg(0), underlying->leg(1)}, std::vector<bool>{true, false},
+        std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise);
+
+    // a one factor hw model with constant parameters coincides with the lgm model with the hull white adaptor
+
+    Real sigma = 0.0065;
+    auto hw_p = boost::make_shared<IrHwConstantParametrization>(EURCurrency(), yts, Matrix(1, 1, sigma),
+                                                                Array(1, reversion));
+    auto lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, Array(),
+                                                                              Array(1, sigma), Array(),
+                                                                              Array(1, reversion));
+
+    auto xasset = Handle<CrossAssetModel>(boost::make_shared<CrossAssetModel>(
+        std::vector<boost::shared_ptr<Parametrization>>{hw_p}, Matrix(), SalvagingAlgorithm::None,
+        IrModel::Measure::BA, CrossAssetModel::Discretization::Euler));
+    auto lgm = boost::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    auto swaptionEngineLgm = boost::make_shared<NumericLgmSwaptionEngine>(lgm, 7.0, 16, 7.0, 32);
+    auto swapEngine = boost::make_shared<DiscountingSwapEngine>(yts);
+
+    auto mcMultiLegOptionEngine = boost::make_shared<McMultiLegOptionEngine>(
+        xasset, SobolBrownianBridge, SobolBrownianBridge, 25000, 0, 42, 42, 4, LsmBasisSystem::Monomial);
+
+    underlying->setPricingEngine(swapEngine);
+    swaption->setPricingEngine(swaptionEngineLgm);
+    Real npvUnd0 = underlying->NPV();
+    Real npv0 = swaption->NPV();
+    BOOST_TEST_MESSAGE("npv (numeric lgm swaption engine): underlying = " << npvUnd0 << ", option = " << npv0);
+
+    multiLegOption->setPricingEngine(mcMultiLegOptionEngine);
+    Real npvUnd1 = multiLegOption->result<Real>("underlyingNpv");
+    Real npv1 = multiLegOption->NPV();
+    BOOST_TEST_MESSAGE("npv (multi leg option engine, hw): underlying = " << npvUnd1 << ", option = " << npv1);
+
+    // the hw state is evolved with an euler scheme on the simulation grid, so we allow for a larger tolerance
+    BOOST_CHECK_SMALL(std::abs(npvUnd0 - npvUnd1), 1.0E-3);
+    BOOST_CHECK_SMALL(std::abs(npv0 - npv1), 1.0E-3);
+
+} // testBermudanSwaptionHw
+
+BOOST_FIXTURE_TEST_CASE(testLgmConvolutionSolverBatchedRollback, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing batched and single rollback in lgm convolution solver vs reference rollback");
+
+    auto lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto lgm = boost::make_shared<LinearGaussMarkovModel>(lgm_p);
+    LgmConvolutionSolver2 solver(lgm, 7.0, 16, 7.0, 32);
+    ReferenceConvolution reference(lgm, 7.0, 16, 7.0, 32);
+
+    Real t1 = 5.0;
+    RandomVariable x = solver.stateGrid(t1);
+    RandomVariable v1 = max(x, RandomVariable(solver.gridSize(), 0.0));
+    RandomVariable v2 = exp(RandomVariable(solver.gridSize(), -0.5) * x);
+    RandomVariable v3(solver.gridSize(), 1.5);
+
+    for (Real t0 : {0.0, 2.0, t1}) {
+        auto r = solver.rollback(std::vector<const RandomVariable*>{&v1, &v2, &v3}, t1, t0);
+        BOOST_REQUIRE_EQUAL(r.size(), 3);
+        BOOST_CHECK_SMALL(maxAbsDiff(r[0], reference.rollback(v1, t1, t0)), 1E-14);
+        BOOST_CHECK_SMALL(maxAbsDiff(r[1], reference.rollback(v2, t1, t0)), 1E-14);
+        BOOST_CHECK_SMALL(maxAbsDiff(solver.rollback(v1, t1, t0), reference.rollback(v1, t1, t0)), 1E-14);
+        BOOST_CHECK_SMALL(maxAbsDiff(solver.rollback(v2, t1, t0), reference.rollback(v2, t1, t0)), 1E-14);
+        BOOST_CHECK(r[2].deterministic());
+        BOOST_CHECK_EQUAL(r[2].at(0), 1.5);
+    }
+
+    // hard-coded rollback of max(x, 0) to t0 = 0, i.e. E(max(x(t1), 0)) = sqrt(zeta(t1) / (2 pi)) up to discretisation
+    Real expected = std::sqrt(lgm_p->zeta(t1) / (2.0 * M_PI));
+    BOOST_CHECK_CLOSE(solver.rollback(v1, t1, 0.0).at(0), expected, 0.1);
+
+} // testLgmConvolutionSolverBatchedRollback
+
+BOOST_FIXTURE_TEST_CASE(testNumericLgmBermudanBucketedRollback, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing numeric lgm multi leg option engine vs per cashflow rollback on a bermudan");
+
+    /* The float leg pays capped and floored 3M Euribor coupons. Their amounts are estimated on their fixing dates,
+       i.e. up to three of them per exercise period are rolled back before they enter the exercise into npv, the
+       engine aggregates them per exercise bucket, the reference rolls them back one by one. */
+    auto euribor3m = boost::make_shared<Euribor>(3 * Months, yts);
+    Schedule floatingSchedule3m(startDate, maturityDate, 3 * Months, TARGET(), ModifiedFollowing, ModifiedFollowing,
+                                DateGeneration::Forward, false);
+    Leg floatLeg = IborLeg(floatingSchedule3m, euribor3m)
+                       .withNotionals(1.0)
+                       .withPaymentDayCounter(Actual360())
+                       .withCaps(0.03)
+                       .withFloors(0.0);
+    std::vector<Leg> legs{underlying->leg(0), floatLeg};
+
+    auto multiLegOption = boost::make_shared<MultiLegOption>(
+        legs, std::vector<bool>{true, false}, std::vector<Currency>{EURCurrency(), EURCurrency()}, exercise);
+
+    auto lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto lgm = boost::make_shared<LinearGaussMarkovModel>(lgm_p);
+
+    multiLegOption->setPricingEngine(boost::make_shared<NumericLgmMultiLegOptionEngine>(lgm, 7.0, 16, 7.0, 32));
+    Real npv = multiLegOption->NPV();
+    Real npvUnd = multiLegOption->result<Real>("underlyingNpv");
+
+    LgmConvolutionSolver2 solver(lgm, 7.0, 16, 7.0, 32);
+    ReferenceConvolution reference(lgm, 7.0, 16, 7.0, 32);
+    auto ref = perCashflowRollbackNpv(lgm, solver, reference, legs, std::vector<Real>{-1.0, 1.0}, exerciseDates);
+
+    BOOST_TEST_MESSAGE("npv (numeric lgm engine)  : underlying = " << npvUnd << ", option = " << npv);
+    BOOST_TEST_MESSAGE("npv (per cashflow rollback): underlying = " << ref.second << ", option = " << ref.first);
+
+    BOOST_CHECK(npv > 0.0);
+    BOOST_CHECK_SMALL(npv - ref.first, 1.0E-12);
+    BOOST_CHECK_SMALL(npvUnd - ref.second, 1.0E-12);
+
+} // testNumericLgmBermudanBucketedRollback
+
+BOOST_FIXTURE_TEST_CASE(testLgmConvolutionSolverStateDensity, BermudanTestData) {
+
+    BOOST_TEST_MESSAGE("Testing rollback to zero via state density in lgm convolution solver vs rollback");
+
+    auto lgm_p = boost::make_shared<IrLgm1fPiecewiseConstantHullWhiteAdaptor>(EURCurrency(), yts, stepTimes_a, sigmas_a,
+                                                                              stepTimes_a, kappas_a);
+    auto lgm = boost::make_shared<LinearGaussMarkovModel>(lgm_p);
+    LgmConvolutionSolver2 solver(lgm, 7.0, 16, 7.0, 32);
+
+    for (Real t : {0.0, 0.5, 3.0, 9.0}) {
+        RandomVariable x = solver.stateGrid(t);
+        RandomVariable v = max(x + RandomVariable(solver.gridSize(), 0.001), RandomVariable(solver.gridSize(), 0.0));
+        Real expected = solver.rollback(v, t, 0.0).at(0);
+        BOOST_CHECK_CLOSE(solver.rollbackToZero(v, t), expected, 1E-10);
+        BOOST_CHECK_EQUAL(solver.rollbackToZero(RandomVariable(solver.gridSize(), 1.5), t), 1.5);
+    }
+
+} // testLgmConvolutionSolverStateDensity
+
 BOOST_AUTO_TEST_CASE(testFxOption) {
 
     BOOST_TEST_MESSAGE("Testing pricing of fx option as multi leg option vs analytic engine");
@@ -198,6 +498,73 @@ BOOST_AUTO_TEST_CASE(testFxOption) {
 
 } // testFxOption
 
+BOOST_AUTO_TEST_CASE(testCrossCurrencySwapSharedDeflators) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of cross currency swap as multi leg option vs discounting");
+
+    SavedSettings backup;
+    Date refDate(12, January, 2015);
+    Settings::instance().evaluationDate() = refDate;
+
+    auto yts_eur = Handle<YieldTermStructure>(boost::make_shared<FlatForward>(refDate, 0.02, Actual365Fixed()));
+    auto yts_usd = Handle<YieldTermStructure>(boost::make_shared<FlatForward>(refDate, 0.03, Actual365Fixed()));
+    auto fwd_eur = Handle<YieldTermStructure>(boost::make_shared<FlatForward>(refDate, 0.025, Actual365Fixed()));
+
+    auto lgm_eur_p = boost::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts_eur, 0.01, 0.01);
+    auto lgm_usd_p = boost::make_shared<IrLgm1fConstantParametrization>(USDCurrency(), yts_usd, 0.01, 0.01);
+
+    Real spot = 0.9;
+    Handle<Quote> fxspot(boost::make_shared<SimpleQuote>(spot));
+
+    auto fx_p = boost::make_shared<FxBsConstantParametrization>(USDCurrency(), fxspot, 0.10);
+
+    Matrix corr(3, 3);
+    // clang-format off
+    corr[0][0] = 1.0; corr[0][1] = 0.2; corr[0][2] = 0.5;
+    corr[1][0] = 0.2; corr[1][1] = 1.0; corr[1][2] = 0.4;
+    corr[2][0] = 0.5; corr[2][1] = 0.4; corr[2][2] = 1.0;
+    // clang-format on
+
+    auto xasset = Handle<CrossAssetModel>(boost::make_shared<CrossAssetModel>(
+        std::vector<boost::shared_ptr<Parametrization>>{lgm_eur_p, lgm_usd_p, fx_p}, corr));
+
+    /* the eur fixed, eur float and usd fixed legs share their annual pay dates, so that the engine evaluates the
+       deflators once per pay date and ccy and reuses them for several cashflows, the euribor index projects on its
+       own forwarding curve */
+    Date startDate = TARGET().advance(refDate, 1 * Years), maturityDate = TARGET().advance(startDate, 5 * Years);
+    Schedule fixedSchedule(startDate, maturityDate, 1 * Years, TARGET(), ModifiedFollowing, ModifiedFollowing,
+                           DateGeneration::Forward, false);
+    Schedule floatingSchedule(startDate, maturityDate, 6 * Months, TARGET(), ModifiedFollowing, ModifiedFollowing,
+                              DateGeneration::Forward, false);
+    auto euribor6m = boost::make_shared<Euribor>(6 * Months, fwd_eur);
+
+    Leg eurFixed =
+        FixedRateLeg(fixedSchedule).withNotionals(1.0).withCouponRates(0.02, Thirty360(Thirty360::BondBasis));
+    Leg eurFloat = IborLeg(floatingSchedule, euribor6m).withNotionals(1.0).withPaymentDayCounter(Actual360());
+    Leg usdFixed =
+        FixedRateLeg(fixedSchedule).withNotionals(1.0).withCouponRates(0.03, Thirty360(Thirty360::BondBasis));
+
+    auto multiLegOption = boost::make_shared<MultiLegOption>(
+        std::vector<Leg>{eurFixed, eurFloat, usdFixed}, std::vector<bool>{true, false, false},
+        std::vector<Currency>{EURCurrency(), EURCurrency(), USDCurrency()});
+
+    // reference: each cashflow discounted separately on its own ccy curve
+    Real npv0 = -CashFlows::npv(eurFixed, **yts_eur, false, refDate, refDate) +
+                CashFlows::npv(eurFloat, **yts_eur, false, refDate, refDate) +
+                spot * CashFlows::npv(usdFixed, **yts_usd, false, refDate, refDate);
+    BOOST_TEST_MESSAGE("npv (discounting)             : " << npv0);
+
+    auto mcMultiLegOptionEngine = boost::make_shared<McMultiLegOptionEngine>(
+        xasset, SobolBrownianBridge, SobolBrownianBridge, 25000, 0, 42, 42, 4, LsmBasisSystem::Monomial);
+
+    multiLegOption->setPricingEngine(mcMultiLegOptionEngine);
+    Real npv1 = multiLegOption->NPV();
+    BOOST_TEST_MESSAGE("npv (multi leg option engine) : " << npv1);
+
+    BOOST_CHECK_SMALL(std::abs(npv1 - npv0), 1.0E-3);
+
+} // testCrossCurrencySwapSharedDeflators
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/kernelfunctions.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <qle/math/nadarayawatson.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(NadarayaWatsonTest)
+
+BOOST_AUTO_TEST_CASE(testBinnedNadarayaWatson) {
+
+    BOOST_TEST_MESSAGE("Testing QuantExt::BinnedNadarayaWatson against QuantExt::NadarayaWatson");
+
+    Size n = 5000;
+    MersenneTwisterUniformRng mt(42);
+    InverseCumulativeNormal icn;
+    std::vector<Real> x(n), y(n);
+    for (Size i = 0; i < n; ++i) {
+        x[i] = icn(mt.nextReal());
+        y[i] = x[i] + x[i] * x[i] * icn(mt.nextReal());
+    }
+
+    Real bandWidth = 0.2;
+    GaussianKernel kernel(0.0, bandWidth);
+
+    NadarayaWatson lr(x.begin(), x.end(), y.begin(), kernel);
+    BinnedNadarayaWatson blr(x.begin(), x.end(), y.begin(), kernel, 8.0 * bandWidth);
+
+    for (Real p = -2.0; p <= 2.0; p += 0.1) {
+        BOOST_TEST_MESSAGE("x = " << p << " mean " << lr(p) << " " << blr(p) << " stddev " << lr.standardDeviation(p)
+                                  << " " << blr.standardDeviation(p));
+        BOOST_CHECK_SMALL(lr(p) - blr(p), 1.0E-3);
+        BOOST_CHECK_SMALL(lr.standardDeviation(p) - blr.standardDeviation(p), 1.0E-3);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
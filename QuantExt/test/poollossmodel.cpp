@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/models/basket.hpp>
+#include <qle/models/extendedconstantlosslatentmodel.hpp>
+#include <qle/models/poollossmodel.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/credit/flathazardrate.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using namespace QuantExt;
+
+namespace {
+
+struct PoolLossModelTestData : public qle::test::TopLevelFixture {
+    PoolLossModelTestData() : refDate(15, March, 2023) {
+        Settings::instance().evaluationDate() = refDate;
+        for (Size i = 0; i < 10; ++i) {
+            names.push_back("NAME_" + std::to_string(i));
+            notionals.push_back(1.0E6 * (1.0 + 0.1 * static_cast<Real>(i)));
+            recoveries.push_back(0.4);
+            hazardRates.push_back(boost::make_shared<SimpleQuote>(0.01 + 0.002 * static_cast<Real>(i)));
+        }
+        correlation = boost::make_shared<SimpleQuote>(0.3);
+        for (Size i = 1; i <= 5; ++i)
+            dates.push_back(refDate + i * Years);
+    }
+
+    // basket for the tranche [0.03, 0.07] with a gauss pool loss model
+    boost::shared_ptr<Basket> basket(const Size nThreads) const {
+        auto pool = boost::make_shared<Pool>();
+        DefaultProbKey key = NorthAmericaCorpDefaultKey(EURCurrency(), SeniorSec, Period(), 1.0);
+        for (Size i = 0; i < names.size(); ++i) {
+            Handle<DefaultProbabilityTermStructure> curve(boost::make_shared<FlatHazardRate>(
+                refDate, Handle<Quote>(hazardRates[i]), Actual365Fixed()));
+            Issuer issuer(std::vector<std::pair<DefaultProbKey, Handle<DefaultProbabilityTermStructure>>>(
+                              1, std::make_pair(key, curve)),
+                          DefaultEventSet());
+            pool->add(names[i], issuer, key);
+        }
+        auto b = boost::make_shared<Basket>(refDate, names, notionals, pool, 0.03, 0.07);
+        auto copula = boost::make_shared<ExtendedGaussianConstantLossLM>(
+            Handle<Quote>(correlation), recoveries, std::vector<std::vector<Real>>(),
+            std::vector<std::vector<Real>>(), LatentModelIntegrationType::GaussianQuadrature, names.size(),
+            GaussianCopulaPolicy::initTraits());
+        b->setLossModel(
+            boost::make_shared<GaussPoolLossModel>(false, copula, 200, 5.0, -5.0, 50, false, false, nThreads));
+        return b;
+    }
+
+    Date refDate;
+    std::vector<std::string> names;
+    std::vector<Real> notionals, recoveries;
+    std::vector<boost::shared_ptr<SimpleQuote>> hazardRates;
+    boost::shared_ptr<SimpleQuote> correlation;
+    std::vector<Date> dates;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_FIXTURE_TEST_SUITE(PoolLossModelTest, PoolLossModelTestData)
+
+BOOST_AUTO_TEST_CASE(testExpectedTrancheLossesVsSingleDates) {
+
+    BOOST_TEST_MESSAGE("Testing pool loss model expected tranche losses for several dates and threads...");
+
+    auto basketSingle = basket(1);
+    auto basket1 = basket(1);
+    auto basket4 = basket(4);
+
+    std::vector<Real> etl1 = basket1->expectedTrancheLosses(dates);
+    std::vector<Real> etl4 = basket4->expectedTrancheLosses(dates);
+    BOOST_REQUIRE_EQUAL(etl1.size(), dates.size());
+    BOOST_REQUIRE_EQUAL(etl4.size(), dates.size());
+
+    for (Size i = 0; i < dates.size(); ++i) {
+        Real expected = basketSingle->expectedTrancheLoss(dates[i]);
+        BOOST_TEST_MESSAGE(dates[i] << ": " << expected << " " << etl1[i] << " " << etl4[i]);
+        BOOST_CHECK_EQUAL(etl1[i], expected);
+        BOOST_CHECK_EQUAL(etl4[i], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCacheInvalidation) {
+
+    BOOST_TEST_MESSAGE("Testing pool loss model cache invalidation on default curve and correlation changes...");
+
+    auto b = basket(2);
+    std::vector<Real> etl0 = b->expectedTrancheLosses(dates);
+
+    // the cached result is returned for unchanged inputs
+    std::vector<Real> etlCached = b->expectedTrancheLosses(dates);
+    for (Size i = 0; i < dates.size(); ++i)
+        BOOST_CHECK_EQUAL(etlCached[i], etl0[i]);
+
+    // changed default curve
+    hazardRates[3]->setValue(0.05);
+    std::vector<Real> etl1 = b->expectedTrancheLosses(dates);
+    std::vector<Real> expected1 = basket(1)->expectedTrancheLosses(dates);
+    for (Size i = 0; i < dates.size(); ++i) {
+        BOOST_CHECK(etl1[i] > etl0[i]);
+        BOOST_CHECK_EQUAL(etl1[i], expected1[i]);
+    }
+
+    // changed correlation
+    correlation->setValue(0.6);
+    std::vector<Real> etl2 = b->expectedTrancheLosses(dates);
+    std::vector<Real> expected2 = basket(1)->expectedTrancheLosses(dates);
+    for (Size i = 0; i < dates.size(); ++i) {
+        BOOST_CHECK(etl2[i] != etl1[i]);
+        BOOST_CHECK_EQUAL(etl2[i], expected2[i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
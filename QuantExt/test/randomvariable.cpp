@@ -24,9 +24,11 @@
 // clang-format on
 
 #include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariableregressioncache.hpp>
 
 #include <ql/time/date.hpp>
 #include <ql/pricingengines/blackformula.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 
 #include <boost/math/distributions/normal.hpp>
 
@@ -192,6 +194,54 @@ BOOST_AUTO_TEST_CASE(testBlack) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testRegressionCache) {
+    BOOST_TEST_MESSAGE("Testing regression cache...");
+
+    Size n = 1000, order = 3;
+    auto type = LsmBasisSystem::Monomial;
+
+    MersenneTwisterUniformRng rng(42);
+    RandomVariable x(n), y(n), z1(n), z2(n);
+    for (Size i = 0; i < n; ++i) {
+        x.set(i, rng.nextReal());
+        y.set(i, rng.nextReal());
+        z1.set(i, x.at(i) * x.at(i) - y.at(i) + 0.1 * rng.nextReal());
+        z2.set(i, std::exp(x.at(i) * y.at(i)));
+    }
+    std::vector<const RandomVariable*> regressor = {&x, &y};
+    auto basisFns = multiPathBasisSystem(regressor.size(), order, type, Null<Size>());
+    Filter filter = x > RandomVariable(n, 0.3);
+
+    auto& cache = RandomVariableRegressionCache::instance();
+    cache.enable(1);
+
+    for (auto const& z : {z1, z2}) {
+        for (auto const& f : {Filter(), filter}) {
+            Array ref = regressionCoefficients(z, regressor, basisFns, f, RandomVariableRegressionMethod::QR);
+            Array res = cache.regressionCoefficients(z, regressor, basisFns, order, type, f);
+            BOOST_REQUIRE_EQUAL(res.size(), ref.size());
+            for (Size i = 0; i < ref.size(); ++i)
+                BOOST_CHECK_CLOSE(res[i], ref[i], 1E-10);
+        }
+    }
+
+    // the design matrix is factorised once per filter, maxSize = 1 evicts the other one each time
+    BOOST_CHECK_EQUAL(cache.hits(), 0);
+    BOOST_CHECK_EQUAL(cache.misses(), 4);
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+
+    cache.enable(2);
+    for (auto const& z : {z1, z2}) {
+        for (auto const& f : {Filter(), filter})
+            cache.regressionCoefficients(z, regressor, basisFns, order, type, f);
+    }
+    BOOST_CHECK_EQUAL(cache.hits(), 3);
+    BOOST_CHECK_EQUAL(cache.misses(), 5);
+
+    cache.disable();
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,225 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "swaptionmarketdata.hpp"
+#include "toplevelfixture.hpp"
+#include "yieldcurvemarketdata.hpp"
+#include <boost/test/unit_test.hpp>
+#include <qle/termstructures/swaptionvolcube2.hpp>
+
+#include <ql/termstructures/volatility/swaption/swaptionvolmatrix.hpp>
+#include <ql/termstructures/yield/zerospreadedtermstructure.hpp>
+
+using namespace QuantExt;
+using namespace QuantLib;
+using namespace boost::unit_test_framework;
+
+namespace {
+// normal cube on atm vol quotes, spread quotes and a forward curve that can be bumped
+struct CommonVars {
+    CommonVars() : referenceDate(5, Feb, 2016), spread(boost::make_shared<SimpleQuote>(0.0)) {
+
+        Settings::instance().evaluationDate() = referenceDate;
+
+        forwardCurve =
+            Handle<YieldTermStructure>(boost::make_shared<ZeroSpreadedTermStructure>(yieldCurves.forward6M,
+                                                                                     Handle<Quote>(spread)));
+        swapIndex = conventions.swapIndex->clone(forwardCurve, forwardCurve);
+        shortSwapIndex = conventions.shortSwapIndex->clone(forwardCurve, forwardCurve);
+
+        std::vector<std::vector<Handle<Quote> > > atmVolHandles(atmVols.optionTenors.size());
+        atmVolQuotes.resize(atmVols.optionTenors.size());
+        for (Size i = 0; i < atmVols.optionTenors.size(); ++i) {
+            for (Size j = 0; j < atmVols.swapTenors.size(); ++j) {
+                atmVolQuotes[i].push_back(boost::make_shared<SimpleQuote>(atmVols.nVols[i][j]));
+                atmVolHandles[i].push_back(Handle<Quote>(atmVolQuotes[i].back()));
+            }
+        }
+        atmVolMatrix = Handle<SwaptionVolatilityStructure>(boost::shared_ptr<SwaptionVolatilityMatrix>(
+            new SwaptionVolatilityMatrix(referenceDate, conventions.fixedCalendar, conventions.fixedConvention,
+                                         atmVols.optionTenors, atmVols.swapTenors, atmVolHandles, Actual365Fixed(),
+                                         true, Normal)));
+
+        // option and swap tenors on and between the cube pillars, 1Y swaps use the short swap index
+        optionTenors = {1 * Years, 3 * Years, 5 * Years, 10 * Years};
+        swapTenors = {1 * Years, 3 * Years, 10 * Years, 15 * Years};
+    }
+
+    boost::shared_ptr<SwaptionVolCube2> makeCube(bool flatExtrapolation = true) const {
+        return boost::make_shared<SwaptionVolCube2>(atmVolMatrix, atmVols.optionTenors, atmVols.swapTenors,
+                                                    atmVols.strikeSpreads, atmVols.nVolSpreads, swapIndex,
+                                                    shortSwapIndex, false, flatExtrapolation);
+    }
+
+    std::vector<Real> strikes(Real atm) const {
+        std::vector<Real> result;
+        for (Real s = -0.03; s < 0.0301; s += 0.0025)
+            result.push_back(atm + s);
+        return result;
+    }
+
+    Date referenceDate;
+    SwaptionConventionsEUR conventions;
+    SwaptionVolatilityEUR atmVols;
+    YieldCurveEUR yieldCurves;
+    boost::shared_ptr<SimpleQuote> spread;
+    Handle<YieldTermStructure> forwardCurve;
+    boost::shared_ptr<SwapIndex> swapIndex, shortSwapIndex;
+    std::vector<std::vector<boost::shared_ptr<SimpleQuote> > > atmVolQuotes;
+    Handle<SwaptionVolatilityStructure> atmVolMatrix;
+    std::vector<Period> optionTenors, swapTenors;
+
+    SavedSettings backup;
+};
+
+// compare the (possibly cached) smile sections of cube against those of a cube that has not been queried yet
+void checkAgainstFreshCube(const CommonVars& vars, const boost::shared_ptr<SwaptionVolCube2>& cube,
+                           const boost::shared_ptr<SwaptionVolCube2>& fresh) {
+    for (auto const& o : vars.optionTenors) {
+        for (auto const& t : vars.swapTenors) {
+            Date optionDate = cube->optionDateFromTenor(o);
+            boost::shared_ptr<SmileSection> s = cube->smileSection(optionDate, t);
+            boost::shared_ptr<SmileSection> f = fresh->smileSection(optionDate, t);
+            BOOST_CHECK_CLOSE(s->exerciseTime(), f->exerciseTime(), 1E-10);
+            BOOST_CHECK_SMALL(s->atmLevel() - f->atmLevel(), 1E-12);
+            BOOST_CHECK_SMALL(s->shift() - f->shift(), 1E-12);
+            for (auto const k : vars.strikes(f->atmLevel())) {
+                BOOST_CHECK_MESSAGE(std::abs(s->volatility(k) - f->volatility(k)) < 1E-12,
+                                    "option " << o << " swap " << t << " strike " << k << ": cached vol "
+                                              << s->volatility(k) << " fresh vol " << f->volatility(k));
+            }
+        }
+    }
+}
+
+// atm levels and vols at a fixed set of strikes for all test option / swap tenors
+std::vector<Real> snapshot(const CommonVars& vars, const boost::shared_ptr<SwaptionVolCube2>& cube) {
+    std::vector<Real> result;
+    for (auto const& o : vars.optionTenors) {
+        for (auto const& t : vars.swapTenors) {
+            boost::shared_ptr<SmileSection> s = cube->smileSection(cube->optionDateFromTenor(o), t);
+            result.push_back(s->atmLevel());
+            for (auto const k : {-0.01, 0.0, 0.01, 0.03})
+                result.push_back(s->volatility(k));
+        }
+    }
+    return result;
+}
+
+Real maxDifference(const std::vector<Real>& x, const std::vector<Real>& y) {
+    Real result = 0.0;
+    for (Size i = 0; i < x.size(); ++i)
+        result = std::max(result, std::abs(x[i] - y[i]));
+    return result;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SwaptionVolCube2Test)
+
+BOOST_AUTO_TEST_CASE(testCachedSmileSectionMatchesFreshSmileSection) {
+    BOOST_TEST_MESSAGE("Testing that cached SwaptionVolCube2 smile sections match freshly built ones...");
+
+    CommonVars vars;
+    for (auto const flatExtrapolation : {true, false}) {
+        boost::shared_ptr<SwaptionVolCube2> cube = vars.makeCube(flatExtrapolation);
+        // populate the cache and check that a second request is served from it
+        for (auto const& o : vars.optionTenors) {
+            for (auto const& t : vars.swapTenors) {
+                Date optionDate = cube->optionDateFromTenor(o);
+                boost::shared_ptr<SmileSection> s1 = cube->smileSection(optionDate, t);
+                boost::shared_ptr<SmileSection> s2 = cube->smileSection(optionDate, t);
+                BOOST_CHECK(s1 == s2);
+            }
+        }
+        checkAgainstFreshCube(vars, cube, vars.makeCube(flatExtrapolation));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSmileSectionCacheInvalidation) {
+    BOOST_TEST_MESSAGE("Testing that the SwaptionVolCube2 smile section cache is invalidated by market changes...");
+
+    CommonVars vars;
+    boost::shared_ptr<SwaptionVolCube2> cube = vars.makeCube();
+    std::vector<Real> base = snapshot(vars, cube);
+    Date optionDate = cube->optionDateFromTenor(5 * Years);
+    boost::shared_ptr<SmileSection> cached = cube->smileSection(optionDate, 10 * Years);
+
+    // parallel bump of the atm vols
+    for (auto const& row : vars.atmVolQuotes)
+        for (auto const& q : row)
+            q->setValue(q->value() + 0.0010);
+    BOOST_CHECK(cube->smileSection(optionDate, 10 * Years) != cached);
+    std::vector<Real> atmVolBumped = snapshot(vars, cube);
+    BOOST_CHECK(maxDifference(base, atmVolBumped) > 0.0005);
+    checkAgainstFreshCube(vars, cube, vars.makeCube());
+
+    // bump of the forward curve, this moves the atm forwards
+    cached = cube->smileSection(optionDate, 10 * Years);
+    Real atm = cached->atmLevel();
+    vars.spread->setValue(0.0010);
+    BOOST_CHECK(cube->smileSection(optionDate, 10 * Years) != cached);
+    BOOST_CHECK(std::abs(cube->smileSection(optionDate, 10 * Years)->atmLevel() - atm) > 0.0005);
+    checkAgainstFreshCube(vars, cube, vars.makeCube());
+
+    // bump of the non-atm vol spread quotes
+    cached = cube->smileSection(optionDate, 10 * Years);
+    std::vector<Real> curveBumped = snapshot(vars, cube);
+    for (auto const& row : vars.atmVols.nVolSpreads) {
+        for (Size k = 0; k < row.size(); ++k) {
+            if (vars.atmVols.strikeSpreads[k] == 0.0)
+                continue;
+            auto q = boost::dynamic_pointer_cast<SimpleQuote>(*row[k]);
+            BOOST_REQUIRE(q);
+            q->setValue(q->value() + 0.0005);
+        }
+    }
+    BOOST_CHECK(cube->smileSection(optionDate, 10 * Years) != cached);
+    BOOST_CHECK(maxDifference(curveBumped, snapshot(vars, cube)) > 0.0002);
+    checkAgainstFreshCube(vars, cube, vars.makeCube());
+}
+
+BOOST_AUTO_TEST_CASE(testBatchedVolatilitiesMatchScalarVolatility) {
+    BOOST_TEST_MESSAGE("Testing SwaptionVolCube2 batched volatilities against scalar volatility...");
+
+    CommonVars vars;
+    for (auto const flatExtrapolation : {true, false}) {
+        boost::shared_ptr<SwaptionVolCube2> cube = vars.makeCube(flatExtrapolation);
+        for (auto const& o : vars.optionTenors) {
+            for (auto const& t : vars.swapTenors) {
+                Date optionDate = cube->optionDateFromTenor(o);
+                // scalar volatilities from a cube without cached smile sections
+                boost::shared_ptr<SwaptionVolCube2> fresh = vars.makeCube(flatExtrapolation);
+                std::vector<Real> strikes = vars.strikes(fresh->atmStrike(optionDate, t));
+                std::vector<Volatility> vols = cube->volatilities(optionDate, t, strikes);
+                BOOST_REQUIRE_EQUAL(vols.size(), strikes.size());
+                for (Size i = 0; i < strikes.size(); ++i) {
+                    Volatility scalar = fresh->volatility(optionDate, t, strikes[i], true);
+                    BOOST_CHECK_MESSAGE(std::abs(vols[i] - scalar) < 1E-12,
+                                        "option " << o << " swap " << t << " strike " << strikes[i]
+                                                  << ": batched vol " << vols[i] << " scalar vol " << scalar);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()